@@ -0,0 +1,250 @@
+/**
+ * binary_search.cpp
+ *
+ * Binary search, Eytzinger and static B-tree tests, and lower_bound
+ * benchmarks from L1-resident arrays to arrays far larger than the LLC.
+ */
+
+#include "binary_search.hpp"
+#include "eytzinger.hpp"
+#include "static_btree.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// sorted DArray holding keys
+template <typename T> DArray<T> sorted_darray(std::vector<T> keys) {
+  std::sort(keys.begin(), keys.end());
+  DArray<T> arr = darray_create<T>(keys.size());
+  darray_append(&arr, keys.begin(), keys.end());
+  return arr;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Binary Search Tests");
+
+  suite.add_test("Lower bound on small arrays", []() {
+    auto arr = sorted_darray<int>({1, 3, 3, 3, 7});
+    test::assert_equal(size_t(0), darray_lower_bound(&arr, 0));
+    test::assert_equal(size_t(0), darray_lower_bound(&arr, 1));
+    test::assert_equal(size_t(1), darray_lower_bound(&arr, 2));
+    test::assert_equal(size_t(1), darray_lower_bound(&arr, 3));
+    test::assert_equal(size_t(4), darray_lower_bound(&arr, 4));
+    test::assert_equal(size_t(5), darray_lower_bound(&arr, 8));
+    test::assert_true(darray_binary_search(&arr, 7));
+    test::assert_false(darray_binary_search(&arr, 5));
+
+    auto empty = darray_create<int>(0);
+    test::assert_equal(size_t(0), darray_lower_bound(&empty, 1));
+    test::assert_false(darray_binary_search(&empty, 1));
+
+    darray_destroy(&arr);
+    darray_destroy(&empty);
+  });
+
+  suite.add_test("Eytzinger ranks match sorted order", []() {
+    for (int n = 1; n <= 300; ++n) {
+      std::vector<int> keys(n);
+      for (int i = 0; i < n; ++i) {
+        keys[i] = i;
+      }
+      auto arr = sorted_darray(keys);
+      auto eyt = eyt_build(&arr);
+      for (size_t k = 1; k <= size_t(n); ++k) {
+        test::assert_equal(size_t(eyt.keys[k]), eyt_rank(&eyt, k));
+      }
+      eyt_destroy(&eyt);
+      darray_destroy(&arr);
+    }
+  });
+
+  suite.add_test("All layouts match std::lower_bound", []() {
+    test::RandomGenerator gen;
+    for (size_t n : {0, 1, 2, 15, 16, 17, 100, 272, 289, 1000, 5000}) {
+      // narrow key range, so there are runs of duplicates
+      auto arr = sorted_darray(gen.generate_ints(n, -500, 500));
+      auto eyt = eyt_build(&arr);
+      auto tree = btree_build(&arr);
+      int* end = arr.data + arr.sz;
+
+      for (int x = -502; x <= 502; ++x) {
+        size_t want = std::lower_bound(arr.data, end, x) - arr.data;
+        test::assert_equal(want, darray_lower_bound(&arr, x));
+        test::assert_equal(want, eyt_lower_bound(&eyt, x));
+        const int* found = btree_lower_bound(&tree, x);
+        if (want == n) {
+          test::assert_true(found == nullptr, "Found a key past the end");
+        } else {
+          test::assert_true(found && *found == arr.data[want]);
+        }
+        bool present = want < n && arr.data[want] == x;
+        test::assert_equal(present, eyt_contains(&eyt, x));
+        test::assert_equal(present, btree_contains(&tree, x));
+      }
+
+      btree_destroy(&tree);
+      eyt_destroy(&eyt);
+      darray_destroy(&arr);
+    }
+  });
+
+  suite.add_test("Static B-tree with the padding value as a key", []() {
+    auto arr = sorted_darray<int>({INT_MIN, 0, INT_MAX, INT_MAX});
+    auto tree = btree_build(&arr);
+    test::assert_equal(INT_MIN, *btree_lower_bound(&tree, INT_MIN));
+    test::assert_equal(INT_MAX, *btree_lower_bound(&tree, 1));
+    test::assert_true(btree_contains(&tree, INT_MAX));
+    test::assert_false(btree_contains(&tree, 1));
+
+    btree_destroy(&tree);
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Static B-tree with scalar node search", []() {
+    std::vector<double> keys;
+    for (int i = 0; i < 1000; ++i) {
+      keys.push_back(i * 0.5);
+    }
+    auto arr = sorted_darray(keys);
+    auto tree = btree_build(&arr);
+    test::assert_equal(size_t(8), btree_node_keys<double>);
+    test::assert_equal(0.0, *btree_lower_bound(&tree, -1.0));
+    test::assert_equal(250.5, *btree_lower_bound(&tree, 250.2));
+    test::assert_true(btree_lower_bound(&tree, 499.6) == nullptr);
+    test::assert_true(btree_contains(&tree, 123.5));
+
+    btree_destroy(&tree);
+    darray_destroy(&arr);
+  });
+
+  // error handling tests
+  suite.add_test("Layouts reject unsorted arrays", []() {
+    auto arr = darray_create<int>();
+    darray_push_back(&arr, 2);
+    darray_push_back(&arr, 1);
+    bool caught_eytzinger = false;
+    bool caught_btree = false;
+
+    try {
+      eyt_build(&arr);
+    } catch (const std::runtime_error& e) {
+      caught_eytzinger = true;
+    }
+    try {
+      btree_build(&arr);
+    } catch (const std::runtime_error& e) {
+      caught_btree = true;
+    }
+    test::assert_true(caught_eytzinger, "Expected exception not thrown");
+    test::assert_true(caught_btree, "Expected exception not thrown");
+
+    darray_destroy(&arr);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: random lower_bound queries on arrays of 4-byte keys from
+  // 4 KiB (L1) to 256 MiB (far beyond the LLC). Keys are multiples of 3 so
+  // queries mix hits and misses; each result's key is summed so every
+  // lookup finishes with the load a caller would do.
+  test::Benchmark bench("Binary Search Benchmarks");
+  const size_t queries = 100000;
+  test::RandomGenerator gen;
+
+  std::vector<DArray<int>> arrays;
+  std::vector<Eytzinger<int>> eyts;
+  std::vector<StaticBTree<int>> trees;
+  std::vector<size_t> sizes = {1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 26};
+  arrays.reserve(sizes.size());
+  eyts.reserve(sizes.size());
+  trees.reserve(sizes.size());
+
+  for (size_t n : sizes) {
+    auto& arr = arrays.emplace_back(darray_create<int>(n));
+    for (size_t i = 0; i < n; ++i) {
+      darray_push_back(&arr, int(3 * i));
+    }
+    auto& eyt = eyts.emplace_back(eyt_build(&arr));
+    auto& tree = trees.emplace_back(btree_build(&arr));
+    auto xs = gen.generate_ints(queries, 0, int(3 * (n - 1)));
+    std::string suffix = " (" + std::to_string(n * sizeof(int) / 1024) +
+                         " KiB)";
+
+    bench.add_test(
+        "std::lower_bound" + suffix,
+        [&arr, xs]() {
+          long sum = 0;
+          for (int x : xs) {
+            sum += *std::lower_bound(arr.data, arr.data + arr.sz, x);
+          }
+          test::do_not_optimize(sum);
+        },
+        queries);
+
+    bench.add_test(
+        "Branchless binary search" + suffix,
+        [&arr, xs]() {
+          long sum = 0;
+          for (int x : xs) {
+            sum += arr.data[darray_lower_bound(&arr, x)];
+          }
+          test::do_not_optimize(sum);
+        },
+        queries);
+
+    bench.add_test(
+        "Eytzinger" + suffix,
+        [&eyt, xs]() {
+          long sum = 0;
+          for (int x : xs) {
+            sum += eyt.keys[eyt_search(&eyt, x)];
+          }
+          test::do_not_optimize(sum);
+        },
+        queries);
+
+    bench.add_test(
+        "Eytzinger with rank" + suffix,
+        [&arr, &eyt, xs]() {
+          long sum = 0;
+          for (int x : xs) {
+            sum += arr.data[eyt_lower_bound(&eyt, x)];
+          }
+          test::do_not_optimize(sum);
+        },
+        queries);
+
+    bench.add_test(
+        "Static B-tree" + suffix,
+        [&tree, xs]() {
+          long sum = 0;
+          for (int x : xs) {
+            sum += *btree_lower_bound(&tree, x);
+          }
+          test::do_not_optimize(sum);
+        },
+        queries);
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    btree_destroy(&trees[i]);
+    eyt_destroy(&eyts[i]);
+    darray_destroy(&arrays[i]);
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Binary search program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,36 @@
+/**
+ * binary_search.hpp
+ *
+ * Binary search over a sorted DArray<T>. The search loop is branchless:
+ * each step picks the next half with a conditional move, so the only
+ * stalls left are the memory loads themselves.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include <cstddef>
+
+// index of the first element of sorted arr not less than x, or its size
+template <typename T>
+size_t darray_lower_bound(const DArray<T>* arr, const T& x) {
+  const T* base = arr->data;
+  size_t n = arr->sz;
+  if (n == 0) {
+    return 0;
+  }
+  // base[0..n) always holds the answer, or the answer is just past it
+  while (n > 1) {
+    size_t half = n / 2;
+    base = base[half] < x ? base + half : base;
+    n -= half;
+  }
+  return size_t(base - arr->data) + (*base < x);
+}
+
+// true if sorted arr contains x
+template <typename T>
+bool darray_binary_search(const DArray<T>* arr, const T& x) {
+  size_t i = darray_lower_bound(arr, x);
+  return i < arr->sz && !(x < arr->data[i]);
+}
@@ -0,0 +1,116 @@
+/**
+ * eytzinger.hpp
+ *
+ * A sorted array rearranged in Eytzinger (breadth-first) order: the root
+ * sits at index 1 and the children of node k at 2k and 2k + 1. The first
+ * levels of every search share the same few cache lines, and since the 16
+ * (for 4-byte keys) descendants four levels below a node are contiguous,
+ * the search prefetches them while it is still comparing.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#define CACHE_LINE 64 // bytes per cache line
+
+template <typename T> struct Eytzinger {
+  T* keys;         // keys[1..n] in breadth-first order, keys[0] unused
+  size_t n;        // number of keys
+  unsigned height; // levels in the tree, the last one possibly partial
+};
+
+// fill the subtree rooted at k with sorted[i..], in order; returns the
+// index of the first key not placed
+template <typename T>
+size_t eyt_fill(const T* sorted, T* keys, size_t n, size_t i, size_t k) {
+  if (k <= n) {
+    i = eyt_fill(sorted, keys, n, i, 2 * k);
+    keys[k] = sorted[i++];
+    i = eyt_fill(sorted, keys, n, i, 2 * k + 1);
+  }
+  return i;
+}
+
+// build the layout of a sorted array; arr itself is left untouched
+template <typename T> Eytzinger<T> eyt_build(const DArray<T>* arr) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "keys are copied into raw storage");
+  static_assert(CACHE_LINE % sizeof(T) == 0,
+                "keys must pack evenly into cache lines");
+  for (size_t i = 1; i < arr->sz; ++i) {
+    if (arr->data[i] < arr->data[i - 1]) {
+      throw std::runtime_error("Array is not sorted");
+    }
+  }
+
+  // keys[0] starts a line, so the descendants of k four levels down (for
+  // 4-byte keys) fill exactly the line at byte offset k * CACHE_LINE
+  size_t bytes = (arr->sz + 1) * sizeof(T);
+  bytes = (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+  Eytzinger<T> eyt{(T*)aligned_alloc(CACHE_LINE, bytes), arr->sz, 0};
+  if (!eyt.keys) {
+    throw std::bad_alloc();
+  }
+  while ((size_t(1) << eyt.height) <= eyt.n) {
+    eyt.height++;
+  }
+  eyt_fill(arr->data, eyt.keys, eyt.n, 0, 1);
+  return eyt;
+}
+
+// free memory
+template <typename T> void eyt_destroy(Eytzinger<T>* eyt) {
+  free(eyt->keys);
+  eyt->keys = nullptr;
+  eyt->n = 0;
+  eyt->height = 0;
+}
+
+// index in the sorted array of the key at node k (1 <= k <= n). With a
+// full last level the in-order position follows from depth and offset
+// alone; the missing last-level nodes are then the rightmost ones, so only
+// those before that position need subtracting.
+template <typename T> size_t eyt_rank(const Eytzinger<T>* eyt, size_t k) {
+  unsigned depth = 63 - __builtin_clzll(k);
+  unsigned below = eyt->height - 1 - depth;
+  size_t offset = k - (size_t(1) << depth);
+  size_t pos = ((2 * offset + 1) << below) - 1;
+  size_t leaves_before = (pos + 1) / 2;
+  size_t leaves = eyt->n - (size_t(1) << (eyt->height - 1)) + 1;
+  return pos - leaves_before + std::min(leaves_before, leaves);
+}
+
+// node holding the first key not less than x, or 0 if there is none
+template <typename T> size_t eyt_search(const Eytzinger<T>* eyt, const T& x) {
+  const T* keys = eyt->keys;
+  size_t k = 1;
+  while (k <= eyt->n) {
+    // prefetching past the end is harmless, so no bounds check
+    __builtin_prefetch((const char*)((uintptr_t)keys + k * CACHE_LINE));
+    k = 2 * k + (keys[k] < x);
+  }
+  // the answer is where the path last turned left: strip the right turns
+  // that follow it (trailing ones) and the left turn itself
+  return k >> __builtin_ffsll(~(long long)k);
+}
+
+// index in the sorted array of the first key not less than x, or n
+template <typename T>
+size_t eyt_lower_bound(const Eytzinger<T>* eyt, const T& x) {
+  size_t k = eyt_search(eyt, x);
+  return k ? eyt_rank(eyt, k) : eyt->n;
+}
+
+// true if the layout contains x
+template <typename T> bool eyt_contains(const Eytzinger<T>* eyt, const T& x) {
+  size_t k = eyt_search(eyt, x);
+  return k && !(x < eyt->keys[k]);
+}
@@ -0,0 +1,157 @@
+/**
+ * static_btree.hpp
+ *
+ * A read-only B-tree laid out implicitly in one array: every node is one
+ * cache line of sorted keys (16 for 4-byte keys) and the children of node
+ * k are nodes k * (B + 1) + 1 + i, so no pointers are stored. A lookup
+ * touches one line per level, log17(n) of them instead of log2(n), and
+ * ranks x within a node with a few vector compares (SSE2, or AVX2 where
+ * the build enables it) for int32_t keys.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define CACHE_LINE 64 // bytes per cache line
+
+// keys per node
+template <typename T>
+inline constexpr size_t btree_node_keys = CACHE_LINE / sizeof(T);
+
+template <typename T> struct StaticBTree {
+  T* keys;      // nodes of btree_node_keys<T> keys, padded with T's maximum
+  size_t nodes; // number of nodes
+  size_t n;     // number of real keys
+  T max_key;    // largest real key; padding compares equal to or above it
+};
+
+// child i of node k
+template <typename T> size_t btree_child(size_t k, size_t i) {
+  return k * (btree_node_keys<T> + 1) + 1 + i;
+}
+
+// fill the subtree rooted at k with sorted[t..n) in order, padding once
+// the keys run out; returns the index of the first key not placed
+template <typename T>
+size_t btree_fill(StaticBTree<T>* tree, const T* sorted, size_t t, size_t k) {
+  const size_t B = btree_node_keys<T>;
+  if (k < tree->nodes) {
+    for (size_t i = 0; i < B; ++i) {
+      t = btree_fill(tree, sorted, t, btree_child<T>(k, i));
+      tree->keys[k * B + i] =
+          t < tree->n ? sorted[t++] : std::numeric_limits<T>::max();
+    }
+    t = btree_fill(tree, sorted, t, btree_child<T>(k, B));
+  }
+  return t;
+}
+
+// build the tree from a sorted array; arr itself is left untouched
+template <typename T> StaticBTree<T> btree_build(const DArray<T>* arr) {
+  static_assert(std::is_arithmetic_v<T>, "keys are padded with T's maximum");
+  static_assert(CACHE_LINE % sizeof(T) == 0,
+                "keys must pack evenly into cache lines");
+  for (size_t i = 1; i < arr->sz; ++i) {
+    if (arr->data[i] < arr->data[i - 1]) {
+      throw std::runtime_error("Array is not sorted");
+    }
+  }
+
+  const size_t B = btree_node_keys<T>;
+  StaticBTree<T> tree;
+  tree.n = arr->sz;
+  tree.nodes = (arr->sz + B - 1) / B;
+  tree.max_key = arr->sz ? arr->data[arr->sz - 1] : T();
+  tree.keys = (T*)aligned_alloc(CACHE_LINE, (tree.nodes + 1) * CACHE_LINE);
+  if (!tree.keys) {
+    throw std::bad_alloc();
+  }
+  btree_fill(&tree, arr->data, 0, 0);
+  return tree;
+}
+
+// free memory
+template <typename T> void btree_destroy(StaticBTree<T>* tree) {
+  free(tree->keys);
+  tree->keys = nullptr;
+  tree->nodes = tree->n = 0;
+}
+
+// number of keys in a node less than x, which is also the child to follow
+template <typename T> unsigned btree_node_rank(const T* node, const T& x) {
+  unsigned rank = 0;
+  for (size_t i = 0; i < btree_node_keys<T>; ++i) {
+    rank += node[i] < x;
+  }
+  return rank;
+}
+
+// keys below x form a prefix of the node, so the rank is the number of
+// trailing ones in the compare mask (bsf, unlike popcnt, is baseline x86)
+#if defined(__AVX2__)
+inline unsigned btree_node_rank(const int32_t* node, int32_t x) {
+  __m256i key = _mm256_set1_epi32(x);
+  const __m256i* keys = (const __m256i*)node;
+  __m256i lt0 = _mm256_cmpgt_epi32(key, _mm256_load_si256(keys));
+  __m256i lt1 = _mm256_cmpgt_epi32(key, _mm256_load_si256(keys + 1));
+  // packing interleaves the 128-bit lanes, which the permute undoes
+  __m256i packed = _mm256_packs_epi32(lt0, lt1);
+  packed = _mm256_permute4x64_epi64(packed, 0xD8);
+  unsigned mask = _mm256_movemask_epi8(packed);
+  return __builtin_ctzll(~(uint64_t)mask) / 2; // 16 when every key is less
+}
+#elif defined(__SSE2__)
+inline unsigned btree_node_rank(const int32_t* node, int32_t x) {
+  __m128i key = _mm_set1_epi32(x);
+  const __m128i* keys = (const __m128i*)node;
+  __m128i lt0 = _mm_cmpgt_epi32(key, _mm_load_si128(keys));
+  __m128i lt1 = _mm_cmpgt_epi32(key, _mm_load_si128(keys + 1));
+  __m128i lt2 = _mm_cmpgt_epi32(key, _mm_load_si128(keys + 2));
+  __m128i lt3 = _mm_cmpgt_epi32(key, _mm_load_si128(keys + 3));
+  // narrow the sixteen all-ones/all-zeros lanes to bytes, in order
+  __m128i packed =
+      _mm_packs_epi16(_mm_packs_epi32(lt0, lt1), _mm_packs_epi32(lt2, lt3));
+  unsigned mask = _mm_movemask_epi8(packed);
+  return __builtin_ctz(~mask);
+}
+#endif
+
+// the first key not less than x, or nullptr if there is none. Keys above
+// max_key are rejected up front, so padding is never returned.
+template <typename T>
+const T* btree_lower_bound(const StaticBTree<T>* tree, const T& x) {
+  const size_t B = btree_node_keys<T>;
+  if (tree->n == 0 || tree->max_key < x) {
+    return nullptr;
+  }
+  const T* found = nullptr;
+  size_t k = 0;
+  while (k < tree->nodes) {
+    const T* node = tree->keys + k * B;
+    unsigned i = btree_node_rank(node, x);
+    found = i < B ? node + i : found;
+    k = btree_child<T>(k, i);
+  }
+  return found;
+}
+
+// true if the tree contains x
+template <typename T>
+bool btree_contains(const StaticBTree<T>* tree, const T& x) {
+  const T* found = btree_lower_bound(tree, x);
+  return found && !(x < *found);
+}
@@ -0,0 +1,194 @@
+/**
+ * merge_sort.hpp
+ *
+ * Stable merge sort over DArray<T>, optionally multithreaded. Halves are
+ * sorted into a single scratch buffer and merged back, alternating
+ * buffers level by level so nothing is copied twice. The parallel version
+ * sorts halves on separate threads, then splits each merge in two around
+ * the median of the longer run (found in the other run by binary search)
+ * so the merges are spread across threads as well.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include "sort.hpp"
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#define SORT_PARALLEL_CUTOFF (1 << 15) // smaller ranges stay on one thread
+
+// threads to use when the caller asks for 0
+inline size_t sort_default_threads() {
+  size_t n = std::thread::hardware_concurrency();
+  return n ? n : 1;
+}
+
+// run a() on a new thread and b() on this one, then wait for both
+template <typename A, typename B> void sort_fork(A a, B b) {
+  std::thread t(a);
+  b();
+  t.join();
+}
+
+// scratch array of n elements; trivially copyable types are left
+// uninitialized, anything else is copied from data so every slot is a
+// live object that merges can assign to
+template <typename T> DArray<T> merge_scratch(const T* data, size_t n) {
+  DArray<T> scratch = darray_create<T>(n ? n : 1);
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    scratch.sz = n;
+  } else {
+    darray_append(&scratch, data, data + n);
+  }
+  return scratch;
+}
+
+// index of the first element of sorted [data, data + n) that x is less
+// than (upper) or not less than (lower)
+template <typename T, typename Less>
+size_t merge_search(const T* data, size_t n, const T& x, bool upper,
+                    Less& less) {
+  size_t lo = 0;
+  size_t hi = n;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    bool left = upper ? !less(x, data[mid]) : less(data[mid], x);
+    if (left) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// merge sorted runs a and b into out; ties are taken from a first
+template <typename T, typename Less>
+void merge_runs(T* a, size_t na, T* b, size_t nb, T* out, Less& less) {
+  size_t i = 0;
+  size_t j = 0;
+  while (i < na && j < nb) {
+    *out++ = less(b[j], a[i]) ? std::move(b[j++]) : std::move(a[i++]);
+  }
+  while (i < na) {
+    *out++ = std::move(a[i++]);
+  }
+  while (j < nb) {
+    *out++ = std::move(b[j++]);
+  }
+}
+
+// merge_runs split across up to `threads` threads. Cutting the longer run
+// at its midpoint m and the other run where m's key would go (after equal
+// keys of a, before equal keys of b) keeps the merge stable.
+template <typename T, typename Less>
+void merge_runs_parallel(T* a, size_t na, T* b, size_t nb, T* out,
+                         Less& less, size_t threads) {
+  if (threads <= 1 || na + nb < SORT_PARALLEL_CUTOFF) {
+    merge_runs(a, na, b, nb, out, less);
+    return;
+  }
+  size_t ma, mb;
+  if (na >= nb) {
+    ma = na / 2;
+    mb = merge_search(b, nb, a[ma], false, less);
+  } else {
+    mb = nb / 2;
+    ma = merge_search(a, na, b[mb], true, less);
+  }
+  size_t half = threads / 2;
+  sort_fork(
+      [=, &less]() { merge_runs_parallel(a, ma, b, mb, out, less, half); },
+      [=, &less]() {
+        merge_runs_parallel(a + ma, na - ma, b + mb, nb - mb, out + ma + mb,
+                            less, threads - half);
+      });
+}
+
+// sort a[0..n), which holds the data; the result ends up in b when to_b,
+// otherwise back in a. Each level sorts its halves into the buffer it
+// will then merge out of.
+template <typename T, typename Less>
+void merge_sort_range(T* a, T* b, size_t n, bool to_b, Less& less,
+                      size_t threads) {
+  if (n <= SORT_INSERTION_CUTOFF) {
+    insertion_sort_range(a, n, less);
+    if (to_b) {
+      std::move(a, a + n, b);
+    }
+    return;
+  }
+  size_t mid = n / 2;
+  if (threads > 1 && n >= SORT_PARALLEL_CUTOFF) {
+    size_t half = threads / 2;
+    sort_fork(
+        [=, &less]() { merge_sort_range(a, b, mid, !to_b, less, half); },
+        [=, &less]() {
+          merge_sort_range(a + mid, b + mid, n - mid, !to_b, less,
+                           threads - half);
+        });
+  } else {
+    merge_sort_range(a, b, mid, !to_b, less, 1);
+    merge_sort_range(a + mid, b + mid, n - mid, !to_b, less, 1);
+  }
+  T* src = to_b ? a : b;
+  T* dst = to_b ? b : a;
+  merge_runs_parallel(src, mid, src + mid, n - mid, dst, less, threads);
+}
+
+// stable, O(n log n), n elements of scratch; threads = 0 uses every core
+template <typename T, typename Less = std::less<T>>
+void merge_sort(DArray<T>* arr, size_t threads = 1, Less less = Less()) {
+  if (arr->sz < 2) {
+    return;
+  }
+  if (threads == 0) {
+    threads = sort_default_threads();
+  }
+  DArray<T> scratch = merge_scratch(arr->data, arr->sz);
+  merge_sort_range(arr->data, scratch.data, arr->sz, false, less, threads);
+  darray_destroy(&scratch);
+}
+
+// merge_sort on every core
+template <typename T, typename Less = std::less<T>>
+void parallel_merge_sort(DArray<T>* arr, Less less = Less()) {
+  merge_sort(arr, 0, less);
+}
+
+// stable sort of keys that applies the same permutation to values
+template <typename K, typename V, typename Less = std::less<K>>
+void merge_sort_by_key(DArray<K>* keys, DArray<V>* values, size_t threads = 1,
+                       Less less = Less()) {
+  if (keys->sz != values->sz) {
+    throw std::runtime_error("Keys and values differ in length");
+  }
+  // sort (key, value) pairs, then scatter them back
+  struct Pair {
+    K key;
+    V value;
+  };
+  size_t n = keys->sz;
+  DArray<Pair> pairs = darray_create<Pair>(n ? n : 1);
+  for (size_t i = 0; i < n; ++i) {
+    darray_emplace_back(&pairs, Pair{std::move(keys->data[i]),
+                                     std::move(values->data[i])});
+  }
+  auto pair_less = [&less](const Pair& x, const Pair& y) {
+    return less(x.key, y.key);
+  };
+  merge_sort(&pairs, threads, pair_less);
+  for (size_t i = 0; i < n; ++i) {
+    keys->data[i] = std::move(pairs.data[i].key);
+    values->data[i] = std::move(pairs.data[i].value);
+  }
+  darray_destroy(&pairs);
+}
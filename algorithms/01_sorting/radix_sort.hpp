@@ -0,0 +1,211 @@
+/**
+ * radix_sort.hpp
+ *
+ * Counting sort and LSD radix sort over DArray<T> for integer and floating
+ * keys. Radix sort maps each key to an unsigned integer with the same
+ * order and sorts it one byte at a time, least significant first, moving
+ * elements between the array and a single scratch buffer. With several
+ * threads every pass splits the array into one block per thread: each
+ * thread counts its block's digits into its own histogram, the histograms
+ * are turned into per-thread output offsets, and each thread scatters its
+ * block, which keeps every pass stable.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include "merge_sort.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#define RADIX_BITS 8                      // bits per digit
+#define RADIX_BUCKETS (1 << RADIX_BITS)    // digit values
+#define COUNTING_SORT_MAX_RANGE (1 << 24) // largest max - min + 1 accepted
+
+// unsigned integer of the same size as T
+template <typename T>
+using radix_uint_t = std::conditional_t<
+    sizeof(T) == 1, uint8_t,
+    std::conditional_t<sizeof(T) == 2, uint16_t,
+                       std::conditional_t<sizeof(T) == 4, uint32_t,
+                                          uint64_t>>>;
+
+// key as an unsigned integer that sorts in the same order: signed
+// integers have their sign bit flipped; floats have it flipped when
+// positive and every bit flipped when negative, so that larger magnitudes
+// of negative numbers come first
+template <typename T> radix_uint_t<T> radix_key(T x) {
+  static_assert(std::is_arithmetic_v<T>, "radix keys must be arithmetic");
+  using U = radix_uint_t<T>;
+  const U sign = U(1) << (8 * sizeof(T) - 1);
+  U bits;
+  memcpy(&bits, &x, sizeof(T));
+  if constexpr (std::is_floating_point_v<T>) {
+    return (bits & sign) ? U(~bits) : U(bits | sign);
+  } else if constexpr (std::is_signed_v<T>) {
+    return bits ^ sign;
+  } else {
+    return bits;
+  }
+}
+
+// stable sort of integer keys by counting; O(n + max - min)
+template <typename T> void counting_sort(DArray<T>* arr) {
+  static_assert(std::is_integral_v<T>, "counting sort needs integer keys");
+  if (arr->sz < 2) {
+    return;
+  }
+  T lo = arr->data[0];
+  T hi = arr->data[0];
+  for (size_t i = 1; i < arr->sz; ++i) {
+    lo = arr->data[i] < lo ? arr->data[i] : lo;
+    hi = hi < arr->data[i] ? arr->data[i] : hi;
+  }
+  // compare before adding 1, which wraps when the keys span all 64 bits
+  uint64_t diff = uint64_t(radix_key(hi) - radix_key(lo));
+  if (diff >= COUNTING_SORT_MAX_RANGE) {
+    throw std::runtime_error("Key range too large for counting sort");
+  }
+  uint64_t range = diff + 1;
+  std::vector<size_t> counts(range, 0);
+  for (size_t i = 0; i < arr->sz; ++i) {
+    counts[radix_key(arr->data[i]) - radix_key(lo)]++;
+  }
+  // keys carry no other data, so writing each value count times is the
+  // same as moving the elements
+  size_t out = 0;
+  for (uint64_t v = 0; v < range; ++v) {
+    for (size_t c = counts[v]; c > 0; --c) {
+      arr->data[out++] = T(lo + T(v));
+    }
+  }
+}
+
+// one stable pass by the digit at shift, split into `threads` blocks;
+// moves keys (and values, if given) from src to dst
+template <typename K, typename V>
+void radix_pass(const K* src_keys, K* dst_keys, const V* src_values,
+                V* dst_values, size_t n, unsigned shift, size_t threads,
+                std::vector<size_t>& hist) {
+  size_t block = (n + threads - 1) / threads;
+  auto count = [&](size_t t) {
+    size_t* h = hist.data() + t * RADIX_BUCKETS;
+    std::fill(h, h + RADIX_BUCKETS, 0);
+    size_t end = std::min(n, (t + 1) * block);
+    for (size_t i = t * block; i < end; ++i) {
+      h[(radix_key(src_keys[i]) >> shift) & (RADIX_BUCKETS - 1)]++;
+    }
+  };
+  auto scatter = [&](size_t t) {
+    size_t* h = hist.data() + t * RADIX_BUCKETS;
+    size_t end = std::min(n, (t + 1) * block);
+    for (size_t i = t * block; i < end; ++i) {
+      auto digit = (radix_key(src_keys[i]) >> shift) & (RADIX_BUCKETS - 1);
+      size_t& slot = h[digit];
+      dst_keys[slot] = src_keys[i];
+      if (src_values) {
+        dst_values[slot] = src_values[i];
+      }
+      slot++;
+    }
+  };
+  auto run = [threads](auto& phase) {
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) {
+      pool.emplace_back(phase, t);
+    }
+    phase(0);
+    for (auto& th : pool) {
+      th.join();
+    }
+  };
+
+  run(count);
+  // digit-major, thread-minor prefix sums: every block's elements of a
+  // digit land after those of earlier blocks
+  size_t offset = 0;
+  for (size_t d = 0; d < RADIX_BUCKETS; ++d) {
+    for (size_t t = 0; t < threads; ++t) {
+      size_t c = hist[t * RADIX_BUCKETS + d];
+      hist[t * RADIX_BUCKETS + d] = offset;
+      offset += c;
+    }
+  }
+  run(scatter);
+}
+
+// true if every key has the same digit at shift, making the pass a no-op
+template <typename K>
+bool radix_digit_constant(const K* keys, size_t n, unsigned shift) {
+  auto digit = (radix_key(keys[0]) >> shift) & (RADIX_BUCKETS - 1);
+  for (size_t i = 1; i < n; ++i) {
+    if (((radix_key(keys[i]) >> shift) & (RADIX_BUCKETS - 1)) != digit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// LSD radix sort of keys, carrying values along when not null
+template <typename K, typename V>
+void radix_sort_impl(K* keys, V* values, size_t n, size_t threads) {
+  static_assert(std::is_trivially_copyable_v<V>,
+                "values are moved with the keys as raw copies");
+  if (n < 2) {
+    return;
+  }
+  if (threads == 0) {
+    threads = sort_default_threads();
+  }
+  if (n < SORT_PARALLEL_CUTOFF) {
+    threads = 1;
+  }
+  DArray<K> key_scratch = merge_scratch(keys, n);
+  DArray<V> value_scratch = darray_create<V>(values ? n : 1);
+  std::vector<size_t> hist(threads * RADIX_BUCKETS);
+
+  K* src_keys = keys;
+  K* dst_keys = key_scratch.data;
+  V* src_values = values;
+  V* dst_values = values ? value_scratch.data : nullptr;
+  for (unsigned shift = 0; shift < 8 * sizeof(K); shift += RADIX_BITS) {
+    // small key ranges leave the high bytes the same in every key
+    if (radix_digit_constant(src_keys, n, shift)) {
+      continue;
+    }
+    radix_pass(src_keys, dst_keys, src_values, dst_values, n, shift, threads,
+               hist);
+    std::swap(src_keys, dst_keys);
+    std::swap(src_values, dst_values);
+  }
+  // an odd number of passes leaves the result in scratch
+  if (src_keys != keys) {
+    memcpy(keys, src_keys, n * sizeof(K));
+    if (values) {
+      memcpy(values, src_values, n * sizeof(V));
+    }
+  }
+  darray_destroy(&key_scratch);
+  darray_destroy(&value_scratch);
+}
+
+// stable sort of integer or floating keys; threads = 0 uses every core
+template <typename T> void radix_sort(DArray<T>* arr, size_t threads = 1) {
+  radix_sort_impl<T, char>(arr->data, nullptr, arr->sz, threads);
+}
+
+// stable radix sort of keys that applies the same permutation to values
+template <typename K, typename V>
+void radix_sort_by_key(DArray<K>* keys, DArray<V>* values,
+                       size_t threads = 1) {
+  if (keys->sz != values->sz) {
+    throw std::runtime_error("Keys and values differ in length");
+  }
+  radix_sort_impl(keys->data, values->data, keys->sz, threads);
+}
@@ -0,0 +1,387 @@
+/**
+ * sort.cpp
+ *
+ * Sorting tests, and a benchmark matrix of every sort over random, sorted,
+ * reversed and few-unique inputs against std::sort.
+ */
+
+#include "merge_sort.hpp"
+#include "radix_sort.hpp"
+#include "sort.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// DArray holding a copy of values
+template <typename T> DArray<T> to_darray(const std::vector<T>& values) {
+  DArray<T> arr = darray_create<T>(values.size() ? values.size() : 1);
+  darray_append(&arr, values.begin(), values.end());
+  return arr;
+}
+
+// true if arr holds the same elements as values, sorted
+template <typename T>
+bool sorted_copy_of(const DArray<T>* arr, std::vector<T> values) {
+  std::sort(values.begin(), values.end());
+  return arr->sz == values.size() &&
+         std::equal(values.begin(), values.end(), arr->data);
+}
+
+// sort a copy of values with sort_fn and check the result
+template <typename T, typename F>
+void check_sort(const std::vector<T>& values, F sort_fn, const char* name) {
+  DArray<T> arr = to_darray(values);
+  sort_fn(&arr);
+  test::assert_true(sorted_copy_of(&arr, values), name);
+  darray_destroy(&arr);
+}
+
+// a record sorted by key whose tag shows the original order
+struct Tagged {
+  int key;
+  int tag;
+};
+
+bool tagged_less(const Tagged& a, const Tagged& b) { return a.key < b.key; }
+
+// input distributions for the benchmark matrix
+enum class Dist { RANDOM, SORTED, REVERSED, FEW_UNIQUE };
+
+std::vector<int> make_input(Dist dist, size_t n, test::RandomGenerator& gen) {
+  switch (dist) {
+  case Dist::RANDOM:
+    return gen.generate_ints(n, 0, INT_MAX);
+  case Dist::SORTED: {
+    auto values = gen.generate_ints(n, 0, INT_MAX);
+    std::sort(values.begin(), values.end());
+    return values;
+  }
+  case Dist::REVERSED: {
+    auto values = gen.generate_ints(n, 0, INT_MAX);
+    std::sort(values.begin(), values.end(), std::greater<int>());
+    return values;
+  }
+  case Dist::FEW_UNIQUE:
+    return gen.generate_ints(n, 0, 15);
+  }
+  return {};
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Sorting Tests");
+
+  suite.add_test("Comparison sorts match std::sort", []() {
+    test::RandomGenerator gen;
+    for (size_t n : {0, 1, 2, 3, 17, 100, 1000, 50000}) {
+      auto values = gen.generate_ints(n, -100, 100); // with duplicates
+      if (n <= 1000) {
+        check_sort(values, [](auto* a) { insertion_sort(a); }, "Insertion");
+      }
+      check_sort(values, [](auto* a) { quick_sort(a); }, "Quick sort");
+      check_sort(values, [](auto* a) { heap_sort(a); }, "Heap sort");
+      check_sort(values, [](auto* a) { merge_sort(a); }, "Merge sort");
+      check_sort(values, [](auto* a) { merge_sort(a, 4); }, "4 threads");
+    }
+  });
+
+  suite.add_test("Quick sort on adversarial inputs", []() {
+    const int n = 100000;
+    std::vector<int> ascending(n), descending(n), equal(n, 7), pipe(n);
+    for (int i = 0; i < n; ++i) {
+      ascending[i] = i;
+      descending[i] = n - i;
+      pipe[i] = i < n / 2 ? i : n - i; // organ pipe
+    }
+    for (const auto& values : {ascending, descending, equal, pipe}) {
+      check_sort(values, [](auto* a) { quick_sort(a); }, "Quick sort");
+    }
+  });
+
+  suite.add_test("Custom comparators", []() {
+    std::vector<int> values = {5, 1, 4, 2, 3};
+    std::vector<int> want = {5, 4, 3, 2, 1};
+    auto arr = to_darray(values);
+    quick_sort(&arr, std::greater<int>());
+    test::assert_true(std::equal(want.begin(), want.end(), arr.data));
+    darray_destroy(&arr);
+
+    arr = to_darray(values);
+    heap_sort(&arr, std::greater<int>());
+    test::assert_true(std::equal(want.begin(), want.end(), arr.data));
+    darray_destroy(&arr);
+
+    arr = to_darray(values);
+    merge_sort(&arr, 1, std::greater<int>());
+    test::assert_true(std::equal(want.begin(), want.end(), arr.data));
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Merge sort is stable on one and many threads", []() {
+    test::RandomGenerator gen;
+    auto keys = gen.generate_ints(200000, 0, 50);
+    for (size_t threads : {1, 4}) {
+      auto arr = darray_create<Tagged>(keys.size());
+      for (size_t i = 0; i < keys.size(); ++i) {
+        darray_push_back(&arr, Tagged{keys[i], int(i)});
+      }
+      merge_sort(&arr, threads, tagged_less);
+      for (size_t i = 1; i < arr.sz; ++i) {
+        const Tagged& a = arr.data[i - 1];
+        const Tagged& b = arr.data[i];
+        test::assert_true(a.key < b.key || (a.key == b.key && a.tag < b.tag),
+                          "Unstable or unsorted");
+      }
+      darray_destroy(&arr);
+    }
+  });
+
+  suite.add_test("Merge sort of strings", []() {
+    test::RandomGenerator gen;
+    auto values = gen.generate_strings(5000, 1, 24);
+    check_sort(values, [](auto* a) { merge_sort(a); }, "Merge sort");
+    check_sort(values, [](auto* a) { quick_sort(a); }, "Quick sort");
+  });
+
+  suite.add_test("Radix sort of integer types", []() {
+    test::RandomGenerator gen;
+    auto ints = gen.generate_ints(100000, INT_MIN, INT_MAX);
+    ints.push_back(INT_MIN);
+    ints.push_back(INT_MAX);
+    ints.push_back(0);
+    check_sort(ints, [](auto* a) { radix_sort(a); }, "int");
+    check_sort(ints, [](auto* a) { radix_sort(a, 4); }, "int, 4 threads");
+
+    std::vector<uint64_t> wide;
+    std::vector<int8_t> narrow;
+    std::vector<int16_t> shorts;
+    for (size_t i = 0; i < ints.size(); ++i) {
+      wide.push_back(uint64_t(ints[i]) * 0x9E3779B97F4A7C15ull);
+      narrow.push_back(int8_t(ints[i]));
+      shorts.push_back(int16_t(ints[i] >> 7));
+    }
+    check_sort(wide, [](auto* a) { radix_sort(a, 3); }, "uint64_t");
+    check_sort(narrow, [](auto* a) { radix_sort(a); }, "int8_t");
+    check_sort(shorts, [](auto* a) { radix_sort(a); }, "int16_t");
+  });
+
+  suite.add_test("Radix sort of floating types", []() {
+    test::RandomGenerator gen;
+    auto ints = gen.generate_ints(50000, -1000000, 1000000);
+    std::vector<float> floats;
+    std::vector<double> doubles;
+    for (int x : ints) {
+      floats.push_back(x / 1000.0f);
+      doubles.push_back(x * 1e-300 * (x % 3 ? 1e250 : 1));
+    }
+    floats.push_back(-0.0f);
+    floats.push_back(std::numeric_limits<float>::infinity());
+    floats.push_back(-std::numeric_limits<float>::infinity());
+    check_sort(floats, [](auto* a) { radix_sort(a); }, "float");
+    check_sort(doubles, [](auto* a) { radix_sort(a, 4); }, "double");
+  });
+
+  suite.add_test("Counting sort", []() {
+    test::RandomGenerator gen;
+    auto ints = gen.generate_ints(100000, -5000, 5000);
+    check_sort(ints, [](auto* a) { counting_sort(a); }, "int");
+    std::vector<int8_t> narrow = {127, -128, 0, -1, 1, 127, -128};
+    check_sort(narrow, [](auto* a) { counting_sort(a); }, "int8_t");
+  });
+
+  suite.add_test("Sort by key keeps values with their keys", []() {
+    test::RandomGenerator gen;
+    auto raw = gen.generate_ints(100000, 0, 99);
+    for (size_t threads : {1, 4}) {
+      auto keys = to_darray(raw);
+      auto values = darray_create<uint32_t>(raw.size());
+      for (size_t i = 0; i < raw.size(); ++i) {
+        darray_push_back(&values, uint32_t(i));
+      }
+      radix_sort_by_key(&keys, &values, threads);
+      for (size_t i = 0; i < keys.sz; ++i) {
+        test::assert_equal(raw[values.data[i]], keys.data[i]);
+        if (i > 0) {
+          bool ordered = keys.data[i - 1] < keys.data[i] ||
+                         (keys.data[i - 1] == keys.data[i] &&
+                          values.data[i - 1] < values.data[i]);
+          test::assert_true(ordered, "Unstable or unsorted");
+        }
+      }
+      darray_destroy(&keys);
+      darray_destroy(&values);
+    }
+
+    std::vector<int> few = {3, 1, 2, 1};
+    std::vector<std::string> names = {"c", "a1", "b", "a2"};
+    auto keys = to_darray(few);
+    auto values = to_darray(names);
+    merge_sort_by_key(&keys, &values);
+    std::vector<std::string> want = {"a1", "a2", "b", "c"};
+    test::assert_true(std::equal(want.begin(), want.end(), values.data));
+    darray_destroy(&keys);
+    darray_destroy(&values);
+  });
+
+  // error handling tests
+  suite.add_test("Counting sort of a wide key range", []() {
+    auto arr = to_darray(std::vector<int>{INT_MIN, INT_MAX});
+    bool caught_exception = false;
+
+    try {
+      counting_sort(&arr);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Counting sort of extreme 64-bit keys", []() {
+    auto arr = to_darray(std::vector<int64_t>{INT64_MAX, INT64_MIN});
+    bool caught_exception = false;
+
+    try {
+      counting_sort(&arr);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Sort by key with mismatched lengths", []() {
+    auto keys = to_darray(std::vector<int>{2, 1});
+    auto values = to_darray(std::vector<int>{1});
+    bool caught_radix = false;
+    bool caught_merge = false;
+
+    try {
+      radix_sort_by_key(&keys, &values);
+    } catch (const std::runtime_error& e) {
+      caught_radix = true;
+    }
+    try {
+      merge_sort_by_key(&keys, &values);
+    } catch (const std::runtime_error& e) {
+      caught_merge = true;
+    }
+    test::assert_true(caught_radix, "Expected exception not thrown");
+    test::assert_true(caught_merge, "Expected exception not thrown");
+
+    darray_destroy(&keys);
+    darray_destroy(&values);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: every sort on each input distribution at 2^20 keys, then
+  // the fast sorts and sort-by-key on 2^23 random keys. Each call copies
+  // the input into the array first, which every case pays alike.
+  test::Benchmark bench("Sorting Benchmarks");
+  test::RandomGenerator gen;
+  const size_t n = 1 << 20;
+  const size_t big = 1 << 23;
+
+  using SortFn = std::function<void(DArray<int>*)>;
+  std::vector<std::pair<std::string, SortFn>> sorts = {
+      {"std::sort",
+       [](DArray<int>* a) { std::sort(a->data, a->data + a->sz); }},
+      {"Quick sort", [](DArray<int>* a) { quick_sort(a); }},
+      {"Heap sort", [](DArray<int>* a) { heap_sort(a); }},
+      {"Merge sort", [](DArray<int>* a) { merge_sort(a); }},
+      {"Parallel merge sort", [](DArray<int>* a) { parallel_merge_sort(a); }},
+      {"Radix sort", [](DArray<int>* a) { radix_sort(a); }},
+      {"Parallel radix sort", [](DArray<int>* a) { radix_sort(a, 0); }},
+  };
+  std::vector<std::pair<std::string, Dist>> dists = {
+      {"random", Dist::RANDOM},
+      {"sorted", Dist::SORTED},
+      {"reversed", Dist::REVERSED},
+      {"few unique", Dist::FEW_UNIQUE},
+  };
+
+  DArray<int> arr = darray_create<int>(big);
+  for (const auto& [dist_name, dist] : dists) {
+    auto input = make_input(dist, n, gen);
+    for (const auto& [sort_name, sort_fn] : sorts) {
+      bench.add_test(
+          sort_name + " (" + dist_name + ", 2^20)",
+          [&arr, input, sort_fn = sort_fn]() {
+            arr.sz = 0;
+            darray_append(&arr, input.begin(), input.end());
+            sort_fn(&arr);
+            test::do_not_optimize(arr.data[0]);
+          },
+          n);
+    }
+  }
+
+  auto big_input = make_input(Dist::RANDOM, big, gen);
+  for (size_t i = 0; i < sorts.size(); ++i) {
+    const auto& [sort_name, sort_fn] = sorts[i];
+    if (sort_name == "Quick sort" || sort_name == "Heap sort") {
+      continue;
+    }
+    bench.add_test(
+        sort_name + " (random, 2^23)",
+        [&arr, &big_input, sort_fn = sort_fn]() {
+          arr.sz = 0;
+          darray_append(&arr, big_input.begin(), big_input.end());
+          sort_fn(&arr);
+          test::do_not_optimize(arr.data[0]);
+        },
+        big);
+  }
+
+  // sort (key, row) pairs: std::sort on pairs against sort-by-key
+  std::vector<std::pair<int, uint32_t>> pairs(big);
+  DArray<uint32_t> rows = darray_create<uint32_t>(big);
+  rows.sz = big;
+
+  bench.add_test(
+      "std::sort of pairs (random, 2^23)",
+      [&pairs, &big_input]() {
+        for (size_t i = 0; i < big; ++i) {
+          pairs[i] = {big_input[i], uint32_t(i)};
+        }
+        std::sort(pairs.begin(), pairs.end());
+        test::do_not_optimize(pairs[0].second);
+      },
+      big);
+
+  bench.add_test(
+      "Parallel radix sort by key (random, 2^23)",
+      [&arr, &rows, &big_input]() {
+        arr.sz = 0;
+        darray_append(&arr, big_input.begin(), big_input.end());
+        for (size_t i = 0; i < big; ++i) {
+          rows.data[i] = uint32_t(i);
+        }
+        radix_sort_by_key(&arr, &rows, 0);
+        test::do_not_optimize(rows.data[0]);
+      },
+      big);
+
+  // run all benchmarks
+  bench.run();
+
+  darray_destroy(&arr);
+  darray_destroy(&rows);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Sorting program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
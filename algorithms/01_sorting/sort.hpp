@@ -0,0 +1,144 @@
+/**
+ * sort.hpp
+ *
+ * In-place comparison sorts over DArray<T>: insertion sort, quick sort
+ * and heap sort. Quick sort is introspective: it falls back to heap sort
+ * on a subrange whose partitions keep coming out lopsided, so no input
+ * takes it past O(n log n).
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+#define SORT_INSERTION_CUTOFF 16 // ranges this small use insertion sort
+
+// insertion sort of [data, data + n)
+template <typename T, typename Less>
+void insertion_sort_range(T* data, size_t n, Less& less) {
+  for (size_t i = 1; i < n; ++i) {
+    T x = std::move(data[i]);
+    size_t j = i;
+    for (; j > 0 && less(x, data[j - 1]); --j) {
+      data[j] = std::move(data[j - 1]);
+    }
+    data[j] = std::move(x);
+  }
+}
+
+// stable, O(n^2); the fastest choice for small or nearly sorted arrays
+template <typename T, typename Less = std::less<T>>
+void insertion_sort(DArray<T>* arr, Less less = Less()) {
+  insertion_sort_range(arr->data, arr->sz, less);
+}
+
+// move x down a max-heap of n elements from the hole at i
+template <typename T, typename Less>
+void heap_sort_sift(T* data, size_t n, size_t i, T x, Less& less) {
+  for (;;) {
+    size_t child = 2 * i + 1;
+    if (child >= n) {
+      break;
+    }
+    if (child + 1 < n && less(data[child], data[child + 1])) {
+      child++;
+    }
+    if (!less(x, data[child])) {
+      break;
+    }
+    data[i] = std::move(data[child]);
+    i = child;
+  }
+  data[i] = std::move(x);
+}
+
+// heap sort of [data, data + n)
+template <typename T, typename Less>
+void heap_sort_range(T* data, size_t n, Less& less) {
+  if (n < 2) {
+    return;
+  }
+  for (size_t i = n / 2; i-- > 0;) {
+    heap_sort_sift(data, n, i, std::move(data[i]), less);
+  }
+  // move the largest to the end, shrinking the heap by one each time
+  for (size_t end = n - 1; end > 0; --end) {
+    T x = std::move(data[end]);
+    data[end] = std::move(data[0]);
+    heap_sort_sift(data, end, 0, std::move(x), less);
+  }
+}
+
+// unstable, O(n log n) in every case and no extra memory
+template <typename T, typename Less = std::less<T>>
+void heap_sort(DArray<T>* arr, Less less = Less()) {
+  heap_sort_range(arr->data, arr->sz, less);
+}
+
+// order a, b, c so that b holds their median
+template <typename T, typename Less>
+void quick_sort_median3(T& a, T& b, T& c, Less& less) {
+  if (less(b, a)) {
+    std::swap(a, b);
+  }
+  if (less(c, b)) {
+    std::swap(b, c);
+    if (less(b, a)) {
+      std::swap(a, b);
+    }
+  }
+}
+
+// quick sort of [data, data + n), with at most depth more levels before
+// switching to heap sort
+template <typename T, typename Less>
+void quick_sort_range(T* data, size_t n, size_t depth, Less& less) {
+  while (n > SORT_INSERTION_CUTOFF) {
+    if (depth-- == 0) {
+      heap_sort_range(data, n, less);
+      return;
+    }
+    // the median of three sits at data[1] with sentinels on both sides
+    std::swap(data[1], data[n / 2]);
+    quick_sort_median3(data[0], data[1], data[n - 1], less);
+    // Hoare partition around the pivot; equal keys stop both scans, which
+    // keeps runs of duplicates split evenly
+    T pivot = data[1];
+    size_t i = 1;
+    size_t j = n - 1;
+    for (;;) {
+      while (less(data[++i], pivot)) {
+      }
+      while (less(pivot, data[--j])) {
+      }
+      if (i >= j) {
+        break;
+      }
+      std::swap(data[i], data[j]);
+    }
+    std::swap(data[1], data[j]);
+    // recurse into the smaller side, loop on the larger one
+    if (j < n - j - 1) {
+      quick_sort_range(data, j, depth, less);
+      data += j + 1;
+      n -= j + 1;
+    } else {
+      quick_sort_range(data + j + 1, n - j - 1, depth, less);
+      n = j;
+    }
+  }
+  insertion_sort_range(data, n, less);
+}
+
+// unstable, O(n log n) expected and worst case
+template <typename T, typename Less = std::less<T>>
+void quick_sort(DArray<T>* arr, Less less = Less()) {
+  size_t depth = 0;
+  for (size_t n = arr->sz; n > 1; n >>= 1) {
+    depth += 2;
+  }
+  quick_sort_range(arr->data, arr->sz, depth, less);
+}
@@ -0,0 +1,917 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(TEST_TRACK_ALLOCS) && defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// namespace for testing framework
+namespace test {
+// timer for benchmarking
+class Timer {
+private:
+  using Clock = std::chrono::high_resolution_clock;
+  using TimePoint = Clock::time_point;
+  using Duration = std::chrono::duration<double>;
+
+  TimePoint start_;
+  std::string operation_name_;
+
+public:
+  // constructor
+  explicit Timer(std::string operation = "Operation")
+      : start_(Clock::now()), operation_name_(std::move(operation)) {}
+
+  // destructor
+  ~Timer() {
+    auto end = Clock::now();
+    Duration duration = end - start_;
+    std::cout << operation_name_ << " took " << duration.count() * 1000 << "ms"
+              << std::endl;
+  }
+};
+
+// rng utilities
+class RandomGenerator {
+private:
+  std::mt19937 gen_;
+
+public:
+  // constructor
+  RandomGenerator() : gen_(std::random_device{}()) {}
+
+  // generate random integer vector
+  std::vector<int> generate_ints(size_t len, int min = 0, int max = 1000) {
+    std::vector<int> ints(len);
+    std::uniform_int_distribution<> dist(min, max);
+    std::generate(ints.begin(), ints.end(), [&]() { return dist(gen_); });
+    return ints;
+  }
+
+  // generate random string
+  std::string generate_string(size_t len) {
+    std::string str(len, 0);
+    std::uniform_int_distribution<> dist('a', 'z');
+    std::generate(str.begin(), str.end(),
+                  [&]() { return static_cast<char>(dist(gen_)); });
+    return str;
+  }
+
+  // generate random string vector
+  std::vector<std::string> generate_strings(size_t count, size_t min_len = 1,
+                                            size_t max_len = 10) {
+    std::vector<std::string> strs(count);
+    std::uniform_int_distribution<> len_dist(min_len, max_len);
+    std::generate(strs.begin(), strs.end(),
+                  [&]() { return generate_string(len_dist(gen_)); });
+    return strs;
+  }
+};
+
+// heap allocation accounting; the hooks at the end of this file are only
+// compiled in with -DTEST_TRACK_ALLOCS (make TRACK_ALLOCS=1)
+#ifdef TEST_TRACK_ALLOCS
+constexpr bool alloc_tracking = true;
+#else
+constexpr bool alloc_tracking = false;
+#endif
+
+struct AllocStats {
+  size_t count = 0; // allocations, including reallocs
+  size_t bytes = 0; // total bytes requested
+  size_t peak = 0;  // peak live heap bytes above the starting level
+};
+
+namespace alloc_detail {
+inline std::atomic<size_t> count{0};
+inline std::atomic<size_t> bytes{0};
+inline std::atomic<long long> live{0}; // usable bytes currently allocated
+inline std::atomic<long long> peak{0};
+
+inline void on_alloc(size_t requested, size_t usable) {
+  count.fetch_add(1, std::memory_order_relaxed);
+  bytes.fetch_add(requested, std::memory_order_relaxed);
+  long long now =
+      live.fetch_add(usable, std::memory_order_relaxed) + (long long)usable;
+  long long prev = peak.load(std::memory_order_relaxed);
+  while (now > prev &&
+         !peak.compare_exchange_weak(prev, now, std::memory_order_relaxed)) {
+  }
+}
+
+inline void on_free(size_t usable) {
+  live.fetch_sub(usable, std::memory_order_relaxed);
+}
+} // namespace alloc_detail
+
+// counts allocations made between construction and stats()
+class AllocScope {
+private:
+  size_t count_;
+  size_t bytes_;
+  long long live_;
+
+public:
+  AllocScope()
+      : count_(alloc_detail::count.load()), bytes_(alloc_detail::bytes.load()),
+        live_(alloc_detail::live.load()) {
+    alloc_detail::peak.store(live_);
+  }
+
+  AllocStats stats() const {
+    AllocStats stats;
+    stats.count = alloc_detail::count.load() - count_;
+    stats.bytes = alloc_detail::bytes.load() - bytes_;
+    long long peak = alloc_detail::peak.load() - live_;
+    stats.peak = peak > 0 ? static_cast<size_t>(peak) : 0;
+    return stats;
+  }
+};
+
+// prevent the compiler from discarding a computed value
+template <typename T> inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename T> inline void do_not_optimize(T& value) {
+  asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+// force pending memory writes to be treated as observable
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+// summary statistics over benchmark samples (nanoseconds per call)
+struct Stats {
+  double min = 0;
+  double median = 0;
+  double mean = 0;
+  double p99 = 0;
+  double stddev = 0;
+};
+
+// nearest-rank percentile of an already sorted sample vector
+inline double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+  rank = std::clamp<size_t>(rank, 1, sorted.size());
+  return sorted[rank - 1];
+}
+
+// compute summary statistics over benchmark samples
+inline Stats compute_stats(std::vector<double> samples) {
+  Stats stats;
+  if (samples.empty()) {
+    return stats;
+  }
+  std::sort(samples.begin(), samples.end());
+
+  double sum = 0;
+  for (double s : samples) {
+    sum += s;
+  }
+  stats.mean = sum / samples.size();
+
+  double var = 0;
+  for (double s : samples) {
+    var += (s - stats.mean) * (s - stats.mean);
+  }
+  stats.stddev =
+      samples.size() > 1 ? std::sqrt(var / (samples.size() - 1)) : 0;
+
+  stats.min = samples.front();
+  stats.median = percentile(samples, 50);
+  stats.p99 = percentile(samples, 99);
+  return stats;
+}
+
+// format a nanosecond duration with a readable unit
+inline std::string format_duration(double ns) {
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(2);
+  if (ns < 1e3) {
+    oss << ns << "ns";
+  } else if (ns < 1e6) {
+    oss << ns / 1e3 << "us";
+  } else if (ns < 1e9) {
+    oss << ns / 1e6 << "ms";
+  } else {
+    oss << ns / 1e9 << "s";
+  }
+  return oss.str();
+}
+
+// hardware performance counters (linux perf_event_open), one fd per event
+class PerfCounters {
+public:
+  enum Event {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    NUM_EVENTS
+  };
+
+  static const char* event_name(int event) {
+    static const char* names[NUM_EVENTS] = {"cycles", "instructions",
+                                            "l1d_misses", "llc_misses",
+                                            "branch_misses"};
+    return names[event];
+  }
+
+private:
+  int fds_[NUM_EVENTS];
+  std::string error_;
+
+#ifdef __linux__
+  static int open_event(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1; // user-space only, allowed at paranoid level 2
+    attr.exclude_hv = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+#endif
+
+public:
+  // constructor: open every event, keeping whichever ones succeed
+  PerfCounters() {
+    std::fill(fds_, fds_ + NUM_EVENTS, -1);
+#ifdef __linux__
+    const uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+                                   (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    fds_[CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    if (fds_[CYCLES] < 0) {
+      error_ = std::string("perf_event_open: ") + std::strerror(errno);
+    }
+    fds_[INSTRUCTIONS] =
+        open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[L1D_MISSES] = open_event(PERF_TYPE_HW_CACHE, l1d_read_miss);
+    fds_[LLC_MISSES] =
+        open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    fds_[BRANCH_MISSES] =
+        open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#else
+    error_ = "hardware counters require linux";
+#endif
+  }
+
+  // destructor
+  ~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  // true if at least one event could be opened
+  bool available() const {
+    return std::any_of(fds_, fds_ + NUM_EVENTS, [](int fd) { return fd >= 0; });
+  }
+
+  const std::string& error() const { return error_; }
+
+  // reset and start counting
+  void start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // stop counting
+  void stop() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // count since start(), scaled for multiplexing; -1 if unavailable
+  double value(int event) const {
+#ifdef __linux__
+    uint64_t buf[3]; // value, time enabled, time running
+    if (fds_[event] < 0 ||
+        read(fds_[event], buf, sizeof(buf)) != sizeof(buf)) {
+      return -1;
+    }
+    if (buf[2] == 0) {
+      return buf[2] == buf[1] ? static_cast<double>(buf[0]) : -1;
+    }
+    return static_cast<double>(buf[0]) * buf[1] / buf[2];
+#else
+    (void)event;
+    return -1;
+#endif
+  }
+};
+
+// build metadata recorded with benchmark results (set by the Makefile)
+#ifndef BENCH_CC_FLAGS
+#define BENCH_CC_FLAGS "unknown"
+#endif
+#ifndef BENCH_GIT_REV
+#define BENCH_GIT_REV "unknown"
+#endif
+
+// escape a string for use inside a json string literal
+inline std::string json_escape(const std::string& str) {
+  std::ostringstream oss;
+  for (char c : str) {
+    switch (c) {
+    case '"':
+      oss << "\\\"";
+      break;
+    case '\\':
+      oss << "\\\\";
+      break;
+    case '\n':
+      oss << "\\n";
+      break;
+    case '\t':
+      oss << "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        oss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+            << static_cast<int>(c) << std::dec << std::setfill(' ');
+      } else {
+        oss << c;
+      }
+    }
+  }
+  return oss.str();
+}
+
+// quote a csv field if it contains separators or quotes
+inline std::string csv_escape(const std::string& str) {
+  if (str.find_first_of(",\"\n") == std::string::npos) {
+    return str;
+  }
+  std::string out = "\"";
+  for (char c : str) {
+    if (c == '"') {
+      out += '"';
+    }
+    out += c;
+  }
+  return out + "\"";
+}
+
+// measured result of one benchmark case
+struct BenchResult {
+  std::string name;
+  size_t ops = 1;              // operations per call
+  size_t iters = 0;            // calls per sample
+  std::vector<double> samples; // nanoseconds per call
+  Stats stats;
+  double counters[PerfCounters::NUM_EVENTS]; // per op, -1 if unavailable
+  AllocStats allocs; // heap use of one call, if alloc_tracking
+};
+
+// benchmark suite
+class Benchmark {
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Case {
+    std::string name;
+    std::function<void()> fn;
+    size_t ops; // operations performed by one call, for ns/op
+  };
+
+  std::string name_;
+  std::vector<Case> tests_;
+  std::vector<BenchResult> results_;
+  size_t warmup_ = 1;          // untimed calls before calibration
+  size_t repetitions_ = 10;    // timed samples per case
+  double min_sample_ms_ = 5.0; // minimum duration of one timed sample
+  size_t max_iters_ = 1 << 20; // calibration upper bound
+  bool counters_ = false;      // read hardware counters per case
+
+  // time `iters` back-to-back calls, in nanoseconds
+  static double time_calls(const std::function<void()>& fn, size_t iters) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < iters; ++i) {
+      fn();
+    }
+    clobber_memory();
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+  }
+
+  // find a batch size whose runtime reaches the minimum sample time
+  size_t calibrate(const std::function<void()>& fn) const {
+    double target_ns = min_sample_ms_ * 1e6;
+    size_t iters = 1;
+    while (iters < max_iters_) {
+      double ns = time_calls(fn, iters);
+      if (ns >= target_ns) {
+        break;
+      }
+      // grow towards the target, at most 10x per step
+      double mult = ns > 0 ? std::min(10.0, 1.4 * target_ns / ns) : 10.0;
+      iters = std::min(max_iters_,
+                       std::max(iters + 1, static_cast<size_t>(iters * mult)));
+    }
+    return iters;
+  }
+
+  // print counters normalized per operation
+  static void print_counters(const BenchResult& result,
+                             const PerfCounters& perf) {
+    if (!perf.available()) {
+      std::cout << "  counters unavailable (" << perf.error() << ")"
+                << std::endl;
+      return;
+    }
+
+    std::cout << "  " << std::fixed << std::setprecision(3);
+    for (int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+      std::cout << PerfCounters::event_name(e) << "/op ";
+      if (result.counters[e] < 0) {
+        std::cout << "n/a  ";
+      } else {
+        std::cout << result.counters[e] << "  ";
+      }
+    }
+    double cycles = result.counters[PerfCounters::CYCLES];
+    double instrs = result.counters[PerfCounters::INSTRUCTIONS];
+    if (cycles > 0 && instrs >= 0) {
+      std::cout << "ipc " << instrs / cycles;
+    }
+    std::cout << std::defaultfloat << std::endl;
+  }
+
+  // file-name friendly version of the suite name
+  std::string slug() const {
+    std::string out;
+    for (char c : name_) {
+      if (std::isalnum(static_cast<unsigned char>(c))) {
+        out += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+      } else if (!out.empty() && out.back() != '_') {
+        out += '_';
+      }
+    }
+    while (!out.empty() && out.back() == '_') {
+      out.pop_back();
+    }
+    return out;
+  }
+
+public:
+  explicit Benchmark(std::string name) : name_(std::move(name)) {}
+
+  // add test case; `ops` is the number of operations one call performs
+  template <typename Func>
+  void add_test(const std::string& test_name, Func&& test, size_t ops = 1) {
+    tests_.push_back({test_name, std::forward<Func>(test), ops});
+  }
+
+  // configure measurement
+  void set_warmup(size_t calls) { warmup_ = calls; }
+  void set_repetitions(size_t samples) {
+    repetitions_ = std::max<size_t>(1, samples);
+  }
+  void set_min_sample_time(double ms) { min_sample_ms_ = ms; }
+  void enable_counters(bool on = true) { counters_ = on; }
+
+  // results of the last run
+  const std::vector<BenchResult>& results() const { return results_; }
+
+  // write results as a json document
+  void write_json(std::ostream& os) const {
+    os << std::setprecision(17);
+    os << "{\n"
+       << "  \"suite\": \"" << json_escape(name_) << "\",\n"
+       << "  \"compiler\": \"" << json_escape(__VERSION__) << "\",\n"
+       << "  \"flags\": \"" << json_escape(BENCH_CC_FLAGS) << "\",\n"
+       << "  \"git_rev\": \"" << json_escape(BENCH_GIT_REV) << "\",\n"
+       << "  \"repetitions\": " << repetitions_ << ",\n"
+       << "  \"min_sample_ms\": " << min_sample_ms_ << ",\n"
+       << "  \"cases\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+      const BenchResult& r = results_[i];
+      os << (i ? ",\n" : "\n") << "    {\n"
+         << "      \"name\": \"" << json_escape(r.name) << "\",\n"
+         << "      \"ops\": " << r.ops << ",\n"
+         << "      \"iterations\": " << r.iters << ",\n"
+         << "      \"min_ns\": " << r.stats.min << ",\n"
+         << "      \"median_ns\": " << r.stats.median << ",\n"
+         << "      \"mean_ns\": " << r.stats.mean << ",\n"
+         << "      \"p99_ns\": " << r.stats.p99 << ",\n"
+         << "      \"stddev_ns\": " << r.stats.stddev << ",\n"
+         << "      \"ns_per_op\": " << r.stats.median / r.ops << ",\n"
+         << "      \"counters_per_op\": {";
+      for (int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+        os << (e ? ", " : "") << "\"" << PerfCounters::event_name(e)
+           << "\": ";
+        if (r.counters[e] < 0) {
+          os << "null";
+        } else {
+          os << r.counters[e];
+        }
+      }
+      os << "},\n      \"allocs_per_call\": ";
+      if (alloc_tracking) {
+        os << "{\"count\": " << r.allocs.count << ", \"bytes\": "
+           << r.allocs.bytes << ", \"peak_bytes\": " << r.allocs.peak << "}";
+      } else {
+        os << "null";
+      }
+      os << ",\n      \"samples_ns\": [";
+      for (size_t s = 0; s < r.samples.size(); ++s) {
+        os << (s ? ", " : "") << r.samples[s];
+      }
+      os << "]\n    }";
+    }
+    os << "\n  ]\n}\n" << std::defaultfloat;
+  }
+
+  // write results as csv, one row per case; samples are ';'-separated
+  void write_csv(std::ostream& os) const {
+    os << std::setprecision(17);
+    os << "suite,name,ops,iterations,repetitions,min_ns,median_ns,mean_ns,"
+          "p99_ns,stddev_ns,ns_per_op";
+    for (int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+      os << "," << PerfCounters::event_name(e);
+    }
+    os << ",allocs,alloc_bytes,peak_bytes,compiler,flags,git_rev,samples_ns\n";
+
+    for (const BenchResult& r : results_) {
+      os << csv_escape(name_) << "," << csv_escape(r.name) << "," << r.ops
+         << "," << r.iters << "," << r.samples.size() << "," << r.stats.min
+         << "," << r.stats.median << "," << r.stats.mean << ","
+         << r.stats.p99 << "," << r.stats.stddev << ","
+         << r.stats.median / r.ops;
+      for (int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+        os << ",";
+        if (r.counters[e] >= 0) {
+          os << r.counters[e];
+        }
+      }
+      if (alloc_tracking) {
+        os << "," << r.allocs.count << "," << r.allocs.bytes << ","
+           << r.allocs.peak;
+      } else {
+        os << ",,,";
+      }
+      os << "," << csv_escape(__VERSION__) << "," << csv_escape(BENCH_CC_FLAGS)
+         << "," << csv_escape(BENCH_GIT_REV) << ",";
+      for (size_t s = 0; s < r.samples.size(); ++s) {
+        os << (s ? ";" : "") << r.samples[s];
+      }
+      os << "\n";
+    }
+    os << std::defaultfloat;
+  }
+
+  // run all benchmarks; if BENCH_OUT_DIR is set, results are also written
+  // there as <suite>.json and <suite>.csv
+  void run() {
+    std::cout << "\nRunning benchmark suite: " << name_ << "\n"
+              << std::string(50, '=') << std::endl;
+
+    results_.clear();
+    for (const auto& tc : tests_) {
+      std::cout << "\nExecuting tests: " << tc.name << std::endl;
+
+      for (size_t i = 0; i < warmup_; ++i) {
+        tc.fn();
+      }
+      size_t iters = calibrate(tc.fn);
+
+      std::unique_ptr<PerfCounters> perf;
+      if (counters_) {
+        perf = std::make_unique<PerfCounters>();
+        perf->start();
+      }
+
+      BenchResult result;
+      result.name = tc.name;
+      result.ops = tc.ops;
+      result.iters = iters;
+      result.samples.reserve(repetitions_);
+      for (size_t r = 0; r < repetitions_; ++r) {
+        result.samples.push_back(time_calls(tc.fn, iters) / iters);
+      }
+      if (perf) {
+        perf->stop();
+      }
+      result.stats = compute_stats(result.samples);
+
+      double total_ops = static_cast<double>(repetitions_) * iters * tc.ops;
+      for (int e = 0; e < PerfCounters::NUM_EVENTS; ++e) {
+        double v = perf ? perf->value(e) : -1;
+        result.counters[e] = v < 0 ? -1 : v / total_ops;
+      }
+
+      const Stats& stats = result.stats;
+      std::cout << "  " << repetitions_ << " samples x " << iters
+                << " iterations\n"
+                << "  min " << format_duration(stats.min) << "  median "
+                << format_duration(stats.median) << "  mean "
+                << format_duration(stats.mean) << "  p99 "
+                << format_duration(stats.p99) << "  (per call)\n"
+                << "  " << std::fixed << std::setprecision(2)
+                << stats.median / tc.ops << " ns/op" << std::defaultfloat
+                << std::endl;
+
+      if (perf) {
+        print_counters(result, *perf);
+      }
+
+      // one extra untimed call attributes heap use to the case
+      if (alloc_tracking) {
+        AllocScope scope;
+        tc.fn();
+        result.allocs = scope.stats();
+        std::cout << "  allocs/call " << result.allocs.count << "  bytes/call "
+                  << result.allocs.bytes << "  peak/call " << result.allocs.peak
+                  << std::endl;
+      }
+      results_.push_back(std::move(result));
+    }
+
+    if (const char* dir = std::getenv("BENCH_OUT_DIR")) {
+      std::string base = std::string(dir) + "/" + slug();
+      std::ofstream json(base + ".json");
+      std::ofstream csv(base + ".csv");
+      if (!json || !csv) {
+        std::cerr << "Could not write benchmark results to " << dir
+                  << std::endl;
+        return;
+      }
+      write_json(json);
+      write_csv(csv);
+      std::cout << "\nResults written to " << base << ".{json,csv}"
+                << std::endl;
+    }
+  }
+};
+
+// unit testing utilities
+class TestSuite {
+private:
+  std::string name_;
+  std::vector<std::pair<std::string, std::function<void()>>> tests_;
+  size_t passed_ = 0;
+  size_t failed_ = 0;
+
+public:
+  explicit TestSuite(std::string name) : name_(std::move(name)) {}
+
+  // add test case
+  template <typename Func>
+  void add_test(const std::string& test_name, Func&& test) {
+    tests_.emplace_back(test_name, std::forward<Func>(test));
+  }
+
+  // run all tests
+  void run() {
+    std::cout << "\nRunning test suite: " << name_ << "\n"
+              << std::string(50, '=') << std::endl;
+
+    for (const auto& [test_name, test] : tests_) {
+      try {
+        std::cout << "Running test: " << test_name << "...";
+        AllocScope scope;
+        test();
+        std::cout << "PASSED ";
+        if (alloc_tracking) {
+          AllocStats allocs = scope.stats();
+          std::cout << "(" << allocs.count << " allocs, " << allocs.bytes
+                    << " bytes, peak " << allocs.peak << ")";
+        }
+        std::cout << std::endl;
+        ++passed_;
+      } catch (const std::exception& e) {
+        std::cout << "FAILED\nError: " << e.what() << std::endl;
+        ++failed_;
+      }
+    }
+
+    // print summary
+    std::cout << "\nTest Summary:\n"
+              << "Passed: " << passed_ << "\n"
+              << "Failed: " << failed_ << "\n"
+              << "Total: " << tests_.size() << std::endl;
+  }
+};
+// assertion utilities
+template <typename T>
+void assert_equal(const T& expected, const T& actual,
+                  const std::string& message = "") {
+  if (!(expected == actual)) {
+    std::ostringstream oss;
+    oss << "Assertion failed: expected " << expected << ", got " << actual;
+    if (!message.empty()) {
+      oss << " - " << message;
+    }
+    throw std::runtime_error(oss.str());
+  }
+}
+
+template <typename T>
+void assert_not_equal(const T& unexpected, const T& actual,
+                      const std::string& message = "") {
+  if (unexpected == actual) {
+    std::ostringstream oss;
+    oss << "Assertion failed: unexpected " << unexpected;
+    if (!message.empty()) {
+      oss << " - " << message;
+    }
+    throw std::runtime_error(oss.str());
+  }
+}
+
+inline void assert_true(bool condition, const std::string& message = "") {
+  if (!condition) {
+    std::ostringstream oss;
+    oss << "Assertion failed: expected true";
+    if (!message.empty()) {
+      oss << " - " << message;
+    }
+    throw std::runtime_error(oss.str());
+  }
+}
+
+inline void assert_false(bool condition, const std::string& message = "") {
+  if (condition) {
+    std::ostringstream oss;
+    oss << "Assertion failed: expected false";
+    if (!message.empty()) {
+      oss << " - " << message;
+    }
+    throw std::runtime_error(oss.str());
+  }
+}
+
+} // namespace test
+
+#ifdef TEST_TRACK_ALLOCS
+#if defined(__GLIBC__)
+// interpose the malloc family; operator new/delete forward to it below
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) noexcept {
+  void* ptr = __libc_malloc(size);
+  if (ptr) {
+    test::alloc_detail::on_alloc(size, malloc_usable_size(ptr));
+  }
+  return ptr;
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+  void* ptr = __libc_calloc(count, size);
+  if (ptr) {
+    test::alloc_detail::on_alloc(count * size, malloc_usable_size(ptr));
+  }
+  return ptr;
+}
+
+void* realloc(void* ptr, size_t size) noexcept {
+  size_t old_usable = ptr ? malloc_usable_size(ptr) : 0;
+  void* new_ptr = __libc_realloc(ptr, size);
+  if (new_ptr) {
+    test::alloc_detail::on_free(old_usable);
+    test::alloc_detail::on_alloc(size, malloc_usable_size(new_ptr));
+  } else if (size == 0) {
+    test::alloc_detail::on_free(old_usable);
+  }
+  return new_ptr;
+}
+
+void* memalign(size_t alignment, size_t size) noexcept {
+  void* ptr = __libc_memalign(alignment, size);
+  if (ptr) {
+    test::alloc_detail::on_alloc(size, malloc_usable_size(ptr));
+  }
+  return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) noexcept {
+  return memalign(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) noexcept {
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  void* ptr = memalign(alignment, size);
+  if (!ptr) {
+    return ENOMEM;
+  }
+  *out = ptr;
+  return 0;
+}
+
+void free(void* ptr) noexcept {
+  if (ptr) {
+    test::alloc_detail::on_free(malloc_usable_size(ptr));
+  }
+  __libc_free(ptr);
+}
+}
+
+void* operator new(size_t size) {
+  if (void* ptr = std::malloc(size ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+#else
+// without glibc only operator new/delete can be intercepted; a header in
+// front of each block remembers its size
+constexpr size_t kAllocHeader = alignof(std::max_align_t);
+
+void* operator new(size_t size) {
+  char* block = static_cast<char*>(std::malloc(size + kAllocHeader));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  *reinterpret_cast<size_t*>(block) = size;
+  test::alloc_detail::on_alloc(size, size);
+  return block + kAllocHeader;
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr) {
+    char* block = static_cast<char*>(ptr) - kAllocHeader;
+    test::alloc_detail::on_free(*reinterpret_cast<size_t*>(block));
+    std::free(block);
+  }
+}
+#endif
+
+void* operator new[](size_t size) { return ::operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return ::operator new(size);
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return ::operator new(size, std::nothrow);
+}
+
+void operator delete[](void* ptr) noexcept { ::operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { ::operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { ::operator delete(ptr); }
+#endif // TEST_TRACK_ALLOCS
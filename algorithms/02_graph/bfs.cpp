@@ -0,0 +1,319 @@
+/**
+ * bfs.cpp
+ *
+ * Breadth-first search tests, and benchmarks of the serial, top-down and
+ * direction-optimizing searches on RMAT and uniform random graphs,
+ * reported in traversed edges per second.
+ */
+
+#include "bfs.hpp"
+#include "../../data_structures/07_graph/graph_gen.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+// hop count from source to every vertex, -1 if unreachable
+std::vector<int> reference_depths(const CsrGraph* g, uint32_t source) {
+  std::vector<int> depth(g->n, -1);
+  std::queue<uint32_t> queue;
+  depth[source] = 0;
+  queue.push(source);
+  while (!queue.empty()) {
+    uint32_t u = queue.front();
+    queue.pop();
+    for (size_t i = 0; i < csr_degree(g, u); ++i) {
+      uint32_t v = csr_targets(g, u)[i];
+      if (depth[v] < 0) {
+        depth[v] = depth[u] + 1;
+        queue.push(v);
+      }
+    }
+  }
+  return depth;
+}
+
+// parent is a BFS tree of g: it reaches what the reference reaches, and
+// every parent is one level up and has an edge to its child
+void check_tree(const CsrGraph* g, const DArray<uint32_t>* parent,
+                uint32_t source) {
+  std::vector<int> depth = reference_depths(g, source);
+  test::assert_equal(g->n, parent->sz);
+  test::assert_equal(source, parent->data[source]);
+  for (uint32_t v = 0; v < g->n; ++v) {
+    uint32_t p = parent->data[v];
+    test::assert_equal(depth[v] < 0, p == BFS_NONE, "Reached set differs");
+    if (v == source || p == BFS_NONE) {
+      continue;
+    }
+    test::assert_equal(depth[v] - 1, depth[p], "Parent not one level up");
+    const uint32_t* t = csr_targets(g, p);
+    bool edge = std::find(t, t + csr_degree(g, p), v) != t + csr_degree(g, p);
+    test::assert_true(edge, "Parent has no edge to child");
+  }
+}
+
+// first vertex from `start` on with an edge
+uint32_t pick_source(const CsrGraph* g, uint32_t start) {
+  uint32_t v = start % g->n;
+  while (csr_degree(g, v) == 0) {
+    v = (v + 1) % g->n;
+  }
+  return v;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("BFS Tests");
+
+  suite.add_test("Serial search of a small graph", []() {
+    // 0 - 1 - 2 - 3 and 0 - 4 - 3, plus 5 - 6 on their own
+    auto edges = darray_create<CsrEdge>();
+    std::vector<std::pair<int, int>> pairs = {{0, 1}, {1, 2}, {2, 3},
+                                              {0, 4}, {4, 3}, {5, 6}};
+    for (auto [u, v] : pairs) {
+      darray_push_back(&edges, CsrEdge{uint32_t(u), uint32_t(v), 1});
+    }
+    auto g = csr_build_undirected(7, &edges);
+    BfsStats stats;
+    auto parent = bfs_serial(&g, 0, &stats);
+
+    test::assert_equal(0u, parent.data[0]);
+    test::assert_equal(0u, parent.data[1]);
+    test::assert_equal(1u, parent.data[2]);
+    test::assert_equal(4u, parent.data[3]);
+    test::assert_equal(BFS_NONE, parent.data[5]);
+    test::assert_equal(size_t(5), stats.reached);
+    test::assert_equal(size_t(3), stats.levels);
+    check_tree(&g, &parent, 0);
+
+    darray_destroy(&parent);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Every search on undirected RMAT graphs", []() {
+    auto edges = graph_gen_rmat(13, 16, 0, 5);
+    auto g = csr_build_undirected(size_t(1) << 13, &edges);
+    uint32_t source = pick_source(&g, 77);
+
+    BfsStats serial;
+    auto p0 = bfs_serial(&g, source, &serial);
+    check_tree(&g, &p0, source);
+    for (size_t threads : {1, 4}) {
+      BfsStats stats;
+      auto p1 = bfs_top_down(&g, source, threads, &stats);
+      check_tree(&g, &p1, source);
+      test::assert_equal(size_t(0), stats.bottom_up_levels);
+      test::assert_equal(serial.levels, stats.levels);
+
+      auto p2 = bfs(&g, &g, source, threads, &stats);
+      check_tree(&g, &p2, source);
+      test::assert_true(stats.bottom_up_levels > 0, "Never went bottom-up");
+      test::assert_equal(serial.reached, stats.reached);
+      test::assert_equal(serial.levels, stats.levels);
+      // bottom-up stops at the first parent found
+      test::assert_true(stats.edges_checked < serial.edges_checked,
+                        "Bottom-up should check fewer edges");
+      darray_destroy(&p1);
+      darray_destroy(&p2);
+    }
+
+    darray_destroy(&p0);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Directed graphs search the transpose bottom-up", []() {
+    auto edges = graph_gen_rmat(12, 16, 0, 9);
+    auto g = csr_build(size_t(1) << 12, &edges);
+    auto gt = csr_transpose(&g);
+    uint32_t source = pick_source(&g, 3);
+
+    for (size_t threads : {1, 3}) {
+      BfsStats stats;
+      auto parent = bfs(&g, &gt, source, threads, &stats);
+      check_tree(&g, &parent, source);
+      darray_destroy(&parent);
+      parent = bfs_top_down(&g, source, threads);
+      check_tree(&g, &parent, source);
+      darray_destroy(&parent);
+    }
+
+    csr_destroy(&gt);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Uniform random graphs from many sources", []() {
+    auto edges = graph_gen_uniform(5000, 20000, 0, 13);
+    auto g = csr_build_undirected(5000, &edges);
+    for (uint32_t source : {0u, 17u, 4999u}) {
+      auto parent = bfs(&g, &g, source, 4);
+      check_tree(&g, &parent, source);
+      darray_destroy(&parent);
+    }
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Isolated source and sparse graphs", []() {
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{1, 2, 1});
+    auto g = csr_build_undirected(200, &edges);
+    BfsStats stats;
+    auto parent = bfs(&g, &g, 0, 2, &stats);
+    test::assert_equal(size_t(1), stats.reached);
+    test::assert_equal(size_t(1), stats.levels);
+    check_tree(&g, &parent, 0);
+    darray_destroy(&parent);
+
+    parent = bfs(&g, &g, 199, 1);
+    check_tree(&g, &parent, 199);
+    darray_destroy(&parent);
+    parent = bfs(&g, &g, 2, 1);
+    check_tree(&g, &parent, 2);
+    darray_destroy(&parent);
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  // error handling tests
+  suite.add_test("Source out of range", []() {
+    auto edges = darray_create<CsrEdge>();
+    auto g = csr_build(3, &edges);
+    bool caught_serial = false;
+    bool caught_parallel = false;
+
+    try {
+      bfs_serial(&g, 3);
+    } catch (const std::runtime_error& e) {
+      caught_serial = true;
+    }
+    try {
+      bfs(&g, &g, 3);
+    } catch (const std::runtime_error& e) {
+      caught_parallel = true;
+    }
+    test::assert_true(caught_serial, "Expected exception not thrown");
+    test::assert_true(caught_parallel, "Expected exception not thrown");
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Transpose of another graph", []() {
+    auto edges = darray_create<CsrEdge>();
+    auto g = csr_build(3, &edges);
+    auto other = csr_build(4, &edges);
+    bool caught_exception = false;
+
+    try {
+      bfs(&g, &other, 0);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    csr_destroy(&other);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: one search of a Graph500-sized undirected graph (2^20
+  // vertices, 16 edges per vertex) per call. ops is the number of input
+  // edges in the source's component, so ns/op is the inverse of traversed
+  // edges per second (TEPS).
+  test::Benchmark bench("BFS Benchmarks");
+  const unsigned scale = 20;
+  const size_t n = size_t(1) << scale;
+  const size_t all = graph_default_threads();
+  CsrGraph graphs[2];
+
+  for (int rmat : {0, 1}) {
+    auto edges = rmat ? graph_gen_rmat(scale, 16, 0, 1)
+                      : graph_gen_uniform(n, 16 * n);
+    graphs[rmat] = csr_build_undirected(n, &edges);
+    darray_destroy(&edges);
+    const CsrGraph* g = &graphs[rmat];
+    uint32_t source = pick_source(g, 12345);
+
+    // every edge of the component is stored twice
+    BfsStats stats;
+    auto parent = bfs_serial(g, source, &stats);
+    uint64_t component_edges = 0;
+    for (uint32_t v = 0; v < n; ++v) {
+      if (parent.data[v] != BFS_NONE) {
+        component_edges += csr_degree(g, v);
+      }
+    }
+    component_edges /= 2;
+    darray_destroy(&parent);
+    std::string suffix = rmat ? " (RMAT, 2^20)" : " (uniform, 2^20)";
+
+    bench.add_test(
+        "Serial queue" + suffix,
+        [g, source]() {
+          auto p = bfs_serial(g, source);
+          test::do_not_optimize(p.data);
+          darray_destroy(&p);
+        },
+        component_edges);
+
+    std::vector<size_t> thread_counts = {1};
+    if (all > 1) {
+      thread_counts.push_back(all);
+    }
+    for (size_t threads : thread_counts) {
+      std::string label = " x" + std::to_string(threads) + suffix;
+      bench.add_test(
+          "Top-down" + label,
+          [g, source, threads]() {
+            auto p = bfs_top_down(g, source, threads);
+            test::do_not_optimize(p.data);
+            darray_destroy(&p);
+          },
+          component_edges);
+
+      bench.add_test(
+          "Direction-optimizing" + label,
+          [g, source, threads]() {
+            auto p = bfs(g, g, source, threads);
+            test::do_not_optimize(p.data);
+            darray_destroy(&p);
+          },
+          component_edges);
+    }
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  std::cout << "\nTraversed edges per second (median):" << std::endl;
+  for (const test::BenchResult& r : bench.results()) {
+    double mteps = 1e3 * r.ops / r.stats.median;
+    std::cout << "  " << std::fixed << std::setprecision(1) << std::setw(8)
+              << mteps << " MTEPS  " << r.name << std::defaultfloat
+              << std::endl;
+  }
+
+  for (int rmat : {0, 1}) {
+    csr_destroy(&graphs[rmat]);
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "BFS program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,365 @@
+/**
+ * bfs.hpp
+ *
+ * Breadth-first search over a CsrGraph, returning the BFS tree as an array
+ * of parents. bfs_serial is the textbook queue version. bfs runs level by
+ * level on several threads and picks a direction for every level (Beamer
+ * et al., "Direction-Optimizing Breadth-First Search"):
+ *
+ *  - top-down: threads take chunks of the frontier queue and claim each
+ *    unvisited neighbour with a compare-and-swap on its parent
+ *  - bottom-up: threads take chunks of the unvisited vertices and look
+ *    through each one's in-edges for a parent in the frontier, kept as a
+ *    bitmap; the scan stops at the first parent found
+ *
+ * Bottom-up wins once the frontier's edges outnumber those left to explore
+ * by BFS_ALPHA, which on small-world graphs covers the few middle levels
+ * holding most of the vertices; it hands back to top-down once the
+ * frontier shrinks below n / BFS_BETA vertices.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include "../../data_structures/07_graph/csr_graph.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define CACHE_LINE 64 // bytes per cache line
+#define BFS_NONE UINT32_MAX // parent of a vertex not reached
+#define BFS_ALPHA 15        // top-down to bottom-up threshold
+#define BFS_BETA 18         // bottom-up to top-down threshold
+#define BFS_CHUNK 256       // frontier vertices taken by a thread at a time
+#define BFS_WORD_CHUNK 16   // bitmap words taken by a thread at a time
+
+// threads to use when the caller asks for 0
+inline size_t graph_default_threads() {
+  size_t n = std::thread::hardware_concurrency();
+  return n ? n : 1;
+}
+
+// run fn(t) for t in [0, threads), t = 0 on this thread
+template <typename Fn> void graph_run_threads(size_t threads, Fn& fn) {
+  std::vector<std::thread> pool;
+  for (size_t t = 1; t < threads; ++t) {
+    pool.emplace_back(fn, t);
+  }
+  fn(0);
+  for (auto& th : pool) {
+    th.join();
+  }
+}
+
+// threads waiting for each other between phases; the last one to arrive
+// starts a new generation, which releases the rest
+struct GraphBarrier {
+  std::atomic<size_t> arrived{0};
+  std::atomic<size_t> generation{0};
+  size_t threads;
+};
+
+inline void graph_barrier_wait(GraphBarrier* b) {
+  if (b->threads == 1) {
+    return;
+  }
+  size_t gen = b->generation.load(std::memory_order_acquire);
+  if (b->arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == b->threads) {
+    b->arrived.store(0, std::memory_order_relaxed);
+    b->generation.fetch_add(1, std::memory_order_release);
+  } else {
+    while (b->generation.load(std::memory_order_acquire) == gen) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// what a search did
+struct BfsStats {
+  size_t levels;           // frontiers expanded
+  size_t bottom_up_levels; // of which bottom-up
+  size_t reached;          // vertices in the tree, the source included
+  uint64_t edges_checked;  // edges looked at
+};
+
+// one thread's results for a level, on its own cache lines
+struct alignas(CACHE_LINE) BfsWorker {
+  DArray<uint32_t> next;    // vertices found top-down
+  size_t found;             // vertices found
+  uint64_t found_degree;    // their out-degrees
+  uint64_t edges_checked;   // edges looked at
+};
+
+// parent array of n vertices, all unreached
+inline DArray<uint32_t> bfs_parents(size_t n) {
+  DArray<uint32_t> parent = darray_create<uint32_t>(n ? n : 1);
+  parent.sz = n;
+  for (size_t v = 0; v < n; ++v) {
+    parent.data[v] = BFS_NONE;
+  }
+  return parent;
+}
+
+inline void bfs_check_source(const CsrGraph* g, uint32_t source) {
+  if (source >= g->n) {
+    throw std::runtime_error("Source vertex out of range");
+  }
+}
+
+// queue-based search on one thread
+inline DArray<uint32_t> bfs_serial(const CsrGraph* g, uint32_t source,
+                                   BfsStats* stats = nullptr) {
+  bfs_check_source(g, source);
+  DArray<uint32_t> parent = bfs_parents(g->n);
+  DArray<uint32_t> queue = darray_create<uint32_t>(g->n);
+  parent.data[source] = source;
+  queue.data[queue.sz++] = source;
+  uint64_t checked = 0;
+  size_t levels = 0;
+  size_t level_end = 0; // queue index where the next level starts
+  for (size_t head = 0; head < queue.sz; ++head) {
+    if (head == level_end) {
+      levels++;
+      level_end = queue.sz;
+    }
+    uint32_t u = queue.data[head];
+    const uint32_t* t = csr_targets(g, u);
+    size_t d = csr_degree(g, u);
+    checked += d;
+    for (size_t i = 0; i < d; ++i) {
+      if (parent.data[t[i]] == BFS_NONE) {
+        parent.data[t[i]] = u;
+        queue.data[queue.sz++] = t[i];
+      }
+    }
+  }
+  if (stats) {
+    *stats = BfsStats{levels, 0, queue.sz, checked};
+  }
+  darray_destroy(&queue);
+  return parent;
+}
+
+// expand the frontier queue along out-edges into each worker's next list
+inline void bfs_top_down_step(const CsrGraph* g, uint32_t* parent,
+                              const DArray<uint32_t>* frontier,
+                              BfsWorker* workers, size_t threads) {
+  std::atomic<size_t> cursor{0};
+  bool shared = threads > 1;
+  auto work = [&](size_t t) {
+    BfsWorker& w = workers[t];
+    w.next.sz = 0;
+    w.found = w.found_degree = w.edges_checked = 0;
+    for (;;) {
+      size_t begin = cursor.fetch_add(BFS_CHUNK, std::memory_order_relaxed);
+      if (begin >= frontier->sz) {
+        break;
+      }
+      size_t end = std::min(frontier->sz, begin + BFS_CHUNK);
+      for (size_t i = begin; i < end; ++i) {
+        uint32_t u = frontier->data[i];
+        const uint32_t* targets = csr_targets(g, u);
+        size_t d = csr_degree(g, u);
+        w.edges_checked += d;
+        for (size_t j = 0; j < d; ++j) {
+          uint32_t v = targets[j];
+          // parent is a plain array shared by the threads, so claims go
+          // through the atomic builtins; a cheap read filters out most
+          // vertices already taken
+          if (__atomic_load_n(&parent[v], __ATOMIC_RELAXED) != BFS_NONE) {
+            continue;
+          }
+          if (shared) {
+            uint32_t none = BFS_NONE;
+            if (!__atomic_compare_exchange_n(&parent[v], &none, u, false,
+                                             __ATOMIC_RELAXED,
+                                             __ATOMIC_RELAXED)) {
+              continue;
+            }
+          } else {
+            parent[v] = u;
+          }
+          darray_push_back(&w.next, v);
+          w.found_degree += csr_degree(g, v);
+        }
+      }
+    }
+    w.found = w.next.sz;
+  };
+  graph_run_threads(threads, work);
+}
+
+// true if v is set in bitmap
+inline bool bfs_bit(const uint64_t* bitmap, uint32_t v) {
+  return (bitmap[v >> 6] >> (v & 63)) & 1;
+}
+
+// give every unvisited vertex a parent in the frontier bitmap, if one of
+// its in-edges in gt comes from there; found vertices go to next. Each
+// chunk of whole bitmap words belongs to one thread, so neither bitmap
+// nor parent needs atomics.
+inline void bfs_bottom_up_step(const CsrGraph* g, const CsrGraph* gt,
+                               uint32_t* parent, const uint64_t* frontier,
+                               uint64_t* next, BfsWorker* workers,
+                               size_t threads) {
+  size_t words = (g->n + 63) / 64;
+  std::atomic<size_t> cursor{0};
+  auto work = [&](size_t t) {
+    BfsWorker& w = workers[t];
+    w.found = w.found_degree = w.edges_checked = 0;
+    for (;;) {
+      size_t begin =
+          cursor.fetch_add(BFS_WORD_CHUNK, std::memory_order_relaxed);
+      if (begin >= words) {
+        break;
+      }
+      size_t end = std::min(words, begin + BFS_WORD_CHUNK);
+      for (size_t k = begin; k < end; ++k) {
+        uint64_t bits = 0;
+        size_t last = std::min(g->n, 64 * k + 64);
+        for (size_t v = 64 * k; v < last; ++v) {
+          if (parent[v] != BFS_NONE) {
+            continue;
+          }
+          const uint32_t* sources = csr_targets(gt, uint32_t(v));
+          size_t d = csr_degree(gt, uint32_t(v));
+          size_t j = 0;
+          while (j < d && !bfs_bit(frontier, sources[j])) {
+            j++;
+          }
+          w.edges_checked += std::min(j + 1, d);
+          if (j < d) {
+            parent[v] = sources[j];
+            bits |= uint64_t(1) << (v & 63);
+            w.found++;
+            w.found_degree += csr_degree(g, uint32_t(v));
+          }
+        }
+        next[k] = bits;
+      }
+    }
+  };
+  graph_run_threads(threads, work);
+}
+
+// frontier queue to bitmap
+inline void bfs_queue_to_bitmap(const DArray<uint32_t>* queue,
+                                DArray<uint64_t>* bitmap) {
+  memset(bitmap->data, 0, bitmap->sz * sizeof(uint64_t));
+  for (size_t i = 0; i < queue->sz; ++i) {
+    uint32_t v = queue->data[i];
+    bitmap->data[v >> 6] |= uint64_t(1) << (v & 63);
+  }
+}
+
+// frontier bitmap to queue, in vertex order
+inline void bfs_bitmap_to_queue(const DArray<uint64_t>* bitmap,
+                                DArray<uint32_t>* queue) {
+  queue->sz = 0;
+  for (size_t k = 0; k < bitmap->sz; ++k) {
+    for (uint64_t bits = bitmap->data[k]; bits; bits &= bits - 1) {
+      queue->data[queue->sz++] = uint32_t(64 * k + __builtin_ctzll(bits));
+    }
+  }
+}
+
+// level-synchronous search; bottom-up levels are only tried when gt, the
+// transpose of g, is given (pass g itself for an undirected graph)
+inline DArray<uint32_t> bfs_impl(const CsrGraph* g, const CsrGraph* gt,
+                                 uint32_t source, size_t threads,
+                                 BfsStats* stats) {
+  bfs_check_source(g, source);
+  if (gt && gt->n != g->n) {
+    throw std::runtime_error("Transpose has a different vertex count");
+  }
+  if (threads == 0) {
+    threads = graph_default_threads();
+  }
+  size_t n = g->n;
+  size_t words = (n + 63) / 64;
+  DArray<uint32_t> parent = bfs_parents(n);
+  DArray<uint32_t> queue = darray_create<uint32_t>(n);
+  DArray<uint64_t> front = darray_create<uint64_t>(words ? words : 1);
+  DArray<uint64_t> next = darray_create<uint64_t>(words ? words : 1);
+  front.sz = next.sz = words;
+  std::vector<BfsWorker> workers(threads);
+  for (BfsWorker& w : workers) {
+    w.next = darray_create<uint32_t>();
+  }
+
+  parent.data[source] = source;
+  queue.data[queue.sz++] = source;
+  BfsStats s{0, 0, 1, 0};
+  size_t frontier_size = 1;
+  uint64_t frontier_degree = csr_degree(g, source);
+  uint64_t unexplored = csr_num_edges(g) - frontier_degree;
+  bool bottom_up = false;
+  size_t last_size = 0;
+  while (frontier_size > 0) {
+    if (gt && !bottom_up && frontier_degree > unexplored / BFS_ALPHA) {
+      bfs_queue_to_bitmap(&queue, &front);
+      bottom_up = true;
+    } else if (bottom_up && frontier_size < n / BFS_BETA &&
+               frontier_size < last_size) {
+      bfs_bitmap_to_queue(&front, &queue);
+      bottom_up = false;
+    }
+    last_size = frontier_size;
+
+    if (bottom_up) {
+      bfs_bottom_up_step(g, gt, parent.data, front.data, next.data,
+                         workers.data(), threads);
+      std::swap(front, next);
+      s.bottom_up_levels++;
+    } else {
+      bfs_top_down_step(g, parent.data, &queue, workers.data(), threads);
+      queue.sz = 0;
+      for (BfsWorker& w : workers) {
+        memcpy(queue.data + queue.sz, w.next.data,
+               w.next.sz * sizeof(uint32_t));
+        queue.sz += w.next.sz;
+      }
+    }
+    s.levels++;
+    frontier_size = frontier_degree = 0;
+    for (BfsWorker& w : workers) {
+      frontier_size += w.found;
+      frontier_degree += w.found_degree;
+      s.edges_checked += w.edges_checked;
+    }
+    s.reached += frontier_size;
+    unexplored -= frontier_degree;
+  }
+
+  for (BfsWorker& w : workers) {
+    darray_destroy(&w.next);
+  }
+  darray_destroy(&next);
+  darray_destroy(&front);
+  darray_destroy(&queue);
+  if (stats) {
+    *stats = s;
+  }
+  return parent;
+}
+
+// direction-optimizing search from source; gt is the transpose of g, or g
+// itself when g is undirected. threads = 0 uses every core.
+inline DArray<uint32_t> bfs(const CsrGraph* g, const CsrGraph* gt,
+                            uint32_t source, size_t threads = 1,
+                            BfsStats* stats = nullptr) {
+  return bfs_impl(g, gt, source, threads, stats);
+}
+
+// the same search, top-down on every level
+inline DArray<uint32_t> bfs_top_down(const CsrGraph* g, uint32_t source,
+                                     size_t threads = 1,
+                                     BfsStats* stats = nullptr) {
+  return bfs_impl(g, nullptr, source, threads, stats);
+}
@@ -0,0 +1,253 @@
+/**
+ * floyd_warshall.cpp
+ *
+ * Floyd-Warshall tests, and benchmarks of the naive and blocked versions
+ * reported in billions of min-plus updates per second.
+ */
+
+#include "floyd_warshall.hpp"
+#include "../../data_structures/07_graph/graph_gen.hpp"
+#include "sssp.hpp"
+#include "testing.hpp"
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// true if both matrices hold the same n x n distances
+template <typename T>
+bool same_matrix(const FwMatrix<T>* a, const FwMatrix<T>* b) {
+  if (a->n != b->n) {
+    return false;
+  }
+  for (size_t i = 0; i < a->n; ++i) {
+    for (size_t j = 0; j < a->n; ++j) {
+      if (fw_get(a, i, j) != fw_get(b, i, j)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// a copy of m with its own storage
+template <typename T> FwMatrix<T> fw_copy(const FwMatrix<T>* m) {
+  FwMatrix<T> out = fw_create<T>(m->n);
+  memcpy(out.data, m->data, m->stride * m->stride * sizeof(T));
+  return out;
+}
+
+// n x n matrix with random weights on `density` percent of the pairs
+FwMatrix<int32_t> random_matrix(size_t n, int density, int lo, int hi,
+                                test::RandomGenerator& gen) {
+  FwMatrix<int32_t> m = fw_create<int32_t>(n);
+  auto coin = gen.generate_ints(n * n, 0, 99);
+  auto weight = gen.generate_ints(n * n, lo, hi);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      if (i != j && coin[i * n + j] < density) {
+        fw_set(&m, i, j, weight[i * n + j]);
+      }
+    }
+  }
+  return m;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Floyd-Warshall Tests");
+
+  suite.add_test("Small graph", []() {
+    auto m = fw_create<int32_t>(4);
+    fw_set(&m, 0, 1, 5);
+    fw_set(&m, 1, 2, 2);
+    fw_set(&m, 0, 2, 9);
+    fw_set(&m, 2, 0, 1);
+    floyd_warshall(&m);
+
+    test::assert_equal(7, fw_get(&m, 0, 2));
+    test::assert_equal(3, fw_get(&m, 1, 0));
+    test::assert_equal(0, fw_get(&m, 3, 3));
+    test::assert_equal(fw_inf<int32_t>(), fw_get(&m, 0, 3));
+    test::assert_equal(fw_inf<int32_t>(), fw_get(&m, 3, 0));
+
+    fw_destroy(&m);
+  });
+
+  suite.add_test("Blocked matches naive across tile boundaries", []() {
+    test::RandomGenerator gen;
+    // below, at and just past whole tiles
+    for (size_t n : {1, 17, 64, 65, 150, 200}) {
+      for (int density : {5, 40}) {
+        auto naive = random_matrix(n, density, 1, 100, gen);
+        auto blocked = fw_copy(&naive);
+        auto threaded = fw_copy(&naive);
+        floyd_warshall_naive(&naive);
+        floyd_warshall(&blocked);
+        floyd_warshall(&threaded, 4);
+        test::assert_true(same_matrix(&naive, &blocked), "Blocked differs");
+        test::assert_true(same_matrix(&naive, &threaded), "Threads differ");
+        fw_destroy(&threaded);
+        fw_destroy(&blocked);
+        fw_destroy(&naive);
+      }
+    }
+  });
+
+  suite.add_test("Negative weights without negative cycles", []() {
+    // a DAG (edges only from lower to higher ids) cannot hold a cycle
+    test::RandomGenerator gen;
+    auto naive = random_matrix(130, 20, -50, 50, gen);
+    for (size_t i = 0; i < 130; ++i) {
+      for (size_t j = 0; j < i; ++j) {
+        fw_set(&naive, i, j, fw_inf<int32_t>());
+      }
+    }
+    auto blocked = fw_copy(&naive);
+    floyd_warshall_naive(&naive);
+    floyd_warshall(&blocked, 3);
+    test::assert_true(same_matrix(&naive, &blocked), "Blocked differs");
+    test::assert_false(fw_has_negative_cycle(&blocked));
+    test::assert_equal(fw_inf<int32_t>(), fw_get(&blocked, 129, 0));
+
+    fw_destroy(&blocked);
+    fw_destroy(&naive);
+  });
+
+  suite.add_test("Negative cycle detection", []() {
+    auto m = fw_create<int32_t>(3);
+    fw_set(&m, 0, 1, 1);
+    fw_set(&m, 1, 2, -3);
+    fw_set(&m, 2, 0, 1);
+    floyd_warshall(&m);
+    test::assert_true(fw_has_negative_cycle(&m));
+
+    fw_destroy(&m);
+  });
+
+  suite.add_test("Floating distances", []() {
+    auto m = fw_create<float>(70);
+    for (size_t i = 0; i + 1 < 70; ++i) {
+      fw_set(&m, i, i + 1, 0.5f);
+    }
+    floyd_warshall(&m, 2);
+    test::assert_equal(34.5f, fw_get(&m, 0, 69));
+    test::assert_equal(fw_inf<float>(), fw_get(&m, 69, 0));
+
+    fw_destroy(&m);
+  });
+
+  suite.add_test("Graph rows match Dijkstra", []() {
+    auto edges = graph_gen_rmat(8, 8, 100, 31);
+    auto g = csr_build(256, &edges, true);
+    auto m = fw_from_graph<int64_t>(&g);
+    floyd_warshall(&m, 2);
+    for (uint32_t source : {0u, 100u, 255u}) {
+      auto dist = dijkstra(&g, source);
+      for (uint32_t v = 0; v < 256; ++v) {
+        int64_t want = dist.data[v] == SSSP_INF ? fw_inf<int64_t>()
+                                                : int64_t(dist.data[v]);
+        test::assert_equal(want, fw_get(&m, source, v));
+      }
+      darray_destroy(&dist);
+    }
+
+    fw_destroy(&m);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  // error handling tests
+  suite.add_test("Matrix from an unweighted graph", []() {
+    auto edges = graph_gen_uniform(10, 20);
+    auto g = csr_build(10, &edges);
+    bool caught_exception = false;
+
+    try {
+      fw_from_graph<int32_t>(&g);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: all pairs of a uniform random graph with 8 edges per
+  // vertex and int32 weights in [1, 1000]. Each call copies the edge
+  // matrix in first; ops is n^3 min-plus updates (two operations each).
+  test::Benchmark bench("Floyd-Warshall Benchmarks");
+  const size_t all = graph_default_threads();
+  std::vector<size_t> thread_counts = {1};
+  if (all > 1) {
+    thread_counts.push_back(all);
+  }
+
+  std::vector<FwMatrix<int32_t>> inputs;
+  for (size_t n : {1024, 2048}) {
+    auto edges = graph_gen_uniform(n, 8 * n, 1000, n);
+    auto g = csr_build(n, &edges, true);
+    inputs.push_back(fw_from_graph<int32_t>(&g));
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  }
+
+  for (const FwMatrix<int32_t>& input : inputs) {
+    size_t n = input.n;
+    size_t ops = n * n * n;
+    std::string suffix = " (" + std::to_string(n) + " vertices)";
+    const FwMatrix<int32_t>* in = &input;
+
+    // the naive loop takes several seconds a call past a thousand
+    if (n <= 1024) {
+      bench.add_test(
+          "Naive" + suffix,
+          [in]() {
+            auto m = fw_copy(in);
+            floyd_warshall_naive(&m);
+            test::do_not_optimize(m.data);
+            fw_destroy(&m);
+          },
+          ops);
+    }
+
+    for (size_t threads : thread_counts) {
+      bench.add_test(
+          "Blocked x" + std::to_string(threads) + suffix,
+          [in, threads]() {
+            auto m = fw_copy(in);
+            floyd_warshall(&m, threads);
+            test::do_not_optimize(m.data);
+            fw_destroy(&m);
+          },
+          ops);
+    }
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  std::cout << "\nMin-plus updates per second (median):" << std::endl;
+  for (const test::BenchResult& r : bench.results()) {
+    double gups = r.ops / r.stats.median;
+    std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(7)
+              << gups << " G/s (" << 2 * gups << " GFLOP-equivalent)  "
+              << r.name << std::defaultfloat << std::endl;
+  }
+
+  for (FwMatrix<int32_t>& input : inputs) {
+    fw_destroy(&input);
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Floyd-Warshall program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
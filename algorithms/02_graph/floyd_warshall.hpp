@@ -0,0 +1,239 @@
+/**
+ * floyd_warshall.hpp
+ *
+ * All-pairs shortest paths over a dense distance matrix stored in one
+ * row-major allocation, padded to a whole number of FW_BLOCK x FW_BLOCK
+ * tiles. floyd_warshall_naive is the textbook triple loop, which streams
+ * the whole matrix from memory once per k. floyd_warshall is the blocked
+ * version (Venkataraman et al.): for each diagonal tile kb it
+ *
+ *  1. runs the triple loop inside tile (kb, kb)
+ *  2. updates the tiles in row kb and column kb from it
+ *  3. updates every other tile (i, j) from tiles (i, kb) and (kb, j)
+ *
+ * so each step works on three tiles that sit in cache. The tiles of
+ * phases 2 and 3 are independent and are shared out across threads, and
+ * the inner loop is a min of sums along a row that the compiler turns
+ * into vector instructions.
+ */
+
+#pragma once
+
+#include "bfs.hpp"
+#include "../../data_structures/07_graph/csr_graph.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#define FW_BLOCK 64 // tile side; three int32 tiles take 48 KiB
+
+template <typename T> struct FwMatrix {
+  T* data;       // row i starts at data + i * stride
+  size_t n;      // vertices
+  size_t stride; // n rounded up to a multiple of FW_BLOCK
+};
+
+// distance standing for "no path": infinity for floating types, half the
+// largest value for integers so adding two of them cannot overflow
+template <typename T> constexpr T fw_inf() {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::numeric_limits<T>::infinity();
+  } else {
+    return std::numeric_limits<T>::max() / 2;
+  }
+}
+
+// n x n matrix with no edges: 0 on the diagonal, fw_inf elsewhere,
+// padding included
+template <typename T> FwMatrix<T> fw_create(size_t n) {
+  size_t stride = (n + FW_BLOCK - 1) / FW_BLOCK * FW_BLOCK;
+  size_t bytes = std::max<size_t>(stride * stride * sizeof(T), CACHE_LINE);
+  T* data = static_cast<T*>(std::aligned_alloc(CACHE_LINE, bytes));
+  if (!data) {
+    throw std::bad_alloc();
+  }
+  std::fill(data, data + stride * stride, fw_inf<T>());
+  for (size_t i = 0; i < stride; ++i) {
+    data[i * stride + i] = T(0);
+  }
+  return FwMatrix<T>{data, n, stride};
+}
+
+template <typename T> void fw_destroy(FwMatrix<T>* m) {
+  std::free(m->data);
+  m->data = nullptr;
+  m->n = m->stride = 0;
+}
+
+template <typename T> T fw_get(const FwMatrix<T>* m, size_t i, size_t j) {
+  return m->data[i * m->stride + j];
+}
+
+template <typename T> void fw_set(FwMatrix<T>* m, size_t i, size_t j, T d) {
+  m->data[i * m->stride + j] = d;
+}
+
+// matrix of a weighted graph's edges, keeping the lightest of parallel
+// edges; self loops never beat the 0 on the diagonal
+template <typename T> FwMatrix<T> fw_from_graph(const CsrGraph* g) {
+  if (!csr_weighted(g) && csr_num_edges(g) > 0) {
+    throw std::runtime_error("Graph has no weights");
+  }
+  FwMatrix<T> m = fw_create<T>(g->n);
+  for (uint32_t u = 0; u < g->n; ++u) {
+    const uint32_t* targets = csr_targets(g, u);
+    const uint32_t* weights = csr_weights(g, u);
+    for (size_t i = 0, deg = csr_degree(g, u); i < deg; ++i) {
+      T* cell = m.data + u * m.stride + targets[i];
+      *cell = std::min(*cell, T(weights[i]));
+    }
+  }
+  return m;
+}
+
+// with negative weights a missing path can pick up a negative sum and
+// drift below fw_inf; put anything past half of it back
+template <typename T> void fw_normalize(FwMatrix<T>* m) {
+  if constexpr (std::is_signed_v<T> && !std::is_floating_point_v<T>) {
+    for (size_t i = 0; i < m->n; ++i) {
+      T* row = m->data + i * m->stride;
+      for (size_t j = 0; j < m->n; ++j) {
+        row[j] = row[j] > fw_inf<T>() / 2 ? fw_inf<T>() : row[j];
+      }
+    }
+  }
+}
+
+// true if some vertex reaches itself at negative cost
+template <typename T> bool fw_has_negative_cycle(const FwMatrix<T>* m) {
+  for (size_t i = 0; i < m->n; ++i) {
+    if (fw_get(m, i, i) < T(0)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// textbook O(n^3) all-pairs shortest paths
+template <typename T> void floyd_warshall_naive(FwMatrix<T>* m) {
+  size_t n = m->n;
+  size_t s = m->stride;
+  for (size_t k = 0; k < n; ++k) {
+    const T* row_k = m->data + k * s;
+    for (size_t i = 0; i < n; ++i) {
+      T* row_i = m->data + i * s;
+      T d_ik = row_i[k];
+      for (size_t j = 0; j < n; ++j) {
+        row_i[j] = std::min(row_i[j], d_ik + row_k[j]);
+      }
+    }
+  }
+  fw_normalize(m);
+}
+
+// relax tile c through k in [0, FW_BLOCK) using tiles a (rows of c,
+// columns k) and b (rows k, columns of c). Any of them may be the same
+// tile, as in phases 1 and 2, which keeps k outermost.
+template <typename T>
+void fw_tile_shared(T* c, const T* a, const T* b, size_t s) {
+  for (size_t k = 0; k < FW_BLOCK; ++k) {
+    const T* b_k = b + k * s;
+    for (size_t i = 0; i < FW_BLOCK; ++i) {
+      T* c_i = c + i * s;
+      T a_ik = a[i * s + k];
+      for (size_t j = 0; j < FW_BLOCK; ++j) {
+        c_i[j] = std::min(c_i[j], a_ik + b_k[j]);
+      }
+    }
+  }
+}
+
+// the same for a tile c apart from a and b (phase 3): nothing c holds is
+// read through a or b, so each row of c can take every k in turn while
+// it stays in registers and L1
+template <typename T>
+void fw_tile(T* __restrict c, const T* __restrict a, const T* __restrict b,
+             size_t s) {
+  for (size_t i = 0; i < FW_BLOCK; ++i) {
+    T* __restrict c_i = c + i * s;
+    for (size_t k = 0; k < FW_BLOCK; ++k) {
+      const T* __restrict b_k = b + k * s;
+      T a_ik = a[i * s + k];
+      for (size_t j = 0; j < FW_BLOCK; ++j) {
+        c_i[j] = std::min(c_i[j], a_ik + b_k[j]);
+      }
+    }
+  }
+}
+
+// blocked, multithreaded all-pairs shortest paths; threads = 0 uses every
+// core
+template <typename T>
+void floyd_warshall(FwMatrix<T>* m, size_t threads = 1) {
+  if (threads == 0) {
+    threads = graph_default_threads();
+  }
+  size_t s = m->stride;
+  size_t nb = s / FW_BLOCK;
+  T* d = m->data;
+  auto tile = [d, s](size_t bi, size_t bj) {
+    return d + bi * FW_BLOCK * s + bj * FW_BLOCK;
+  };
+  GraphBarrier barrier;
+  barrier.threads = threads;
+  // next unclaimed tile of the current phase, one counter per phase so a
+  // phase never has to be reset while threads may still be reading it
+  std::atomic<size_t> cursor[2] = {{0}, {0}};
+
+  auto work = [&](size_t t) {
+    for (size_t kb = 0; kb < nb; ++kb) {
+      T* diag = tile(kb, kb);
+      if (t == 0) {
+        fw_tile_shared(diag, diag, diag, s);
+      }
+      graph_barrier_wait(&barrier);
+
+      // row kb and column kb: tiles 0 .. nb-1 of each, skipping kb
+      for (size_t x; (x = cursor[0].fetch_add(1)) < 2 * nb;) {
+        size_t other = x % nb;
+        if (other == kb) {
+          continue;
+        }
+        if (x < nb) {
+          T* c = tile(kb, other);
+          fw_tile_shared(c, diag, c, s);
+        } else {
+          T* c = tile(other, kb);
+          fw_tile_shared(c, c, diag, s);
+        }
+      }
+      graph_barrier_wait(&barrier);
+
+      // every tile outside row and column kb
+      if (t == 0) {
+        cursor[0].store(0, std::memory_order_relaxed);
+      }
+      for (size_t x; (x = cursor[1].fetch_add(1)) < nb * nb;) {
+        size_t bi = x / nb;
+        size_t bj = x % nb;
+        if (bi == kb || bj == kb) {
+          continue;
+        }
+        fw_tile(tile(bi, bj), tile(bi, kb), tile(kb, bj), s);
+      }
+      graph_barrier_wait(&barrier);
+      if (t == 0) {
+        cursor[1].store(0, std::memory_order_relaxed);
+      }
+    }
+  };
+  graph_run_threads(threads, work);
+  fw_normalize(m);
+}
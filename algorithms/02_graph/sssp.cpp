@@ -0,0 +1,282 @@
+/**
+ * sssp.cpp
+ *
+ * Shortest path tests, and benchmarks of Dijkstra, Bellman-Ford and
+ * delta-stepping on road-like grid graphs and power-law RMAT graphs.
+ */
+
+#include "sssp.hpp"
+#include "../../data_structures/07_graph/graph_gen.hpp"
+#include "testing.hpp"
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// true if both distance arrays agree everywhere
+bool same_distances(const DArray<uint64_t>* a, const DArray<uint64_t>* b) {
+  if (a->sz != b->sz) {
+    return false;
+  }
+  for (size_t v = 0; v < a->sz; ++v) {
+    if (a->data[v] != b->data[v]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// every search from source agrees with Dijkstra
+void check_all(const CsrGraph* g, uint32_t source) {
+  auto ref = dijkstra(g, source);
+  auto bf = bellman_ford(g, source);
+  test::assert_true(same_distances(&ref, &bf), "Bellman-Ford differs");
+  darray_destroy(&bf);
+  for (uint64_t delta : {uint64_t(0), uint64_t(1), uint64_t(1) << 40}) {
+    for (size_t threads : {1, 4}) {
+      auto ds = delta_stepping(g, source, delta, threads);
+      test::assert_true(same_distances(&ref, &ds), "Delta-stepping differs");
+      darray_destroy(&ds);
+    }
+  }
+  darray_destroy(&ref);
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Shortest Path Tests");
+
+  suite.add_test("Small directed graph", []() {
+    // the direct edge 0 -> 3 is longer than 0 -> 1 -> 2 -> 3
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{0, 3, 10});
+    darray_push_back(&edges, CsrEdge{0, 1, 2});
+    darray_push_back(&edges, CsrEdge{1, 2, 3});
+    darray_push_back(&edges, CsrEdge{2, 3, 1});
+    darray_push_back(&edges, CsrEdge{3, 0, 1});
+    darray_push_back(&edges, CsrEdge{4, 0, 1});
+    auto g = csr_build(5, &edges, true);
+
+    auto dist = dijkstra(&g, 0);
+    test::assert_equal(uint64_t(0), dist.data[0]);
+    test::assert_equal(uint64_t(2), dist.data[1]);
+    test::assert_equal(uint64_t(5), dist.data[2]);
+    test::assert_equal(uint64_t(6), dist.data[3]);
+    test::assert_equal(SSSP_INF, dist.data[4]);
+    check_all(&g, 0);
+    check_all(&g, 4);
+
+    darray_destroy(&dist);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Zero weights and parallel edges", []() {
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{0, 1, 0});
+    darray_push_back(&edges, CsrEdge{1, 2, 7});
+    darray_push_back(&edges, CsrEdge{1, 2, 4});
+    darray_push_back(&edges, CsrEdge{2, 2, 0});
+    auto g = csr_build(3, &edges, true);
+
+    auto dist = delta_stepping(&g, 0, 1, 2);
+    test::assert_equal(uint64_t(0), dist.data[1]);
+    test::assert_equal(uint64_t(4), dist.data[2]);
+    check_all(&g, 0);
+
+    darray_destroy(&dist);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Bellman-Ford rounds follow the hop count", []() {
+    // a path 0 - 1 - ... - 99 in reverse id order takes a round per hop
+    auto edges = darray_create<CsrEdge>();
+    for (uint32_t v = 99; v > 0; --v) {
+      darray_push_back(&edges, CsrEdge{v, v - 1, 1});
+    }
+    auto g = csr_build(100, &edges, true);
+    size_t rounds = 0;
+    auto dist = bellman_ford(&g, 99, &rounds);
+    test::assert_equal(uint64_t(99), dist.data[0]);
+    // one round per edge, plus one that changes nothing
+    test::assert_equal(size_t(100), rounds);
+
+    darray_destroy(&dist);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Random graphs agree with Dijkstra", []() {
+    auto uniform = graph_gen_uniform(3000, 15000, 1000, 21);
+    auto g1 = csr_build(3000, &uniform, true);
+    check_all(&g1, 0);
+    check_all(&g1, 2999);
+
+    auto rmat = graph_gen_rmat(12, 8, 100, 22);
+    auto g2 = csr_build_undirected(size_t(1) << 12, &rmat, true);
+    check_all(&g2, 5);
+
+    auto grid = graph_gen_grid(40, 60, 50, 23);
+    auto g3 = csr_build_undirected(40 * 60, &grid, true);
+    check_all(&g3, 0);
+    check_all(&g3, 1234);
+
+    csr_destroy(&g3);
+    csr_destroy(&g2);
+    csr_destroy(&g1);
+    darray_destroy(&grid);
+    darray_destroy(&rmat);
+    darray_destroy(&uniform);
+  });
+
+  suite.add_test("Small delta with heavy edges", []() {
+    // buckets of width 1 up to distance 4e9; the search must not keep a
+    // bin per bucket
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{0, 1, 4000000000u});
+    auto g = csr_build(2, &edges, true);
+    for (size_t threads : {1, 2}) {
+      auto dist = delta_stepping(&g, 0, 1, threads);
+      test::assert_equal(uint64_t(4000000000u), dist.data[1]);
+      darray_destroy(&dist);
+    }
+
+    // weights spread over many windows of the bucket ring
+    auto uniform = graph_gen_uniform(2000, 8000, 4000000000u, 24);
+    auto g2 = csr_build(2000, &uniform, true);
+    check_all(&g2, 0);
+
+    csr_destroy(&g2);
+    darray_destroy(&uniform);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Default bucket width", []() {
+    auto grid = graph_gen_grid(10, 10, 400, 4);
+    auto g = csr_build_undirected(100, &grid, true);
+    // mean weight about 200 over mean degree 3
+    uint64_t delta = sssp_default_delta(&g);
+    test::assert_true(delta > 30 && delta < 150, "Unexpected delta");
+
+    csr_destroy(&g);
+    darray_destroy(&grid);
+  });
+
+  // error handling tests
+  suite.add_test("Unweighted graph", []() {
+    auto edges = graph_gen_uniform(10, 20);
+    auto g = csr_build(10, &edges);
+    bool caught_exception = false;
+
+    try {
+      dijkstra(&g, 0);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Source out of range", []() {
+    auto edges = graph_gen_uniform(10, 20, 5);
+    auto g = csr_build(10, &edges, true);
+    bool caught_bf = false;
+    bool caught_delta = false;
+
+    try {
+      bellman_ford(&g, 10);
+    } catch (const std::runtime_error& e) {
+      caught_bf = true;
+    }
+    try {
+      delta_stepping(&g, 10);
+    } catch (const std::runtime_error& e) {
+      caught_delta = true;
+    }
+    test::assert_true(caught_bf, "Expected exception not thrown");
+    test::assert_true(caught_delta, "Expected exception not thrown");
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: one search per call from the first vertex with an edge
+  // in an undirected graph with weights in [1, 1000]; ops counts stored
+  // (directed) edges
+  test::Benchmark bench("Shortest Path Benchmarks");
+  const size_t all = graph_default_threads();
+  std::vector<size_t> thread_counts = {1};
+  if (all > 1) {
+    thread_counts.push_back(all);
+  }
+
+  auto grid = graph_gen_grid(512, 512, 1000, 1);
+  auto rmat = graph_gen_rmat(18, 16, 1000, 1);
+  CsrGraph graphs[2] = {csr_build_undirected(512 * 512, &grid, true),
+                        csr_build_undirected(size_t(1) << 18, &rmat, true)};
+  const char* names[2] = {" (road-like 512x512 grid)",
+                          " (power-law RMAT, 2^18 vertices)"};
+  darray_destroy(&grid);
+  darray_destroy(&rmat);
+
+  for (int i : {0, 1}) {
+    const CsrGraph* g = &graphs[i];
+    std::string suffix = names[i];
+    size_t m = csr_num_edges(g);
+    uint32_t source = 0;
+    while (csr_degree(g, source) == 0) {
+      source++;
+    }
+    uint64_t delta = sssp_default_delta(g);
+
+    bench.add_test(
+        "Dijkstra" + suffix,
+        [g, source]() {
+          auto dist = dijkstra(g, source);
+          test::do_not_optimize(dist.data);
+          darray_destroy(&dist);
+        },
+        m);
+
+    bench.add_test(
+        "Bellman-Ford" + suffix,
+        [g, source]() {
+          auto dist = bellman_ford(g, source);
+          test::do_not_optimize(dist.data);
+          darray_destroy(&dist);
+        },
+        m);
+
+    for (size_t threads : thread_counts) {
+      bench.add_test(
+          "Delta-stepping x" + std::to_string(threads) + suffix,
+          [g, source, delta, threads]() {
+            auto dist = delta_stepping(g, source, delta, threads);
+            test::do_not_optimize(dist.data);
+            darray_destroy(&dist);
+          },
+          m);
+    }
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  for (int i : {0, 1}) {
+    csr_destroy(&graphs[i]);
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Shortest path program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
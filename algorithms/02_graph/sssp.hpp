@@ -0,0 +1,339 @@
+/**
+ * sssp.hpp
+ *
+ * Single-source shortest paths over a weighted CsrGraph. Weights are
+ * unsigned, so there are no negative cycles to detect; distances are
+ * uint64_t, SSSP_INF for vertices the source cannot reach.
+ *
+ *  - dijkstra settles vertices in order of distance using an indexed
+ *    4-ary heap with decrease-key
+ *  - bellman_ford relaxes the out-edges of every vertex whose distance
+ *    changed in the previous round, until a round changes nothing
+ *  - delta_stepping settles distances a bucket of width delta at a time,
+ *    after Meyer and Sanders but without their light/heavy edge split:
+ *    each round relaxes every out-edge of every vertex in the current
+ *    bucket in parallel, and vertices improved back into that bucket are
+ *    relaxed again, all their edges included, in the next round until
+ *    none are. (Deferring edges heavier than delta to one pass per bucket
+ *    cost a round and a second adjacency scan per bucket, and measured
+ *    slower on the benchmark graphs.) Improved vertices go to per-thread
+ *    bins: a ring covering the buckets one edge can reach (at most
+ *    SSSP_BUCKETS), with an overflow list for anything further. The
+ *    threads stay up for the whole search and meet at a barrier between
+ *    rounds.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include "../../data_structures/06_heap/indexed_heap.hpp"
+#include "../../data_structures/07_graph/csr_graph.hpp"
+#include "bfs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define SSSP_INF UINT64_MAX // distance of a vertex not reached
+#define SSSP_CHUNK 64       // frontier vertices taken by a thread at a time
+#define SSSP_BUCKETS 1024   // most bins in a delta-stepping ring (power of 2)
+
+// distance array of n vertices, all unreached
+inline DArray<uint64_t> sssp_distances(size_t n) {
+  DArray<uint64_t> dist = darray_create<uint64_t>(n ? n : 1);
+  dist.sz = n;
+  for (size_t v = 0; v < n; ++v) {
+    dist.data[v] = SSSP_INF;
+  }
+  return dist;
+}
+
+inline void sssp_check(const CsrGraph* g, uint32_t source) {
+  if (!csr_weighted(g) && csr_num_edges(g) > 0) {
+    throw std::runtime_error("Graph has no weights");
+  }
+  bfs_check_source(g, source);
+}
+
+// heap-based Dijkstra, O((n + m) log n)
+inline DArray<uint64_t> dijkstra(const CsrGraph* g, uint32_t source) {
+  sssp_check(g, source);
+  DArray<uint64_t> dist = sssp_distances(g->n);
+  auto heap = iheap_create<uint64_t, 4>(g->n);
+  dist.data[source] = 0;
+  iheap_push(&heap, source, uint64_t(0));
+  while (!iheap_empty(&heap)) {
+    auto [d, id] = iheap_pop(&heap);
+    uint32_t u = uint32_t(id);
+    const uint32_t* targets = csr_targets(g, u);
+    const uint32_t* weights = csr_weights(g, u);
+    for (size_t i = 0, deg = csr_degree(g, u); i < deg; ++i) {
+      uint64_t nd = d + weights[i];
+      uint32_t v = targets[i];
+      if (nd < dist.data[v]) {
+        // a vertex still waiting is in the heap under its old distance
+        if (dist.data[v] == SSSP_INF) {
+          iheap_push(&heap, v, nd);
+        } else {
+          iheap_decrease_key(&heap, v, nd);
+        }
+        dist.data[v] = nd;
+      }
+    }
+  }
+  iheap_destroy(&heap);
+  return dist;
+}
+
+// round-based Bellman-Ford, O(n m) in the worst case but only as many
+// rounds as the longest shortest path has edges; a round only revisits
+// vertices whose distance changed in the one before
+inline DArray<uint64_t> bellman_ford(const CsrGraph* g, uint32_t source,
+                                     size_t* rounds = nullptr) {
+  sssp_check(g, source);
+  DArray<uint64_t> dist = sssp_distances(g->n);
+  DArray<char> active = darray_create<char>(g->n ? g->n : 1);
+  DArray<char> next = darray_create<char>(g->n ? g->n : 1);
+  active.sz = next.sz = g->n;
+  std::fill(active.data, active.data + g->n, 0);
+  std::fill(next.data, next.data + g->n, 0);
+  dist.data[source] = 0;
+  active.data[source] = 1;
+  size_t r = 0;
+  for (bool changed = true; changed; ++r) {
+    changed = false;
+    for (uint32_t u = 0; u < g->n; ++u) {
+      if (!active.data[u]) {
+        continue;
+      }
+      active.data[u] = 0;
+      const uint32_t* targets = csr_targets(g, u);
+      const uint32_t* weights = csr_weights(g, u);
+      for (size_t i = 0, deg = csr_degree(g, u); i < deg; ++i) {
+        uint64_t nd = dist.data[u] + weights[i];
+        if (nd < dist.data[targets[i]]) {
+          dist.data[targets[i]] = nd;
+          next.data[targets[i]] = 1;
+          changed = true;
+        }
+      }
+    }
+    std::swap(active, next);
+  }
+  darray_destroy(&next);
+  darray_destroy(&active);
+  if (rounds) {
+    *rounds = r;
+  }
+  return dist;
+}
+
+// bucket width that suits the graph: the mean weight divided by the mean
+// degree, so a bucket holds a few hops of short edges
+inline uint64_t sssp_default_delta(const CsrGraph* g) {
+  size_t m = csr_num_edges(g);
+  if (m == 0 || g->n == 0) {
+    return 1;
+  }
+  uint64_t total = 0;
+  for (size_t e = 0; e < m; ++e) {
+    total += g->weights.data[e];
+  }
+  uint64_t degree = std::max<uint64_t>(1, m / g->n);
+  return std::max<uint64_t>(1, total / m / degree);
+}
+
+// one thread's bins of improved vertices. Bucket b lives in
+// ring[b % ring.size()] while it is within ring.size() of the current
+// bucket, and in far otherwise.
+struct alignas(CACHE_LINE) SsspWorker {
+  std::vector<DArray<uint32_t>> ring;
+  DArray<uint32_t> far;
+  uint64_t far_min; // least bucket pushed to far, or UINT64_MAX
+  uint64_t lowest;  // first non-empty ring bucket after the current
+};
+
+// lower dist[v] to nd if that is an improvement; true if it was
+inline bool sssp_relax(uint64_t* dist, uint32_t v, uint64_t nd, bool shared) {
+  if (!shared) {
+    if (nd < dist[v]) {
+      dist[v] = nd;
+      return true;
+    }
+    return false;
+  }
+  uint64_t old = __atomic_load_n(&dist[v], __ATOMIC_RELAXED);
+  while (nd < old) {
+    if (__atomic_compare_exchange_n(&dist[v], &old, nd, true,
+                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// parallel delta-stepping; delta = 0 picks sssp_default_delta and
+// threads = 0 uses every core
+inline DArray<uint64_t> delta_stepping(const CsrGraph* g, uint32_t source,
+                                       uint64_t delta = 0,
+                                       size_t threads = 1) {
+  sssp_check(g, source);
+  if (delta == 0) {
+    delta = sssp_default_delta(g);
+  }
+  if (threads == 0) {
+    threads = graph_default_threads();
+  }
+  uint64_t max_weight = 0;
+  for (size_t e = 0; e < csr_num_edges(g); ++e) {
+    max_weight = std::max<uint64_t>(max_weight, g->weights.data[e]);
+  }
+  // one edge reaches at most max_weight / delta + 1 buckets further; a
+  // power of two, so finding a bucket's slot is a mask
+  size_t slots = 2;
+  while (slots < SSSP_BUCKETS && slots < max_weight / delta + 2) {
+    slots *= 2;
+  }
+
+  DArray<uint64_t> dist = sssp_distances(g->n);
+  uint64_t* d = dist.data;
+  DArray<uint32_t> frontier = darray_create<uint32_t>();
+  std::vector<SsspWorker> workers(threads);
+  for (SsspWorker& w : workers) {
+    w.ring.resize(slots);
+    for (DArray<uint32_t>& bin : w.ring) {
+      bin = darray_create<uint32_t>();
+    }
+    w.far = darray_create<uint32_t>();
+    w.far_min = UINT64_MAX;
+  }
+  GraphBarrier barrier;
+  barrier.threads = threads;
+  std::atomic<size_t> cursor{0};
+  uint64_t bucket = 0; // written by thread 0 between barriers
+  bool done = false;
+  bool shared = threads > 1;
+
+  d[source] = 0;
+  darray_push_back(&frontier, source);
+
+  // file v, just improved to nd, in w's bins
+  auto bin_push = [&](SsspWorker& w, uint32_t v, uint64_t nd) {
+    uint64_t b = nd / delta;
+    if (b - bucket < slots) {
+      darray_push_back(&w.ring[b & (slots - 1)], v);
+    } else {
+      darray_push_back(&w.far, v);
+      w.far_min = std::min(w.far_min, b);
+    }
+  };
+
+  // move to the lowest non-empty bucket, or finish (thread 0 only)
+  auto next_bucket = [&]() {
+    uint64_t next = UINT64_MAX;
+    uint64_t far_min = UINT64_MAX;
+    for (const SsspWorker& other : workers) {
+      next = std::min(next, other.lowest);
+      far_min = std::min(far_min, other.far_min);
+    }
+    next = std::min(next, far_min);
+    if (next == UINT64_MAX) {
+      done = true;
+      return;
+    }
+    bucket = next;
+    if (far_min - next < slots) {
+      // the ring is about to cover buckets held in far: refile them,
+      // dropping entries whose vertex has since settled
+      for (SsspWorker& other : workers) {
+        DArray<uint32_t> far = other.far;
+        other.far = darray_create<uint32_t>();
+        other.far_min = UINT64_MAX;
+        for (size_t i = 0; i < far.sz; ++i) {
+          uint64_t dv = d[far.data[i]];
+          if (dv / delta >= next) {
+            bin_push(other, far.data[i], dv);
+          }
+        }
+        darray_destroy(&far);
+      }
+    }
+    for (SsspWorker& other : workers) {
+      DArray<uint32_t>& bin = other.ring[next & (slots - 1)];
+      darray_append(&frontier, bin.data, bin.data + bin.sz);
+      bin.sz = 0;
+    }
+  };
+
+  auto work = [&](size_t t) {
+    SsspWorker& w = workers[t];
+    for (;;) {
+      // relax the out-edges of the current bucket's vertices
+      uint64_t lo = bucket * delta;
+      for (;;) {
+        size_t begin = cursor.fetch_add(SSSP_CHUNK, std::memory_order_relaxed);
+        if (begin >= frontier.sz) {
+          break;
+        }
+        size_t end = std::min(frontier.sz, begin + SSSP_CHUNK);
+        for (size_t i = begin; i < end; ++i) {
+          uint32_t u = frontier.data[i];
+          uint64_t du = __atomic_load_n(&d[u], __ATOMIC_RELAXED);
+          // the vertex was improved into an earlier bucket and handled
+          if (du < lo) {
+            continue;
+          }
+          const uint32_t* targets = csr_targets(g, u);
+          const uint32_t* weights = csr_weights(g, u);
+          for (size_t j = 0, deg = csr_degree(g, u); j < deg; ++j) {
+            uint64_t nd = du + weights[j];
+            if (sssp_relax(d, targets[j], nd, shared)) {
+              bin_push(w, targets[j], nd);
+            }
+          }
+        }
+      }
+      w.lowest = UINT64_MAX;
+      for (size_t k = 1; k < slots; ++k) {
+        if (w.ring[(bucket + k) & (slots - 1)].sz) {
+          w.lowest = bucket + k;
+          break;
+        }
+      }
+      graph_barrier_wait(&barrier);
+
+      // thread 0 picks the next round's frontier
+      if (t == 0) {
+        frontier.sz = 0;
+        for (SsspWorker& other : workers) {
+          DArray<uint32_t>& bin = other.ring[bucket & (slots - 1)];
+          darray_append(&frontier, bin.data, bin.data + bin.sz);
+          bin.sz = 0;
+        }
+        // the current bucket is settled once a round puts nothing back
+        if (frontier.sz == 0) {
+          next_bucket();
+        }
+        cursor.store(0, std::memory_order_relaxed);
+      }
+      graph_barrier_wait(&barrier);
+      if (done) {
+        break;
+      }
+    }
+  };
+  graph_run_threads(threads, work);
+
+  for (SsspWorker& w : workers) {
+    for (DArray<uint32_t>& bin : w.ring) {
+      darray_destroy(&bin);
+    }
+    darray_destroy(&w.far);
+  }
+  darray_destroy(&frontier);
+  return dist;
+}
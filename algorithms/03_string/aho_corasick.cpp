@@ -0,0 +1,302 @@
+/**
+ * aho_corasick.cpp
+ *
+ * Aho-Corasick tests, and throughput benchmarks of keyword sets from ten
+ * to five thousand patterns over log text in memory, memory-mapped, and
+ * read in chunks.
+ */
+
+#include "aho_corasick.hpp"
+#include "mapped_file.hpp"
+#include "string_search.hpp"
+#include "testing.hpp"
+#include "text_gen.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Match = std::pair<uint32_t, uint64_t>; // (pattern id, start)
+
+// every occurrence of every pattern, sorted
+std::vector<Match> naive_matches(std::string_view text,
+                                 const std::vector<std::string>& patterns) {
+  std::vector<Match> out;
+  for (uint32_t id = 0; id < patterns.size(); ++id) {
+    const std::string& p = patterns[id];
+    for (size_t i = 0; i + p.size() <= text.size(); ++i) {
+      if (text.compare(i, p.size(), p) == 0) {
+        out.emplace_back(id, i);
+      }
+    }
+  }
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+// every match the automaton reports, sorted
+std::vector<Match> ac_matches(const AhoCorasick* ac, std::string_view text) {
+  std::vector<Match> out;
+  ac_find_all(ac, text,
+              [&](uint32_t id, size_t pos) { out.emplace_back(id, pos); });
+  std::sort(out.begin(), out.end());
+  return out;
+}
+
+// random strings over the first `letters` lowercase letters
+std::vector<std::string> small_alphabet(size_t count, size_t min_len,
+                                        size_t max_len, int letters,
+                                        std::mt19937& rng) {
+  std::vector<std::string> out(count);
+  for (std::string& s : out) {
+    s.resize(min_len + rng() % (max_len - min_len + 1));
+    for (char& c : s) {
+      c = char('a' + rng() % letters);
+    }
+  }
+  return out;
+}
+
+// write text to a fresh temporary file and return its path
+std::string write_temp(const std::string& name, std::string_view text) {
+  std::string path = (std::filesystem::temp_directory_path() / name).string();
+  FILE* f = fopen(path.c_str(), "wb");
+  fwrite(text.data(), 1, text.size(), f);
+  fclose(f);
+  return path;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Aho-Corasick Tests");
+
+  suite.add_test("Overlapping and nested patterns", []() {
+    std::vector<std::string> patterns = {"he", "she", "his", "hers"};
+    AhoCorasick ac = ac_create(patterns);
+    auto got = ac_matches(&ac, "ushers");
+    std::vector<Match> want = {{0, 2}, {1, 1}, {3, 2}};
+    test::assert_true(got == want, "Matches differ");
+    test::assert_equal(size_t(3), ac_count(&ac, "ushers"));
+    test::assert_equal(size_t(0), ac_count(&ac, "xyz"));
+    ac_destroy(&ac);
+  });
+
+  suite.add_test("Byte classes cover only the patterns' bytes", []() {
+    AhoCorasick ac = ac_create({"abc", "cab", "bb"});
+    // a, b and c, and one class for everything else
+    test::assert_equal(size_t(4), ac.num_classes);
+    test::assert_equal(uint16_t(0), ac.classes[uint8_t('z')]);
+    test::assert_equal(size_t(2), ac_count(&ac, "zzabczzcabzz"));
+    ac_destroy(&ac);
+  });
+
+  suite.add_test("Duplicate patterns and patterns inside others", []() {
+    std::vector<std::string> patterns = {"a", "aa", "aaa", "aa"};
+    AhoCorasick ac = ac_create(patterns);
+    std::string text = "aaaa";
+    test::assert_true(ac_matches(&ac, text) == naive_matches(text, patterns),
+                      "Matches differ");
+    // 4 + 3 + 2 + 3
+    test::assert_equal(size_t(12), ac_count(&ac, text));
+    ac_destroy(&ac);
+  });
+
+  suite.add_test("Matches naive search on random input", []() {
+    std::mt19937 rng(9);
+    for (int letters : {2, 4, 26}) {
+      auto patterns = small_alphabet(60, 1, 8, letters, rng);
+      std::string text = small_alphabet(1, 5000, 5000, letters, rng)[0];
+      AhoCorasick ac = ac_create(patterns);
+      test::assert_true(ac_matches(&ac, text) == naive_matches(text, patterns),
+                        "Matches differ");
+      ac_destroy(&ac);
+    }
+  });
+
+  suite.add_test("Arbitrary bytes", []() {
+    std::vector<std::string> patterns = {std::string("\0\xff", 2),
+                                         std::string("\xff\xff\0", 3), "\x80"};
+    std::string text;
+    for (int i = 0; i < 2000; ++i) {
+      text += char(i * i % 7 == 0 ? 0 : i % 3 == 0 ? 0x80 : 0xff);
+    }
+    AhoCorasick ac = ac_create(patterns);
+    test::assert_true(ac_matches(&ac, text) == naive_matches(text, patterns),
+                      "Matches differ");
+    ac_destroy(&ac);
+  });
+
+  suite.add_test("Streams find matches across chunk boundaries", []() {
+    std::mt19937 rng(11);
+    auto patterns = small_alphabet(30, 1, 12, 3, rng);
+    std::string text = small_alphabet(1, 4000, 4000, 3, rng)[0];
+    AhoCorasick ac = ac_create(patterns);
+    auto want = naive_matches(text, patterns);
+    for (size_t max_chunk : {1, 3, 50, 5000}) {
+      AcStream stream = ac_stream_create(&ac);
+      std::vector<Match> got;
+      for (size_t i = 0; i < text.size();) {
+        size_t len = std::min(text.size() - i, rng() % (max_chunk + 1));
+        ac_feed(&stream, std::string_view(text).substr(i, len),
+                [&](uint32_t id, uint64_t pos) { got.emplace_back(id, pos); });
+        i += len;
+      }
+      std::sort(got.begin(), got.end());
+      test::assert_true(got == want, "Stream matches differ");
+    }
+    ac_destroy(&ac);
+  });
+
+  suite.add_test("Mapped and chunked files", []() {
+    auto vocab = text_gen_words(200, 3, 8, 4);
+    std::string text = text_gen_log(200000, vocab, 4);
+    std::vector<std::string> keywords(vocab.begin(), vocab.begin() + 20);
+    keywords.push_back("WARN");
+    std::string path = write_temp("aho_corasick_test.log", text);
+    AhoCorasick ac = ac_create(keywords);
+    auto want = naive_matches(text, keywords);
+
+    MappedFile file = mapped_open(path);
+    test::assert_true(ac_matches(&ac, mapped_view(&file)) == want,
+                      "Mapped matches differ");
+    mapped_close(&file);
+
+    AcStream stream = ac_stream_create(&ac);
+    std::vector<Match> got;
+    file_read_chunks(
+        path,
+        [&](std::string_view chunk) {
+          ac_feed(&stream, chunk, [&](uint32_t id, uint64_t pos) {
+            got.emplace_back(id, pos);
+          });
+        },
+        1000);
+    std::sort(got.begin(), got.end());
+    test::assert_true(got == want, "Chunked matches differ");
+
+    ac_destroy(&ac);
+    std::remove(path.c_str());
+  });
+
+  suite.add_test("No patterns", []() {
+    AhoCorasick ac = ac_create({});
+    test::assert_equal(size_t(1), ac.num_states);
+    test::assert_equal(size_t(0), ac_count(&ac, "anything"));
+    ac_destroy(&ac);
+  });
+
+  // error handling tests
+  suite.add_test("Empty pattern", []() {
+    bool caught_exception = false;
+
+    try {
+      ac_create({"ok", ""});
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: count every occurrence of a keyword set in 64 MiB of log
+  // lines. A tenth of the keywords are vocabulary words, which occur about
+  // once per 5000 words each; the rest are random and rarely match. ops
+  // counts text bytes, so the summary is in GB/s.
+  test::Benchmark bench("Aho-Corasick Benchmarks");
+  const size_t bytes = size_t(64) << 20;
+  auto vocab = text_gen_words(5000, 3, 10);
+  const std::string text = text_gen_log(bytes, vocab);
+  std::string path = write_temp("aho_corasick_bench.log", text);
+  MappedFile file = mapped_open(path);
+
+  std::vector<std::vector<std::string>> sets;
+  std::vector<AhoCorasick> automata;
+  for (size_t k : {10, 1000, 5000}) {
+    auto keywords = text_gen_words(k, 5, 12, k);
+    for (size_t i = 0; i < k; i += 10) {
+      keywords[i] = vocab[i % vocab.size()];
+    }
+    sets.push_back(keywords);
+    automata.push_back(ac_create(keywords));
+  }
+
+  // the single-pattern search run once per keyword, for comparison
+  const std::vector<std::string>* ten = &sets[0];
+  bench.add_test(
+      "One vectorized pass per keyword (10 keywords)",
+      [&]() {
+        size_t total = 0;
+        for (const std::string& keyword : *ten) {
+          total += search_count(text, keyword);
+        }
+        test::do_not_optimize(total);
+      },
+      bytes);
+
+  for (size_t s = 0; s < sets.size(); ++s) {
+    const AhoCorasick* ac = &automata[s];
+    std::string suffix = " (" + std::to_string(sets[s].size()) +
+                         " keywords, " + std::to_string(ac->num_states) +
+                         " states)";
+
+    bench.add_test(
+        "In memory" + suffix,
+        [ac, &text]() { test::do_not_optimize(ac_count(ac, text)); }, bytes);
+
+    bench.add_test(
+        "mmap" + suffix,
+        [ac, &file]() {
+          test::do_not_optimize(ac_count(ac, mapped_view(&file)));
+        },
+        bytes);
+
+    bench.add_test(
+        "1 MiB reads" + suffix,
+        [ac, &path]() {
+          AcStream stream = ac_stream_create(ac);
+          size_t total = 0;
+          file_read_chunks(path, [&](std::string_view chunk) {
+            ac_feed(&stream, chunk, [&](uint32_t, uint64_t) { total++; });
+          });
+          test::do_not_optimize(total);
+        },
+        bytes);
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  std::cout << "\nThroughput (median):" << std::endl;
+  for (const test::BenchResult& r : bench.results()) {
+    std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(6)
+              << r.ops / r.stats.median << " GB/s  " << r.name
+              << std::defaultfloat << std::endl;
+  }
+  for (size_t s = 0; s < sets.size(); ++s) {
+    std::cout << "  " << sets[s].size() << " keywords: "
+              << ac_count(&automata[s], text) << " matches, "
+              << automata[s].num_classes << " byte classes, "
+              << automata[s].next.sz * sizeof(uint32_t) / 1024
+              << " KiB table" << std::endl;
+  }
+
+  for (AhoCorasick& ac : automata) {
+    ac_destroy(&ac);
+  }
+  mapped_close(&file);
+  std::remove(path.c_str());
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Aho-Corasick program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
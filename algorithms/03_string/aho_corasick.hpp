@@ -0,0 +1,217 @@
+/**
+ * aho_corasick.hpp
+ *
+ * Aho-Corasick automaton for finding every occurrence of many patterns in
+ * one pass. The trie's failure links are folded into a complete transition
+ * table, so each text byte costs one table load:
+ *
+ *  - bytes are first mapped to classes: one per byte value that appears in
+ *    some pattern, plus class 0 for all the rest, so a table row is only as
+ *    wide as the patterns' alphabet
+ *  - rows sit back to back in one array and transitions hold the offset of
+ *    the target's row, not its number, saving a multiply per byte
+ *  - a transition into a state where some pattern ends carries AC_MATCH,
+ *    so the scan loop only leaves the fast path to report a match
+ *
+ * Each state lists the patterns ending exactly there and links to the
+ * nearest shorter suffix state that ends a pattern (the dictionary link).
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define AC_MATCH 0x80000000u // transition flag: the target ends a pattern
+
+struct AhoCorasick {
+  DArray<uint32_t> next;    // row offset of the target per (state, class)
+  uint16_t classes[256];    // byte -> class
+  size_t num_classes;       // row width
+  size_t num_states;
+  DArray<uint32_t> dict;    // per state: dictionary link, 0 if none
+  DArray<uint32_t> out;     // per state, and one past: start in out_ids
+  DArray<uint32_t> out_ids; // pattern ids ending at each state
+  DArray<uint32_t> lengths; // per pattern
+};
+
+// automaton over patterns; ids are indices into patterns
+inline AhoCorasick ac_create(const std::vector<std::string>& patterns) {
+  AhoCorasick ac;
+  size_t total = 0;
+  std::fill(ac.classes, ac.classes + 256, 0);
+  for (const std::string& p : patterns) {
+    if (p.empty()) {
+      throw std::runtime_error("Empty pattern");
+    }
+    total += p.size();
+    for (char c : p) {
+      ac.classes[uint8_t(c)] = 1;
+    }
+  }
+  size_t width = 1;
+  for (size_t b = 0; b < 256; ++b) {
+    if (ac.classes[b]) {
+      ac.classes[b] = uint16_t(width++);
+    }
+  }
+  if ((total + 1) * width >= AC_MATCH) {
+    throw std::runtime_error("Too many pattern bytes");
+  }
+  ac.num_classes = width;
+
+  // trie; a transition of 0 is missing until the table is completed
+  ac.next = darray_create<uint32_t>((total + 1) * width);
+  ac.next.sz = width;
+  std::fill(ac.next.data, ac.next.data + width, 0);
+  std::vector<std::vector<uint32_t>> ending(1);
+  ac.lengths = darray_create<uint32_t>(patterns.size() ? patterns.size() : 1);
+  for (size_t id = 0; id < patterns.size(); ++id) {
+    uint32_t row = 0;
+    for (char c : patterns[id]) {
+      uint32_t& t = ac.next.data[row + ac.classes[uint8_t(c)]];
+      if (t == 0) {
+        t = uint32_t(ac.next.sz);
+        ac.next.sz += width;
+        std::fill(ac.next.data + t, ac.next.data + t + width, 0);
+        ending.emplace_back();
+      }
+      row = t;
+    }
+    ending[row / width].push_back(uint32_t(id));
+    darray_push_back(&ac.lengths, uint32_t(patterns[id].size()));
+  }
+  size_t n = ending.size();
+  ac.num_states = n;
+
+  // breadth-first, so a state's failure target is complete before it
+  DArray<uint32_t> fail = darray_create<uint32_t>(n);
+  fail.sz = n;
+  ac.dict = darray_create<uint32_t>(n);
+  ac.dict.sz = n;
+  fail.data[0] = ac.dict.data[0] = 0;
+  std::vector<uint32_t> order = {0};
+  for (size_t head = 0; head < order.size(); ++head) {
+    uint32_t s = order[head];
+    uint32_t* row = ac.next.data + size_t(s) * width;
+    const uint32_t* fail_row = ac.next.data + size_t(fail.data[s]) * width;
+    for (size_t c = 0; c < width; ++c) {
+      if (row[c] != 0) {
+        // a trie edge; the root's children fail to the root
+        uint32_t child = row[c] / width;
+        uint32_t f = s == 0 ? 0 : fail_row[c] / width;
+        fail.data[child] = f;
+        ac.dict.data[child] = ending[f].empty() ? ac.dict.data[f] : f;
+        order.push_back(child);
+      } else if (s != 0) {
+        row[c] = fail_row[c];
+      }
+    }
+  }
+  darray_destroy(&fail);
+
+  ac.out = darray_create<uint32_t>(n + 1);
+  ac.out.sz = n + 1;
+  ac.out_ids = darray_create<uint32_t>(patterns.size() ? patterns.size() : 1);
+  for (size_t s = 0; s < n; ++s) {
+    ac.out.data[s] = uint32_t(ac.out_ids.sz);
+    darray_append(&ac.out_ids, ending[s].begin(), ending[s].end());
+  }
+  ac.out.data[n] = uint32_t(ac.out_ids.sz);
+
+  for (size_t i = 0; i < ac.next.sz; ++i) {
+    uint32_t s = ac.next.data[i] / width;
+    if (!ending[s].empty() || ac.dict.data[s] != 0) {
+      ac.next.data[i] |= AC_MATCH;
+    }
+  }
+  return ac;
+}
+
+inline void ac_destroy(AhoCorasick* ac) {
+  darray_destroy(&ac->next);
+  darray_destroy(&ac->dict);
+  darray_destroy(&ac->out);
+  darray_destroy(&ac->out_ids);
+  darray_destroy(&ac->lengths);
+}
+
+// call f(id, end) for each pattern ending at state, end being the position
+// just past its last byte
+template <typename F>
+void ac_report(const AhoCorasick* ac, uint32_t state, uint64_t end, F& f) {
+  for (uint32_t s = state; s != 0; s = ac->dict.data[s]) {
+    for (uint32_t k = ac->out.data[s]; k < ac->out.data[s + 1]; ++k) {
+      f(ac->out_ids.data[k], end);
+    }
+  }
+}
+
+// run n bytes through the automaton from *row (a row offset), calling
+// f(id, end) on every match with end counted from base
+template <typename F>
+void ac_scan(const AhoCorasick* ac, const char* text, size_t n,
+             uint32_t* row, uint64_t base, F& f) {
+  const uint32_t* next = ac->next.data;
+  const uint16_t* classes = ac->classes;
+  uint32_t r = *row;
+  for (size_t i = 0; i < n; ++i) {
+    uint32_t t = next[r + classes[uint8_t(text[i])]];
+    r = t & ~AC_MATCH;
+    if (t & AC_MATCH) {
+      ac_report(ac, uint32_t(r / ac->num_classes), base + i + 1, f);
+    }
+  }
+  *row = r;
+}
+
+// call f(id, pos) for every occurrence of every pattern in text, pos being
+// where it starts; occurrences come in order of their end
+template <typename F>
+void ac_find_all(const AhoCorasick* ac, std::string_view text, F f) {
+  uint32_t row = 0;
+  auto start = [&](uint32_t id, uint64_t end) {
+    f(id, size_t(end - ac->lengths.data[id]));
+  };
+  ac_scan(ac, text.data(), text.size(), &row, 0, start);
+}
+
+// number of occurrences of all patterns
+inline size_t ac_count(const AhoCorasick* ac, std::string_view text) {
+  size_t total = 0;
+  uint32_t row = 0;
+  auto tally = [&total](uint32_t, uint64_t) { total++; };
+  ac_scan(ac, text.data(), text.size(), &row, 0, tally);
+  return total;
+}
+
+// the automaton over a stream fed a chunk at a time; the automaton must
+// outlive it. Its state carries over from chunk to chunk, so matches that
+// span a boundary are found like any other.
+struct AcStream {
+  const AhoCorasick* ac;
+  uint32_t row;    // current state's row offset
+  uint64_t offset; // stream bytes fed so far
+};
+
+inline AcStream ac_stream_create(const AhoCorasick* ac) {
+  return AcStream{ac, 0, 0};
+}
+
+// feed the next chunk, calling f(id, pos) with the stream position of
+// each match that ends in it
+template <typename F>
+void ac_feed(AcStream* stream, std::string_view chunk, F f) {
+  const AhoCorasick* ac = stream->ac;
+  auto start = [&](uint32_t id, uint64_t end) {
+    f(id, end - ac->lengths.data[id]);
+  };
+  ac_scan(ac, chunk.data(), chunk.size(), &stream->row, stream->offset, start);
+  stream->offset += chunk.size();
+}
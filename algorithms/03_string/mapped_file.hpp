@@ -0,0 +1,100 @@
+/**
+ * mapped_file.hpp
+ *
+ * Two ways to get at a file's bytes for scanning: map the whole file into
+ * memory read-only, or read it a fixed-size chunk at a time into one
+ * reused buffer (for pipes and files larger than the address space, or to
+ * keep the resident set small).
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_CHUNK (1 << 20) // default read size of file_read_chunks
+
+struct MappedFile {
+  const char* data; // nullptr for an empty file
+  size_t size;
+};
+
+// map the file at path read-only
+inline MappedFile mapped_open(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open file");
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw std::runtime_error("Cannot open file");
+  }
+  MappedFile file{nullptr, size_t(st.st_size)};
+  if (file.size > 0) {
+    void* mem = mmap(nullptr, file.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mem == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Cannot map file");
+    }
+    // scans read front to back; let the kernel read ahead aggressively
+    madvise(mem, file.size, MADV_SEQUENTIAL);
+    file.data = static_cast<const char*>(mem);
+  }
+  // the mapping holds its own reference to the file
+  close(fd);
+  return file;
+}
+
+inline void mapped_close(MappedFile* file) {
+  if (file->data) {
+    munmap(const_cast<char*>(file->data), file->size);
+  }
+  file->data = nullptr;
+  file->size = 0;
+}
+
+inline std::string_view mapped_view(const MappedFile* file) {
+  return std::string_view(file->data, file->size);
+}
+
+// call f(chunk) with successive pieces of the file at path, each at most
+// chunk_size bytes, until the end; returns the bytes read
+template <typename F>
+size_t file_read_chunks(const std::string& path, F f,
+                        size_t chunk_size = FILE_CHUNK) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open file");
+  }
+  DArray<char> buf = darray_create<char>(chunk_size ? chunk_size : 1);
+  size_t total = 0;
+  for (;;) {
+    ssize_t got = read(fd, buf.data, buf.cap);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got < 0) {
+      darray_destroy(&buf);
+      close(fd);
+      throw std::runtime_error("Cannot read file");
+    }
+    if (got == 0) {
+      break;
+    }
+    total += size_t(got);
+    f(std::string_view(buf.data, size_t(got)));
+  }
+  darray_destroy(&buf);
+  close(fd);
+  return total;
+}
@@ -0,0 +1,325 @@
+/**
+ * string_search.cpp
+ *
+ * Single-pattern search tests, and throughput benchmarks of KMP and the
+ * vectorized search against std::string_view::find over log text in
+ * memory, memory-mapped, and read in chunks.
+ */
+
+#include "string_search.hpp"
+#include "mapped_file.hpp"
+#include "testing.hpp"
+#include "text_gen.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// start of every (overlapping) occurrence of pattern in text
+std::vector<uint64_t> naive_find_all(std::string_view text,
+                                     std::string_view pattern) {
+  std::vector<uint64_t> out;
+  for (size_t i = 0; i + pattern.size() <= text.size(); ++i) {
+    if (text.compare(i, pattern.size(), pattern) == 0) {
+      out.push_back(i);
+    }
+  }
+  return out;
+}
+
+// text over a two-letter alphabet, so that partial matches are common
+std::string ab_text(size_t n, std::mt19937& rng) {
+  std::string s(n, 'a');
+  for (char& c : s) {
+    c = char('a' + rng() % 2);
+  }
+  return s;
+}
+
+// cut text into chunks of random sizes up to max_chunk
+std::vector<std::string_view> random_chunks(std::string_view text,
+                                            size_t max_chunk,
+                                            std::mt19937& rng) {
+  std::vector<std::string_view> chunks;
+  for (size_t i = 0; i < text.size();) {
+    size_t len = std::min(text.size() - i, size_t(rng() % (max_chunk + 1)));
+    chunks.push_back(text.substr(i, len));
+    i += len;
+  }
+  return chunks;
+}
+
+// write text to a fresh temporary file and return its path
+std::string write_temp(const std::string& name, std::string_view text) {
+  std::string path = (std::filesystem::temp_directory_path() / name).string();
+  FILE* f = fopen(path.c_str(), "wb");
+  fwrite(text.data(), 1, text.size(), f);
+  fclose(f);
+  return path;
+}
+
+int main(void) {
+  const SimdLevel levels[] = {SimdLevel::SCALAR, SimdLevel::SSE2,
+                              SimdLevel::AVX2};
+
+  // test suite
+  test::TestSuite suite("String Search Tests");
+
+  suite.add_test("KMP failure table", []() {
+    Kmp kmp = kmp_create("abacabab");
+    const uint32_t want[] = {0, 0, 1, 0, 1, 2, 3, 2};
+    for (size_t i = 0; i < 8; ++i) {
+      test::assert_equal(want[i], kmp.fail.data[i]);
+    }
+    kmp_destroy(&kmp);
+  });
+
+  suite.add_test("KMP finds overlapping matches", []() {
+    Kmp kmp = kmp_create("aa");
+    test::assert_equal(size_t(6), kmp_count(&kmp, "aaaaaaa"));
+    test::assert_equal(size_t(0), kmp_find(&kmp, "aaaaaaa"));
+    test::assert_equal(size_t(3), kmp_find(&kmp, "abaaa", 3));
+    test::assert_equal(size_t(5), kmp_find(&kmp, "ababa"));
+    kmp_destroy(&kmp);
+  });
+
+  suite.add_test("Vectorized search matches naive at every level", [&]() {
+    std::mt19937 rng(3);
+    for (SimdLevel level : levels) {
+      simd_set_level(level);
+      // lengths around one and two vector widths
+      for (size_t n : {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 200, 1000}) {
+        std::string text = ab_text(n, rng);
+        for (size_t m : {1, 2, 3, 5, 8, 17, 40}) {
+          std::string pattern = ab_text(m, rng);
+          auto want = naive_find_all(text, pattern);
+          test::assert_equal(want.size(), search_count(text, pattern));
+          size_t first = want.empty() ? n : want[0];
+          test::assert_equal(first, search_find(text, pattern));
+          Kmp kmp = kmp_create(pattern);
+          test::assert_equal(want.size(), kmp_count(&kmp, text));
+          test::assert_equal(first, kmp_find(&kmp, text));
+          kmp_destroy(&kmp);
+        }
+      }
+      // a match in the last bytes, past the last whole vector
+      std::string text = std::string(100, 'x') + "needle";
+      test::assert_equal(size_t(100), search_find(text, "needle"));
+      test::assert_equal(size_t(105), search_find(text, "e", 103));
+    }
+    simd_set_level(simd_detect());
+  });
+
+  suite.add_test("Arbitrary bytes", []() {
+    std::string text;
+    for (int i = 0; i < 600; ++i) {
+      text += char(i * 7);
+    }
+    std::string pattern = text.substr(300, 9);
+    pattern[0] = '\0';
+    text[300] = '\0';
+    auto want = naive_find_all(text, pattern);
+    test::assert_equal(size_t(1), want.size());
+    test::assert_equal(want[0], uint64_t(search_find(text, pattern)));
+  });
+
+  suite.add_test("Streams find matches across chunk boundaries", [&]() {
+    std::mt19937 rng(5);
+    std::string text = ab_text(3000, rng);
+    for (size_t m : {1, 2, 7, 30}) {
+      std::string pattern = ab_text(m, rng);
+      auto want = naive_find_all(text, pattern);
+      for (size_t max_chunk : {1, 5, 64, 4000}) {
+        auto chunks = random_chunks(text, max_chunk, rng);
+        Kmp kmp = kmp_create(pattern);
+        KmpStream ks = kmp_stream_create(&kmp);
+        SearchStream ss = search_stream_create(pattern);
+        std::vector<uint64_t> got_kmp;
+        std::vector<uint64_t> got_simd;
+        for (std::string_view chunk : chunks) {
+          kmp_feed(&ks, chunk, [&](uint64_t pos) { got_kmp.push_back(pos); });
+          search_feed(&ss, chunk,
+                      [&](uint64_t pos) { got_simd.push_back(pos); });
+        }
+        test::assert_true(got_kmp == want, "KMP stream differs");
+        test::assert_true(got_simd == want, "Vectorized stream differs");
+        search_stream_destroy(&ss);
+        kmp_destroy(&kmp);
+      }
+    }
+  });
+
+  suite.add_test("Mapped and chunked files", []() {
+    auto vocab = text_gen_words(50, 3, 8, 2);
+    std::string text = text_gen_log(100000, vocab, 2);
+    std::string path = write_temp("string_search_test.log", text);
+    auto want = naive_find_all(text, vocab[7]);
+
+    MappedFile file = mapped_open(path);
+    test::assert_equal(text.size(), file.size);
+    test::assert_equal(want.size(), search_count(mapped_view(&file), vocab[7]));
+    mapped_close(&file);
+
+    SearchStream ss = search_stream_create(vocab[7]);
+    std::vector<uint64_t> got;
+    size_t bytes = file_read_chunks(
+        path,
+        [&](std::string_view chunk) {
+          search_feed(&ss, chunk, [&](uint64_t pos) { got.push_back(pos); });
+        },
+        4096);
+    test::assert_equal(text.size(), bytes);
+    test::assert_true(got == want, "Chunked matches differ");
+    search_stream_destroy(&ss);
+
+    // an empty file maps to an empty view
+    std::string empty = write_temp("string_search_empty.log", "");
+    MappedFile none = mapped_open(empty);
+    test::assert_equal(size_t(0), mapped_view(&none).size());
+    mapped_close(&none);
+    std::remove(empty.c_str());
+    std::remove(path.c_str());
+  });
+
+  // error handling tests
+  suite.add_test("Empty pattern", []() {
+    bool caught_kmp = false;
+    bool caught_stream = false;
+
+    try {
+      kmp_create("");
+    } catch (const std::runtime_error& e) {
+      caught_kmp = true;
+    }
+    try {
+      search_stream_create("");
+    } catch (const std::runtime_error& e) {
+      caught_stream = true;
+    }
+    test::assert_true(caught_kmp, "Expected exception not thrown");
+    test::assert_true(caught_stream, "Expected exception not thrown");
+  });
+
+  suite.add_test("Missing file", []() {
+    bool caught_map = false;
+    bool caught_read = false;
+
+    try {
+      mapped_open("/nonexistent/string_search.log");
+    } catch (const std::runtime_error& e) {
+      caught_map = true;
+    }
+    try {
+      file_read_chunks("/nonexistent/string_search.log",
+                       [](std::string_view) {});
+    } catch (const std::runtime_error& e) {
+      caught_read = true;
+    }
+    test::assert_true(caught_map, "Expected exception not thrown");
+    test::assert_true(caught_read, "Expected exception not thrown");
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: count one keyword in 64 MiB of log lines; ops counts
+  // text bytes, so the summary is in GB/s
+  test::Benchmark bench("String Search Benchmarks");
+  const size_t bytes = size_t(64) << 20;
+  auto vocab = text_gen_words(5000, 3, 10);
+  const std::string text = text_gen_log(bytes, vocab);
+  // a word from the vocabulary, so it occurs about once per 5000 words
+  const std::string keyword = vocab[123].size() >= 6 ? vocab[123] : "timeout";
+  std::string path = write_temp("string_search_bench.log", text);
+  MappedFile file = mapped_open(path);
+  Kmp kmp = kmp_create(keyword);
+
+  bench.add_test(
+      "std::string_view::find",
+      [&]() {
+        std::string_view view = text;
+        size_t total = 0;
+        for (size_t i = view.find(keyword); i != std::string_view::npos;
+             i = view.find(keyword, i + 1)) {
+          total++;
+        }
+        test::do_not_optimize(total);
+      },
+      bytes);
+
+  bench.add_test(
+      "KMP", [&]() { test::do_not_optimize(kmp_count(&kmp, text)); }, bytes);
+
+  const char* level_names[] = {"scalar", "SSE2", "AVX2"};
+  for (SimdLevel level : levels) {
+    if (level > simd_detect()) {
+      continue;
+    }
+    std::string name = level_names[int(level)];
+    bench.add_test(
+        "First/last byte filter, " + name,
+        [&, level]() {
+          simd_set_level(level);
+          test::do_not_optimize(search_count(text, keyword));
+          simd_set_level(simd_detect());
+        },
+        bytes);
+  }
+
+  bench.add_test(
+      "First/last byte filter, mmap",
+      [&]() {
+        test::do_not_optimize(search_count(mapped_view(&file), keyword));
+      },
+      bytes);
+
+  bench.add_test(
+      "First/last byte filter, 1 MiB reads",
+      [&]() {
+        SearchStream ss = search_stream_create(keyword);
+        size_t total = 0;
+        file_read_chunks(path, [&](std::string_view chunk) {
+          search_feed(&ss, chunk, [&](uint64_t) { total++; });
+        });
+        test::do_not_optimize(total);
+        search_stream_destroy(&ss);
+      },
+      bytes);
+
+  bench.add_test(
+      "KMP, 1 MiB reads",
+      [&]() {
+        KmpStream ks = kmp_stream_create(&kmp);
+        size_t total = 0;
+        file_read_chunks(path, [&](std::string_view chunk) {
+          kmp_feed(&ks, chunk, [&](uint64_t) { total++; });
+        });
+        test::do_not_optimize(total);
+      },
+      bytes);
+
+  // run all benchmarks
+  bench.run();
+
+  std::cout << "\nThroughput (median), keyword \"" << keyword << "\", "
+            << search_count(text, keyword) << " matches:" << std::endl;
+  for (const test::BenchResult& r : bench.results()) {
+    std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(6)
+              << r.ops / r.stats.median << " GB/s  " << r.name
+              << std::defaultfloat << std::endl;
+  }
+
+  kmp_destroy(&kmp);
+  mapped_close(&file);
+  std::remove(path.c_str());
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "String search program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,306 @@
+/**
+ * string_search.hpp
+ *
+ * Single-pattern substring search.
+ *
+ *  - Knuth-Morris-Pratt reads each text byte once and never backs up, so
+ *    it suits input that arrives a chunk at a time.
+ *  - search_find and search_count compare the pattern's first and last
+ *    bytes against a whole vector of text positions at once (SSE2 or
+ *    AVX2, picked at runtime like the DArray bulk algorithms) and only
+ *    memcmp the candidates that pass both.
+ *
+ * Both have a stream form whose matches may span chunk boundaries; they
+ * report positions counted from the start of the stream.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include "../../data_structures/00_dynamic_array/darray_simd.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace string_simd {
+namespace scalar {
+template <typename F>
+size_t scan(const char* text, size_t n, const char* pattern, size_t m,
+            size_t from, F& f) {
+  for (size_t i = from; i + m <= n; ++i) {
+    if (text[i] == pattern[0] && memcmp(text + i, pattern, m) == 0 && f(i)) {
+      return i;
+    }
+  }
+  return n;
+}
+} // namespace scalar
+
+#ifdef DARRAY_SIMD_X86
+namespace sse2 {
+struct Ops {
+  using V = __m128i;
+  static constexpr size_t lanes = 16;
+
+  static V load(const char* p) { return _mm_loadu_si128((const V*)p); }
+  static V set1(char c) { return _mm_set1_epi8(c); }
+  static unsigned eq_mask(V a, V b) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+  }
+};
+
+#include "string_search_kernels.hpp"
+} // namespace sse2
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+struct Ops {
+  using V = __m256i;
+  static constexpr size_t lanes = 32;
+
+  static V load(const char* p) { return _mm256_loadu_si256((const V*)p); }
+  static V set1(char c) { return _mm256_set1_epi8(c); }
+  static unsigned eq_mask(V a, V b) {
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+  }
+};
+
+#include "string_search_kernels.hpp"
+} // namespace avx2
+#pragma GCC pop_options
+#endif // DARRAY_SIMD_X86
+} // namespace string_simd
+
+// call f(i) for each match of pattern (m >= 1 bytes) in text at or after
+// from, until f returns true; returns that i, or n
+template <typename F>
+size_t search_scan(const char* text, size_t n, const char* pattern, size_t m,
+                   size_t from, F& f) {
+#ifdef DARRAY_SIMD_X86
+  if (simd_level() == SimdLevel::AVX2) {
+    return string_simd::avx2::scan(text, n, pattern, m, from, f);
+  }
+  if (simd_level() == SimdLevel::SSE2) {
+    return string_simd::sse2::scan(text, n, pattern, m, from, f);
+  }
+#endif
+  return string_simd::scalar::scan(text, n, pattern, m, from, f);
+}
+
+// index of the first match of pattern in text at or after from, or the
+// text's size; an empty pattern matches at from
+inline size_t search_find(std::string_view text, std::string_view pattern,
+                          size_t from = 0) {
+  if (from > text.size()) {
+    return text.size();
+  }
+  if (pattern.empty()) {
+    return from;
+  }
+  auto stop = [](size_t) { return true; };
+  return search_scan(text.data(), text.size(), pattern.data(), pattern.size(),
+                     from, stop);
+}
+
+// number of (possibly overlapping) matches of a non-empty pattern
+inline size_t search_count(std::string_view text, std::string_view pattern) {
+  if (pattern.empty()) {
+    throw std::runtime_error("Empty pattern");
+  }
+  size_t total = 0;
+  auto tally = [&total](size_t) {
+    total++;
+    return false;
+  };
+  search_scan(text.data(), text.size(), pattern.data(), pattern.size(), 0,
+              tally);
+  return total;
+}
+
+// pattern with its KMP failure table
+struct Kmp {
+  DArray<char> pattern;
+  DArray<uint32_t> fail; // fail[i]: longest proper border of pattern[0..i]
+};
+
+inline Kmp kmp_create(std::string_view pattern) {
+  if (pattern.empty()) {
+    throw std::runtime_error("Empty pattern");
+  }
+  if (pattern.size() > UINT32_MAX) {
+    throw std::runtime_error("Pattern too long");
+  }
+  size_t m = pattern.size();
+  Kmp kmp{darray_create<char>(m), darray_create<uint32_t>(m)};
+  darray_append(&kmp.pattern, pattern.begin(), pattern.end());
+  kmp.fail.sz = m;
+  kmp.fail.data[0] = 0;
+  uint32_t k = 0;
+  for (size_t i = 1; i < m; ++i) {
+    while (k > 0 && pattern[i] != pattern[k]) {
+      k = kmp.fail.data[k - 1];
+    }
+    k += pattern[i] == pattern[k];
+    kmp.fail.data[i] = k;
+  }
+  return kmp;
+}
+
+inline void kmp_destroy(Kmp* kmp) {
+  darray_destroy(&kmp->pattern);
+  darray_destroy(&kmp->fail);
+}
+
+// feed n bytes to the matcher, *matched being how much of the pattern the
+// bytes before them ended with; calls f(end) with the index just past each
+// match until f returns true, and returns that index, or n
+template <typename F>
+size_t kmp_scan(const Kmp* kmp, const char* text, size_t n, size_t* matched,
+                F& f) {
+  const char* p = kmp->pattern.data;
+  const uint32_t* fail = kmp->fail.data;
+  size_t m = kmp->pattern.sz;
+  size_t k = *matched;
+  for (size_t i = 0; i < n; ++i) {
+    while (k > 0 && text[i] != p[k]) {
+      k = fail[k - 1];
+    }
+    k += text[i] == p[k];
+    if (k == m) {
+      k = fail[m - 1];
+      if (f(i + 1)) {
+        *matched = k;
+        return i + 1;
+      }
+    }
+  }
+  *matched = k;
+  return n;
+}
+
+// index of the first match at or after from, or the text's size
+inline size_t kmp_find(const Kmp* kmp, std::string_view text,
+                       size_t from = 0) {
+  if (from > text.size()) {
+    return text.size();
+  }
+  size_t found = text.size();
+  size_t matched = 0;
+  auto stop = [&](size_t end) {
+    found = from + end - kmp->pattern.sz;
+    return true;
+  };
+  kmp_scan(kmp, text.data() + from, text.size() - from, &matched, stop);
+  return found;
+}
+
+// number of (possibly overlapping) matches
+inline size_t kmp_count(const Kmp* kmp, std::string_view text) {
+  size_t total = 0;
+  size_t matched = 0;
+  auto tally = [&total](size_t) {
+    total++;
+    return false;
+  };
+  kmp_scan(kmp, text.data(), text.size(), &matched, tally);
+  return total;
+}
+
+// KMP over a stream fed a chunk at a time; the pattern must outlive it
+struct KmpStream {
+  const Kmp* kmp;
+  size_t matched;  // pattern bytes the stream so far ends with
+  uint64_t offset; // stream bytes fed so far
+};
+
+inline KmpStream kmp_stream_create(const Kmp* kmp) {
+  return KmpStream{kmp, 0, 0};
+}
+
+// feed the next chunk, calling f(pos) with the stream position of each
+// match that ends in it
+template <typename F>
+void kmp_feed(KmpStream* stream, std::string_view chunk, F f) {
+  uint64_t base = stream->offset - stream->kmp->pattern.sz;
+  auto report = [&](size_t end) {
+    f(base + end);
+    return false;
+  };
+  kmp_scan(stream->kmp, chunk.data(), chunk.size(), &stream->matched, report);
+  stream->offset += chunk.size();
+}
+
+// vectorized search over a stream fed a chunk at a time. The last m - 1
+// bytes seen are kept, and matches that start in them are looked for in
+// those bytes followed by the head of the next chunk.
+struct SearchStream {
+  DArray<char> pattern;
+  DArray<char> tail; // up to m - 1 bytes ending the stream so far
+  uint64_t offset;   // stream bytes fed so far
+};
+
+inline SearchStream search_stream_create(std::string_view pattern) {
+  if (pattern.empty()) {
+    throw std::runtime_error("Empty pattern");
+  }
+  size_t m = pattern.size();
+  SearchStream stream{darray_create<char>(m), darray_create<char>(2 * m), 0};
+  darray_append(&stream.pattern, pattern.begin(), pattern.end());
+  return stream;
+}
+
+inline void search_stream_destroy(SearchStream* stream) {
+  darray_destroy(&stream->pattern);
+  darray_destroy(&stream->tail);
+}
+
+// feed the next chunk, calling f(pos) with the stream position of each
+// match that ends in it, in order
+template <typename F>
+void search_feed(SearchStream* stream, std::string_view chunk, F f) {
+  const char* p = stream->pattern.data;
+  size_t m = stream->pattern.sz;
+  size_t keep = m - 1;
+  DArray<char>* tail = &stream->tail;
+  size_t held = tail->sz;
+
+  // matches that start in the tail and end in this chunk
+  if (held > 0) {
+    size_t head = std::min(chunk.size(), keep);
+    darray_append(tail, chunk.begin(), chunk.begin() + head);
+    uint64_t base = stream->offset - held;
+    auto report = [&](size_t i) {
+      if (i >= held) {
+        return true; // lies wholly in the chunk, found below
+      }
+      f(base + i);
+      return false;
+    };
+    search_scan(tail->data, tail->sz, p, m, 0, report);
+    tail->sz = held;
+  }
+
+  uint64_t base = stream->offset;
+  auto report = [&](size_t i) {
+    f(base + i);
+    return false;
+  };
+  search_scan(chunk.data(), chunk.size(), p, m, 0, report);
+
+  // keep the last m - 1 bytes of tail and chunk together
+  if (chunk.size() >= keep) {
+    tail->sz = 0;
+    darray_append(tail, chunk.end() - keep, chunk.end());
+  } else {
+    size_t total = held + chunk.size();
+    size_t drop = total > keep ? total - keep : 0;
+    memmove(tail->data, tail->data + drop, held - drop);
+    tail->sz = held - drop;
+    darray_append(tail, chunk.begin(), chunk.end());
+  }
+  stream->offset += chunk.size();
+}
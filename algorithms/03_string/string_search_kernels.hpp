@@ -0,0 +1,37 @@
+/**
+ * string_search_kernels.hpp
+ *
+ * Vectorized substring scan shared by every instruction set. This file has
+ * no include guard on purpose: string_search.hpp includes it once inside
+ * each per-ISA namespace, after defining Ops for that ISA, so the same code
+ * is compiled once per target.
+ */
+
+// call f(i) for each i >= from where pattern (m >= 1 bytes) occurs in
+// text, in order, until f returns true; returns that i, or n. A block of
+// candidates is the positions whose first and last bytes both match, so
+// memcmp only runs where a match is likely.
+template <typename F>
+size_t scan(const char* text, size_t n, const char* pattern, size_t m,
+            size_t from, F& f) {
+  auto first = Ops::set1(pattern[0]);
+  auto last = Ops::set1(pattern[m - 1]);
+  size_t i = from;
+  for (; i + m - 1 + Ops::lanes <= n; i += Ops::lanes) {
+    unsigned mask = Ops::eq_mask(Ops::load(text + i), first) &
+                    Ops::eq_mask(Ops::load(text + i + m - 1), last);
+    while (mask) {
+      size_t at = i + __builtin_ctz(mask);
+      if (memcmp(text + at, pattern, m) == 0 && f(at)) {
+        return at;
+      }
+      mask &= mask - 1;
+    }
+  }
+  for (; i + m <= n; ++i) {
+    if (text[i] == pattern[0] && memcmp(text + i, pattern, m) == 0 && f(i)) {
+      return i;
+    }
+  }
+  return n;
+}
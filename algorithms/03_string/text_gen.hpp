@@ -0,0 +1,59 @@
+/**
+ * text_gen.hpp
+ *
+ * Deterministic text for string search tests and benchmarks: a vocabulary
+ * of random lowercase words, and log-like lines built from it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// count random lowercase words of min_len to max_len letters
+inline std::vector<std::string> text_gen_words(size_t count, size_t min_len,
+                                               size_t max_len,
+                                               uint64_t seed = 1) {
+  std::mt19937_64 rng(seed);
+  std::uniform_int_distribution<size_t> len(min_len, max_len);
+  std::uniform_int_distribution<int> letter('a', 'z');
+  std::vector<std::string> words(count);
+  for (std::string& w : words) {
+    w.resize(len(rng));
+    for (char& c : w) {
+      c = char(letter(rng));
+    }
+  }
+  return words;
+}
+
+// about bytes of log lines: a timestamp, a level, a thread tag and a
+// message of 4 to 15 words drawn from vocab
+inline std::string text_gen_log(size_t bytes,
+                                const std::vector<std::string>& vocab,
+                                uint64_t seed = 1) {
+  static const char* levels[] = {"DEBUG", "INFO ", "INFO ", "INFO ", "WARN "};
+  std::mt19937_64 rng(seed);
+  std::string text;
+  text.reserve(bytes + 256);
+  uint64_t millis = 0;
+  char stamp[64];
+  while (text.size() < bytes) {
+    millis += rng() % 50;
+    snprintf(stamp, sizeof stamp, "2026-10-16T%02u:%02u:%02u.%03u %s [w-%02u] ",
+             unsigned(millis / 3600000 % 24), unsigned(millis / 60000 % 60),
+             unsigned(millis / 1000 % 60), unsigned(millis % 1000),
+             levels[rng() % 5], unsigned(rng() % 32));
+    text += stamp;
+    for (size_t w = 0, words = 4 + rng() % 12; w < words; ++w) {
+      text += vocab[rng() % vocab.size()];
+      text += w + 1 < words ? ' ' : '\n';
+    }
+  }
+  text.resize(bytes);
+  return text;
+}
@@ -0,0 +1,230 @@
+/**
+ * lcs.cpp
+ *
+ * Longest common subsequence tests, and benchmarks of the classic table,
+ * the bit-parallel rows and Hirschberg's linear-memory recovery on random
+ * DNA-like strings of 10^4 to 10^6 bytes, with time and peak heap use.
+ */
+
+#include "lcs.hpp"
+#include "testing.hpp"
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// random string over the first `letters` bytes of alphabet
+std::string random_text(size_t n, const std::string& alphabet, size_t letters,
+                        std::mt19937& rng) {
+  std::string s(n, '\0');
+  for (char& c : s) {
+    c = alphabet[rng() % letters];
+  }
+  return s;
+}
+
+// whether sub can be read off s left to right
+bool is_subsequence(std::string_view sub, std::string_view s) {
+  size_t i = 0;
+  for (size_t j = 0; i < sub.size() && j < s.size(); ++j) {
+    i += sub[i] == s[j];
+  }
+  return i == sub.size();
+}
+
+int main(void) {
+  const SimdLevel levels[] = {SimdLevel::SCALAR, SimdLevel::SSE2,
+                              SimdLevel::AVX2};
+  std::string bytes(256, '\0');
+  for (size_t c = 0; c < 256; ++c) {
+    bytes[c] = char(c);
+  }
+
+  // test suite
+  test::TestSuite suite("Longest Common Subsequence Tests");
+
+  suite.add_test("Textbook examples", []() {
+    test::assert_equal(size_t(4), lcs_length("ABCBDAB", "BDCABA"));
+    test::assert_equal(std::string("GTAB"), lcs_dp("AGGTAB", "GXTXAYB"));
+    test::assert_equal(std::string("GTAB"),
+                       lcs_hirschberg("AGGTAB", "GXTXAYB"));
+    test::assert_equal(size_t(4), lcs_length_dp("AGGTAB", "GXTXAYB"));
+    test::assert_equal(size_t(0), lcs_length("", "abc"));
+    test::assert_equal(std::string(""), lcs_dp("abc", ""));
+    test::assert_equal(std::string(""), lcs_hirschberg("abc", "xyz"));
+  });
+
+  suite.add_test("Bit-parallel length matches the table", [&]() {
+    std::mt19937 rng(3);
+    for (SimdLevel level : levels) {
+      simd_set_level(level);
+      // lengths around word and vector boundaries
+      for (size_t n : {0, 1, 63, 64, 65, 255, 256, 257, 700}) {
+        for (size_t letters : {2, 4, 26, 256}) {
+          std::string a = random_text(n, bytes, letters, rng);
+          std::string b = random_text(n / 2 + 300, bytes, letters, rng);
+          size_t want = lcs_length_dp(a, b);
+          test::assert_equal(want, lcs_length(a, b));
+          test::assert_equal(want, lcs_length(b, a));
+        }
+      }
+    }
+    simd_set_level(simd_detect());
+  });
+
+  suite.add_test("Table traceback is a longest common subsequence", [&]() {
+    std::mt19937 rng(5);
+    for (size_t letters : {2, 4, 26}) {
+      std::string a = random_text(400, bytes, letters, rng);
+      std::string b = random_text(300, bytes, letters, rng);
+      std::string sub = lcs_dp(a, b);
+      test::assert_equal(lcs_length_dp(a, b), sub.size());
+      test::assert_true(is_subsequence(sub, a), "Not a subsequence of a");
+      test::assert_true(is_subsequence(sub, b), "Not a subsequence of b");
+    }
+  });
+
+  suite.add_test("Hirschberg finds a longest common subsequence", [&]() {
+    std::mt19937 rng(7);
+    const size_t sizes[][2] = {
+        {3000, 2000}, {2000, 3000}, {1, 500}, {500, 1}, {0, 10}, {777, 1500}};
+    for (SimdLevel level : {SimdLevel::SCALAR, simd_detect()}) {
+      simd_set_level(level);
+      for (size_t letters : {2, 4, 26, 256}) {
+        for (const auto& size : sizes) {
+          std::string a = random_text(size[0], bytes, letters, rng);
+          std::string b = random_text(size[1], bytes, letters, rng);
+          std::string sub = lcs_hirschberg(a, b);
+          test::assert_equal(lcs_length(a, b), sub.size());
+          test::assert_true(is_subsequence(sub, a), "Not a subsequence of a");
+          test::assert_true(is_subsequence(sub, b), "Not a subsequence of b");
+        }
+      }
+    }
+    simd_set_level(simd_detect());
+  });
+
+  suite.add_test("Identical and disjoint strings", [&]() {
+    std::mt19937 rng(9);
+    std::string a = random_text(5000, bytes, 26, rng);
+    test::assert_equal(a.size(), lcs_length(a, a));
+    test::assert_equal(a, lcs_hirschberg(a, a));
+    std::string upper = random_text(5000, "XYZ", 3, rng);
+    test::assert_equal(size_t(0), lcs_length(a, upper));
+    test::assert_equal(std::string(""), lcs_hirschberg(a, upper));
+  });
+
+  suite.add_test("Hirschberg memory is linear", [&]() {
+    std::mt19937 rng(11);
+    std::string a = random_text(20000, "ACGT", 4, rng);
+    std::string b = random_text(20000, "ACGT", 4, rng);
+    test::AllocScope scope;
+    std::string sub = lcs_hirschberg(a, b);
+    if (test::alloc_tracking) {
+      // the table would take 1.6 GB
+      test::assert_true(scope.stats().peak < 20 * (a.size() + b.size()),
+                        "Peak memory is not linear");
+    }
+    test::assert_equal(lcs_length(a, b), sub.size());
+  });
+
+  // error handling tests
+  suite.add_test("Table too large", []() {
+    std::string a(50000, 'a');
+    bool caught_exception = false;
+
+    try {
+      lcs_dp(a, a);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: LCS of two independent random strings over ACGT, whose
+  // LCS is about 65% of their length. ops counts DP cells, n * m, and the
+  // 10^6 case (10^12 cells) runs once per mode.
+  test::Benchmark bench("Longest Common Subsequence Benchmarks");
+  test::Benchmark bench_large("Longest Common Subsequence Benchmarks, 10^6");
+  bench_large.set_warmup(0);
+  bench_large.set_repetitions(1);
+  std::mt19937 rng(1);
+  const size_t sizes[] = {10000, 100000, 1000000};
+  std::vector<std::string> as;
+  std::vector<std::string> bs;
+  for (size_t n : sizes) {
+    as.push_back(random_text(n, "ACGT", 4, rng));
+    bs.push_back(random_text(n, "ACGT", 4, rng));
+  }
+
+  const char* level_names[] = {"scalar", "SSE2", "AVX2"};
+  for (size_t s = 0; s < 3; ++s) {
+    const std::string* a = &as[s];
+    const std::string* b = &bs[s];
+    size_t cells = a->size() * b->size();
+    std::string suffix = ", n = m = " + std::to_string(a->size());
+    test::Benchmark* target = s < 2 ? &bench : &bench_large;
+
+    // the O(nm) modes only at 10^4; at 10^5 the table alone is 40 GB
+    if (s == 0) {
+      target->add_test(
+          "Table with traceback" + suffix,
+          [a, b]() { test::do_not_optimize(lcs_dp(*a, *b)); }, cells);
+      target->add_test(
+          "Two-row table, length" + suffix,
+          [a, b]() { test::do_not_optimize(lcs_length_dp(*a, *b)); }, cells);
+    }
+    for (SimdLevel level : levels) {
+      // SSE2 runs the scalar kernel; at 10^6 only the best level runs
+      if (level == SimdLevel::SSE2 || level > simd_detect() ||
+          (s == 2 && level != simd_detect())) {
+        continue;
+      }
+      target->add_test(
+          std::string("Bit-parallel, length, ") + level_names[int(level)] +
+              suffix,
+          [a, b, level]() {
+            simd_set_level(level);
+            test::do_not_optimize(lcs_length(*a, *b));
+            simd_set_level(simd_detect());
+          },
+          cells);
+    }
+    target->add_test(
+        "Hirschberg with bit-parallel rows" + suffix,
+        [a, b]() { test::do_not_optimize(lcs_hirschberg(*a, *b)); }, cells);
+  }
+
+  // run all benchmarks
+  bench.run();
+  bench_large.run();
+
+  std::cout << "\nThroughput and peak heap (median):" << std::endl;
+  for (const test::Benchmark* b : {&bench, &bench_large}) {
+    for (const test::BenchResult& r : b->results()) {
+      std::cout << "  " << std::fixed << std::setprecision(2) << std::setw(8)
+                << r.ops / r.stats.median << " Gcells/s  " << std::setw(10)
+                << std::setprecision(3)
+                << (test::alloc_tracking ? r.allocs.peak / 1048576.0 : 0)
+                << " MiB  " << r.name << std::defaultfloat << std::endl;
+    }
+  }
+  for (size_t s = 0; s < 3; ++s) {
+    double table = double(sizes[s] + 1) * double(sizes[s] + 1) * 4;
+    std::cout << "  n = m = " << sizes[s]
+              << ": LCS length " << lcs_length(as[s], bs[s])
+              << ", a full table would take " << table / 1073741824.0
+              << " GiB" << std::endl;
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Longest common subsequence program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
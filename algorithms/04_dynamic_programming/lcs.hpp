@@ -0,0 +1,307 @@
+/**
+ * lcs.hpp
+ *
+ * Longest common subsequence of two byte strings, three ways:
+ *
+ *  - lcs_dp fills the classic (n+1) x (m+1) table and walks it back to
+ *    recover a subsequence; lcs_length_dp keeps only two rows of it.
+ *  - lcs_length runs the bit-parallel algorithm of Allison-Dix and Hyyro:
+ *    a DP row over a is held as one bit per column (set where the row does
+ *    not step up), and one add and a few logic ops advance 64 columns per
+ *    word, or 256 per AVX2 vector, picked at runtime like the DArray bulk
+ *    algorithms.
+ *  - lcs_hirschberg recovers a subsequence in O(n + m) memory by splitting
+ *    b in half, scoring both halves against every prefix and suffix of a
+ *    with the bit-parallel rows, and recursing on the best split.
+ */
+
+#pragma once
+
+#include "../../data_structures/00_dynamic_array/darray.hpp"
+#include "../../data_structures/00_dynamic_array/darray_simd.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#define LCS_TABLE_MAX (size_t(1) << 31) // most cells lcs_dp will allocate
+#define LCS_BASE_CELLS 4096 // lcs_hirschberg solves smaller blocks by table
+
+// classic table, traced back from the bottom-right corner
+inline std::string lcs_dp(std::string_view a, std::string_view b) {
+  size_t n = a.size();
+  size_t m = b.size();
+  if (n + 1 > LCS_TABLE_MAX / (m + 1)) {
+    throw std::runtime_error("Table too large");
+  }
+  size_t w = m + 1;
+  DArray<uint32_t> table = darray_create<uint32_t>((n + 1) * w);
+  uint32_t* t = table.data;
+  std::fill(t, t + w, 0);
+  for (size_t i = 1; i <= n; ++i) {
+    t[i * w] = 0;
+    for (size_t j = 1; j <= m; ++j) {
+      t[i * w + j] = a[i - 1] == b[j - 1]
+                         ? t[(i - 1) * w + j - 1] + 1
+                         : std::max(t[(i - 1) * w + j], t[i * w + j - 1]);
+    }
+  }
+
+  std::string out(t[n * w + m], '\0');
+  size_t k = out.size();
+  for (size_t i = n, j = m; k > 0;) {
+    if (a[i - 1] == b[j - 1]) {
+      out[--k] = a[i - 1];
+      --i;
+      --j;
+    } else if (t[(i - 1) * w + j] >= t[i * w + j - 1]) {
+      --i;
+    } else {
+      --j;
+    }
+  }
+  darray_destroy(&table);
+  return out;
+}
+
+// classic recurrence over two rows as wide as the shorter string
+inline size_t lcs_length_dp(std::string_view a, std::string_view b) {
+  if (a.size() < b.size()) {
+    std::swap(a, b);
+  }
+  size_t m = b.size();
+  DArray<uint32_t> rows = darray_create<uint32_t>(2 * (m + 1));
+  uint32_t* prev = rows.data;
+  uint32_t* cur = rows.data + m + 1;
+  std::fill(prev, prev + m + 1, 0);
+  cur[0] = 0;
+  for (char c : a) {
+    for (size_t j = 1; j <= m; ++j) {
+      cur[j] = c == b[j - 1] ? prev[j - 1] + 1 : std::max(prev[j], cur[j - 1]);
+    }
+    std::swap(prev, cur);
+  }
+  size_t len = prev[m];
+  darray_destroy(&rows);
+  return len;
+}
+
+// match masks of a string for the bit-parallel rows: for each byte value
+// in it, a bit per position where that byte occurs
+struct LcsMasks {
+  DArray<uint64_t> bits; // words per class; class 0 (absent bytes) is zero
+  uint16_t classes[256]; // byte -> class
+  size_t words;          // per class, a whole number of AVX2 vectors
+  size_t len;
+};
+
+// masks of a[0, len), or of its reverse
+inline LcsMasks lcs_masks_create(const char* a, size_t len, bool reverse) {
+  LcsMasks masks;
+  std::fill(masks.classes, masks.classes + 256, 0);
+  for (size_t i = 0; i < len; ++i) {
+    masks.classes[uint8_t(a[i])] = 1;
+  }
+  size_t num_classes = 1;
+  for (size_t c = 0; c < 256; ++c) {
+    if (masks.classes[c]) {
+      masks.classes[c] = uint16_t(num_classes++);
+    }
+  }
+  masks.words = (len + 255) / 256 * 4;
+  masks.len = len;
+  size_t total = num_classes * masks.words;
+  masks.bits = darray_create<uint64_t>(total);
+  masks.bits.sz = total;
+  std::fill(masks.bits.data, masks.bits.data + total, 0);
+  for (size_t i = 0; i < len; ++i) {
+    size_t pos = reverse ? len - 1 - i : i;
+    size_t row = masks.classes[uint8_t(a[i])] * masks.words;
+    masks.bits.data[row + pos / 64] |= uint64_t(1) << (pos % 64);
+  }
+  return masks;
+}
+
+inline void lcs_masks_destroy(LcsMasks* masks) {
+  darray_destroy(&masks->bits);
+}
+
+namespace lcs_simd {
+// Each kernel advances the row bits v through n bytes of b, read at
+// b[0], b[step], ...: per byte, with u = v & match,
+// v = (v + u) | (v & ~match), the add carrying across the whole row.
+namespace scalar {
+inline void advance(const LcsMasks* masks, const char* b, size_t n,
+                    ptrdiff_t step, uint64_t* v) {
+  size_t words = masks->words;
+  for (size_t j = 0; j < n; ++j) {
+    const uint64_t* match =
+        masks->bits.data +
+        masks->classes[uint8_t(b[ptrdiff_t(j) * step])] * words;
+    bool carry = false;
+    for (size_t k = 0; k < words; ++k) {
+      uint64_t x = v[k];
+      uint64_t sum;
+      bool c1 = __builtin_add_overflow(x, x & match[k], &sum);
+      bool c2 = __builtin_add_overflow(sum, uint64_t(carry), &sum);
+      carry = c1 | c2;
+      v[k] = sum | (x & ~match[k]);
+    }
+  }
+}
+} // namespace scalar
+
+#ifdef DARRAY_SIMD_X86
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+// The four 64-bit adds of a vector run independently; their carries are
+// resolved afterwards from two 4-bit masks, lanes that overflowed
+// (generate) and lanes that are all ones (propagate), with one scalar
+// add, so only that add is on the chain from vector to vector.
+inline void advance(const LcsMasks* masks, const char* b, size_t n,
+                    ptrdiff_t step, uint64_t* v) {
+  size_t words = masks->words;
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i ones = _mm256_set1_epi64x(-1);
+  const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+  const __m256i one = _mm256_set1_epi64x(1);
+  for (size_t j = 0; j < n; ++j) {
+    const uint64_t* match =
+        masks->bits.data +
+        masks->classes[uint8_t(b[ptrdiff_t(j) * step])] * words;
+    unsigned carry = 0;
+    for (size_t k = 0; k < words; k += 4) {
+      __m256i x = _mm256_loadu_si256((const __m256i*)(v + k));
+      __m256i mk = _mm256_loadu_si256((const __m256i*)(match + k));
+      __m256i sum = _mm256_add_epi64(x, _mm256_and_si256(x, mk));
+      // unsigned sum < x, by flipping the sign bits for a signed compare
+      __m256i over = _mm256_cmpgt_epi64(_mm256_xor_si256(x, sign),
+                                        _mm256_xor_si256(sum, sign));
+      __m256i full = _mm256_cmpeq_epi64(sum, ones);
+      unsigned g = _mm256_movemask_pd(_mm256_castsi256_pd(over));
+      unsigned p = _mm256_movemask_pd(_mm256_castsi256_pd(full));
+      // a carry into a run of all-ones lanes ripples through it
+      unsigned c = ((g << 1 | carry) + p) ^ p;
+      carry = c >> 4 & 1;
+      __m256i inc = _mm256_and_si256(
+          _mm256_srlv_epi64(_mm256_set1_epi64x(c & 15), lane), one);
+      sum = _mm256_add_epi64(sum, inc);
+      _mm256_storeu_si256((__m256i*)(v + k),
+                          _mm256_or_si256(sum, _mm256_andnot_si256(mk, x)));
+    }
+  }
+}
+} // namespace avx2
+#pragma GCC pop_options
+#endif // DARRAY_SIMD_X86
+
+// SSE2 has no 64-bit compare to find lane carries, so it runs scalar
+inline void advance(const LcsMasks* masks, const char* b, size_t n,
+                    ptrdiff_t step, uint64_t* v) {
+#ifdef DARRAY_SIMD_X86
+  if (simd_level() == SimdLevel::AVX2) {
+    return avx2::advance(masks, b, n, step, v);
+  }
+#endif
+  scalar::advance(masks, b, n, step, v);
+}
+} // namespace lcs_simd
+
+// length of the longest common subsequence, 64 or 256 cells per step
+inline size_t lcs_length(std::string_view a, std::string_view b) {
+  if (a.size() > b.size()) {
+    std::swap(a, b);
+  }
+  LcsMasks masks = lcs_masks_create(a.data(), a.size(), false);
+  DArray<uint64_t> v = darray_create<uint64_t>(masks.words);
+  v.sz = masks.words;
+  std::fill(v.data, v.data + v.sz, ~uint64_t(0));
+  lcs_simd::advance(&masks, b.data(), b.size(), 1, v.data);
+
+  // a zero bit below len is a column where the last row steps up
+  size_t ones = 0;
+  for (size_t k = 0; k < a.size() / 64; ++k) {
+    ones += __builtin_popcountll(v.data[k]);
+  }
+  if (a.size() % 64) {
+    uint64_t low = (uint64_t(1) << (a.size() % 64)) - 1;
+    ones += __builtin_popcountll(v.data[a.size() / 64] & low);
+  }
+  darray_destroy(&v);
+  lcs_masks_destroy(&masks);
+  return a.size() - ones;
+}
+
+// out[i] = LCS(a', b') for every prefix a' = a'[0, i) of a' (0 <= i <=
+// len), where a' is a[0, len) and b' is b[0, n), both reversed if reverse
+inline void lcs_prefix_scores(const char* a, size_t len, const char* b,
+                              size_t n, bool reverse, uint32_t* out) {
+  LcsMasks masks = lcs_masks_create(a, len, reverse);
+  DArray<uint64_t> v = darray_create<uint64_t>(masks.words);
+  v.sz = masks.words;
+  std::fill(v.data, v.data + v.sz, ~uint64_t(0));
+  if (reverse) {
+    lcs_simd::advance(&masks, b + n - 1, n, -1, v.data);
+  } else {
+    lcs_simd::advance(&masks, b, n, 1, v.data);
+  }
+  uint32_t score = 0;
+  out[0] = 0;
+  for (size_t i = 0; i < len; ++i) {
+    score += !(v.data[i / 64] >> (i % 64) & 1);
+    out[i + 1] = score;
+  }
+  darray_destroy(&v);
+  lcs_masks_destroy(&masks);
+}
+
+// append an LCS of a and b to out
+inline void lcs_hirschberg_into(std::string_view a, std::string_view b,
+                                std::string* out) {
+  if (a.empty() || b.empty()) {
+    return;
+  }
+  if (b.size() == 1) {
+    if (a.find(b[0]) != std::string_view::npos) {
+      out->push_back(b[0]);
+    }
+    return;
+  }
+  if ((a.size() + 1) * (b.size() + 1) <= LCS_BASE_CELLS) {
+    out->append(lcs_dp(a, b));
+    return;
+  }
+
+  // the best LCS passes from b's first half to its second between a[0, k)
+  // and a[k, len) for the k maximizing the two halves' scores
+  size_t len = a.size();
+  size_t mid = b.size() / 2;
+  DArray<uint32_t> scores = darray_create<uint32_t>(2 * (len + 1));
+  uint32_t* fwd = scores.data;
+  uint32_t* bwd = scores.data + len + 1;
+  lcs_prefix_scores(a.data(), len, b.data(), mid, false, fwd);
+  lcs_prefix_scores(a.data(), len, b.data() + mid, b.size() - mid, true, bwd);
+  size_t split = 0;
+  uint32_t best = 0;
+  for (size_t k = 0; k <= len; ++k) {
+    uint32_t score = fwd[k] + bwd[len - k];
+    if (score > best) {
+      best = score;
+      split = k;
+    }
+  }
+  darray_destroy(&scores);
+
+  lcs_hirschberg_into(a.substr(0, split), b.substr(0, mid), out);
+  lcs_hirschberg_into(a.substr(split), b.substr(mid), out);
+}
+
+// a longest common subsequence in O(n + m) memory
+inline std::string lcs_hirschberg(std::string_view a, std::string_view b) {
+  std::string out;
+  lcs_hirschberg_into(a, b, &out);
+  return out;
+}
@@ -1,85 +1,14 @@
 /**
  * darray.cpp
  *
- * A dynamic array implementation.
+ * Dynamic array tests and benchmarks.
  */
 
+#include "darray.hpp"
 #include "testing.hpp"
-#include <cstdlib>
-#include <cstring>
 #include <iostream>
-
-#define INIT_CAP 16     // initial array capacity
-#define GROWTH_FACTOR 2 // when resizing arrays
-
-template <typename T> struct DArray {
-  T* data;    // pointer to array data
-  size_t sz;  // current number of elements in array
-  size_t cap; // total space allocated
-};
-
-// initialize dynamic array
-template <typename T> DArray<T> darray_create() {
-  DArray<T> arr;
-  arr.data = (T*)malloc(INIT_CAP * sizeof(T));
-  arr.sz = 0;
-  arr.cap = INIT_CAP;
-
-  return arr;
-}
-
-// free memory allocated for array
-template <typename T> void darray_destroy(DArray<T>* arr) {
-  free(arr->data);
-  arr->sz = 0;
-  arr->cap = 0;
-}
-
-// resize array when capacity is reached
-template <typename T> void darray_resize(DArray<T>* arr, size_t new_cap) {
-  T* new_data = (T*)realloc(arr->data, new_cap * sizeof(T));
-  if (new_data) {
-    arr->data = new_data;
-    arr->cap = new_cap;
-  }
-}
-
-// append element to end of array
-template <typename T> void darray_push_back(DArray<T>* arr, T elem) {
-  if (arr->sz == arr->cap) {
-    darray_resize(arr, GROWTH_FACTOR * arr->cap);
-  }
-  arr->data[arr->sz++] = elem;
-}
-
-// remove and return element from end of array
-template <typename T> T darray_pop_back(DArray<T>* arr) {
-  if (arr->sz == 0) {
-    throw std::runtime_error("Cannot pop from empty array");
-  }
-  return arr->data[--arr->sz];
-}
-
-// get element at index
-template <typename T> T darray_get(const DArray<T>* arr, size_t idx) {
-  if (idx >= arr->sz || idx < 0) {
-    throw std::runtime_error("Index out of bounds");
-  }
-  return arr->data[idx];
-}
-
-// set element at index
-template <typename T> void darray_set(DArray<T>* arr, size_t idx, T elem) {
-  if (idx >= arr->sz || idx < 0) {
-    throw std::runtime_error("Index out of bounds");
-  }
-  arr->data[idx] = elem;
-}
-
-// get current size of array
-template <typename T> size_t darray_size(const DArray<T>* arr) {
-  return arr->sz;
-}
+#include <list>
+#include <string>
 
 int main(void) {
   // test suite
@@ -161,6 +90,104 @@ int main(void) {
     darray_destroy(&arr);
   });
 
+  suite.add_test("Creation with capacity", []() {
+    auto arr = darray_create<int>(100);
+    test::assert_equal(size_t(100), arr.cap);
+    darray_destroy(&arr);
+
+    auto empty = darray_create<int>(0);
+    darray_push_back(&empty, 7);
+    test::assert_equal(size_t(INIT_CAP), empty.cap);
+    darray_destroy(&empty);
+  });
+
+  suite.add_test("Reserve and shrink to fit", []() {
+    auto arr = darray_create<int>();
+    darray_reserve(&arr, 1000);
+    test::assert_equal(size_t(1000), arr.cap);
+
+    int* data = arr.data;
+    for (int i = 0; i < 1000; ++i) {
+      darray_push_back(&arr, i);
+    }
+    test::assert_true(data == arr.data, "Reserved array reallocated");
+
+    darray_pop_back(&arr);
+    darray_shrink_to_fit(&arr);
+    test::assert_equal(size_t(999), arr.cap);
+    test::assert_equal(998, darray_get(&arr, 998));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Non-trivial element type", []() {
+    auto arr = darray_create<std::string>();
+    for (int i = 0; i < INIT_CAP * GROWTH_FACTOR + 1; ++i) {
+      darray_push_back(&arr, std::string(32, 'a' + i % 26));
+    }
+    test::assert_equal(std::string(32, 'a'), darray_get(&arr, 0));
+    test::assert_equal(std::string(32, 'a' + INIT_CAP % 26),
+                       darray_get(&arr, INIT_CAP));
+
+    darray_set(&arr, 1, std::string("Socrates"));
+    test::assert_equal(std::string("Socrates"), darray_get(&arr, 1));
+    test::assert_equal(std::string(32, 'a' + INIT_CAP * GROWTH_FACTOR % 26),
+                       darray_pop_back(&arr));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Move-only element type", []() {
+    auto arr = darray_create<std::unique_ptr<int>>();
+    for (int i = 0; i < INIT_CAP + 1; ++i) {
+      darray_push_back(&arr, std::make_unique<int>(i));
+    }
+    test::assert_equal(7, *darray_get(&arr, 7));
+    test::assert_equal(INIT_CAP, *darray_pop_back(&arr));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Emplace back", []() {
+    auto arr = darray_create<std::string>();
+    darray_emplace_back(&arr, 3, 'x');
+    std::string& back = darray_emplace_back(&arr, "Plato");
+    test::assert_equal(std::string("xxx"), darray_get(&arr, 0));
+    test::assert_equal(std::string("Plato"), back);
+
+    // element referring into the array while it grows
+    while (darray_size(&arr) < arr.cap) {
+      darray_emplace_back(&arr, "filler");
+    }
+    darray_push_back(&arr, darray_get(&arr, 1));
+    test::assert_equal(std::string("Plato"),
+                       darray_get(&arr, darray_size(&arr) - 1));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Bulk append", []() {
+    auto arr = darray_create<int>();
+    std::vector<int> vals(100);
+    for (int i = 0; i < 100; ++i) {
+      vals[i] = i;
+    }
+    darray_push_back(&arr, -1);
+    darray_append(&arr, vals.begin(), vals.end());
+    test::assert_equal(size_t(101), darray_size(&arr));
+    test::assert_equal(size_t(101), arr.cap);
+    test::assert_equal(99, darray_get(&arr, 100));
+
+    // single-pass input falls back to repeated push back
+    std::list<std::string> names = {"Plato", "Aristotle"};
+    auto strs = darray_create<std::string>();
+    darray_append(&strs, names.begin(), names.end());
+    test::assert_equal(std::string("Aristotle"), darray_get(&strs, 1));
+
+    darray_destroy(&arr);
+    darray_destroy(&strs);
+  });
+
   // error handling tests
   suite.add_test("Pop from empty array", []() {
     auto arr = darray_create<int>();
@@ -204,46 +231,102 @@ int main(void) {
 
   // benchmarking
   test::Benchmark bench("Dynamic Array Benchmarks");
+  bench.enable_counters();
+  const int n = 100000;
+
+  bench.add_test(
+      "Push back performance",
+      []() {
+        auto arr = darray_create<int>();
+        for (int i = 0; i < n; ++i) {
+          darray_push_back(&arr, i);
+        }
+        test::do_not_optimize(arr.data);
+
+        darray_destroy(&arr);
+      },
+      n);
+
+  bench.add_test(
+      "Push and pop performance",
+      []() {
+        auto arr = darray_create<int>();
+        for (int i = 0; i < n; ++i) {
+          darray_push_back(&arr, i);
+        }
+        while (darray_size(&arr) > 0) {
+          test::do_not_optimize(darray_pop_back(&arr));
+        }
+
+        darray_destroy(&arr);
+      },
+      2 * n);
+
+  // keep setup out of the timed region
+  auto rand_arr = darray_create<int>();
+  for (int i = 0; i < n; ++i) {
+    darray_push_back(&rand_arr, i);
+  }
+  test::RandomGenerator gen;
+  auto rand_idxs = gen.generate_ints(10000, 0, n - 1);
+
+  bench.add_test(
+      "Random access performance",
+      [&]() {
+        for (size_t i = 0; i < rand_idxs.size(); ++i) {
+          test::do_not_optimize(darray_get(&rand_arr, rand_idxs[i]));
+        }
+      },
+      rand_idxs.size());
+
+  bench.add_test(
+      "Push back with reserve performance",
+      []() {
+        auto arr = darray_create<int>();
+        darray_reserve(&arr, n);
+        for (int i = 0; i < n; ++i) {
+          darray_push_back(&arr, i);
+        }
+        test::do_not_optimize(arr.data);
+
+        darray_destroy(&arr);
+      },
+      n);
+
+  std::vector<int> batch(n);
+  for (int i = 0; i < n; ++i) {
+    batch[i] = i;
+  }
 
-  bench.add_test("Push back performance", []() {
-    auto arr = darray_create<int>();
-    for (int i = 0; i < 100000; ++i) {
-      darray_push_back(&arr, i);
-    }
-
-    darray_destroy(&arr);
-  });
-
-  bench.add_test("Push and pop performance", []() {
-    auto arr = darray_create<int>();
-    for (int i = 0; i < 100000; ++i) {
-      darray_push_back(&arr, i);
-    }
-    while (darray_size(&arr) > 0) {
-      darray_pop_back(&arr);
-    }
-
-    darray_destroy(&arr);
-  });
+  bench.add_test(
+      "Bulk append performance",
+      [&]() {
+        auto arr = darray_create<int>(batch.size());
+        darray_append(&arr, batch.begin(), batch.end());
+        test::do_not_optimize(arr.data);
 
-  bench.add_test("Random access performance", []() {
-    auto arr = darray_create<int>();
-    test::RandomGenerator gen;
+        darray_destroy(&arr);
+      },
+      n);
 
-    for (int i = 0; i < 100000; ++i) {
-      darray_push_back(&arr, i);
-    }
+  auto words = gen.generate_strings(10000, 8, 32);
 
-    auto rand_idxs = gen.generate_ints(10000, 0, 99999);
-    for (size_t i = 0; i < rand_idxs.size(); ++i) {
-      darray_get(&arr, rand_idxs[i]);
-    }
+  bench.add_test(
+      "String push back performance",
+      [&]() {
+        auto arr = darray_create<std::string>();
+        for (const auto& word : words) {
+          darray_push_back(&arr, word);
+        }
+        test::do_not_optimize(arr.data);
 
-    darray_destroy(&arr);
-  });
+        darray_destroy(&arr);
+      },
+      words.size());
 
   // run all benchmarks
   bench.run();
+  darray_destroy(&rand_arr);
 
   std::cout << "\n" << std::string(50, '=') << std::endl;
   std::cout << "Dynamic array program is complete." << std::endl;
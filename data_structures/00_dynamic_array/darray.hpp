@@ -0,0 +1,197 @@
+/**
+ * darray.hpp
+ *
+ * A dynamic array implementation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#define INIT_CAP 16     // initial array capacity
+#define GROWTH_FACTOR 2 // when resizing arrays
+
+template <typename T> struct DArray {
+  T* data;    // pointer to array data
+  size_t sz;  // current number of elements in array
+  size_t cap; // total space allocated
+};
+
+// elements that may be moved with realloc/memcpy instead of constructors
+template <typename T>
+inline constexpr bool darray_bitwise_relocatable =
+    std::is_trivially_copyable_v<T>;
+
+// initialize dynamic array
+template <typename T> DArray<T> darray_create(size_t cap = INIT_CAP) {
+  static_assert(alignof(T) <= alignof(std::max_align_t),
+                "DArray storage comes from malloc");
+  DArray<T> arr;
+  arr.data = cap ? (T*)malloc(cap * sizeof(T)) : nullptr;
+  if (cap && !arr.data) {
+    throw std::bad_alloc();
+  }
+  arr.sz = 0;
+  arr.cap = cap;
+
+  return arr;
+}
+
+// free memory allocated for array
+template <typename T> void darray_destroy(DArray<T>* arr) {
+  std::destroy(arr->data, arr->data + arr->sz);
+  free(arr->data);
+  arr->data = nullptr;
+  arr->sz = 0;
+  arr->cap = 0;
+}
+
+// move sz elements into a new block of new_cap (> 0) elements, freeing the
+// old block; takes raw fields so callers' arrays can stay in registers
+template <typename T> T* darray_relocate(T* data, size_t sz, size_t new_cap) {
+  if constexpr (darray_bitwise_relocatable<T>) {
+    T* new_data = (T*)realloc(data, new_cap * sizeof(T));
+    if (!new_data) {
+      throw std::bad_alloc();
+    }
+    return new_data;
+  } else {
+    T* new_data = (T*)malloc(new_cap * sizeof(T));
+    if (!new_data) {
+      throw std::bad_alloc();
+    }
+    // copy instead of move if a throwing move could lose elements
+    try {
+      if constexpr (std::is_nothrow_move_constructible_v<T> ||
+                    !std::is_copy_constructible_v<T>) {
+        std::uninitialized_move(data, data + sz, new_data);
+      } else {
+        std::uninitialized_copy(data, data + sz, new_data);
+      }
+    } catch (...) {
+      free(new_data);
+      throw;
+    }
+    std::destroy(data, data + sz);
+    free(data);
+    return new_data;
+  }
+}
+
+// change capacity to new_cap (>= size), relocating elements
+template <typename T> void darray_resize(DArray<T>* arr, size_t new_cap) {
+  if (new_cap < arr->sz) {
+    throw std::runtime_error("Capacity smaller than size");
+  }
+  if (new_cap == arr->cap) {
+    return;
+  }
+  if (new_cap == 0) {
+    free(arr->data);
+    arr->data = nullptr;
+  } else {
+    arr->data = darray_relocate(arr->data, arr->sz, new_cap);
+  }
+  arr->cap = new_cap;
+}
+
+// capacity to grow to when at least min_cap elements are needed
+template <typename T>
+size_t darray_grown_cap(const DArray<T>* arr, size_t min_cap) {
+  size_t cap = arr->cap ? GROWTH_FACTOR * arr->cap : INIT_CAP;
+  return cap < min_cap ? min_cap : cap;
+}
+
+// ensure capacity for at least cap elements
+template <typename T> void darray_reserve(DArray<T>* arr, size_t cap) {
+  if (cap > arr->cap) {
+    darray_resize(arr, cap);
+  }
+}
+
+// release unused capacity
+template <typename T> void darray_shrink_to_fit(DArray<T>* arr) {
+  darray_resize(arr, arr->sz);
+}
+
+// construct element in place at end of array
+template <typename T, typename... Args>
+T& darray_emplace_back(DArray<T>* arr, Args&&... args) {
+  if (arr->sz == arr->cap) {
+    // args may refer into the array, so build the element before growing
+    T elem(std::forward<Args>(args)...);
+    size_t new_cap = darray_grown_cap(arr, arr->sz + 1);
+    arr->data = darray_relocate(arr->data, arr->sz, new_cap);
+    arr->cap = new_cap;
+    return *new (arr->data + arr->sz++) T(std::move(elem));
+  }
+  return *new (arr->data + arr->sz++) T(std::forward<Args>(args)...);
+}
+
+// append element to end of array
+template <typename T> void darray_push_back(DArray<T>* arr, const T& elem) {
+  darray_emplace_back(arr, elem);
+}
+
+template <typename T> void darray_push_back(DArray<T>* arr, T&& elem) {
+  darray_emplace_back(arr, std::move(elem));
+}
+
+// append range [first, last) to end of array; the range must not alias arr
+template <typename T, typename It>
+void darray_append(DArray<T>* arr, It first, It last) {
+  using Category = typename std::iterator_traits<It>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+    // size once, then copy in a single pass
+    size_t n = std::distance(first, last);
+    if (arr->sz + n > arr->cap) {
+      size_t new_cap = darray_grown_cap(arr, arr->sz + n);
+      arr->data = darray_relocate(arr->data, arr->sz, new_cap);
+      arr->cap = new_cap;
+    }
+    std::uninitialized_copy(first, last, arr->data + arr->sz);
+    arr->sz += n;
+  } else {
+    for (; first != last; ++first) {
+      darray_emplace_back(arr, *first);
+    }
+  }
+}
+
+// remove and return element from end of array
+template <typename T> T darray_pop_back(DArray<T>* arr) {
+  if (arr->sz == 0) {
+    throw std::runtime_error("Cannot pop from empty array");
+  }
+  T elem = std::move(arr->data[--arr->sz]);
+  std::destroy_at(arr->data + arr->sz);
+  return elem;
+}
+
+// get element at index
+template <typename T> const T& darray_get(const DArray<T>* arr, size_t idx) {
+  if (idx >= arr->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  return arr->data[idx];
+}
+
+// set element at index
+template <typename T> void darray_set(DArray<T>* arr, size_t idx, T elem) {
+  if (idx >= arr->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  arr->data[idx] = std::move(elem);
+}
+
+// get current size of array
+template <typename T> size_t darray_size(const DArray<T>* arr) {
+  return arr->sz;
+}
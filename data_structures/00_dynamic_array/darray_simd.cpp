@@ -0,0 +1,247 @@
+/**
+ * darray_simd.cpp
+ *
+ * Tests and benchmarks for the vectorized dynamic array algorithms.
+ */
+
+#include "darray_simd.hpp"
+#include "testing.hpp"
+#include <iostream>
+#include <string>
+
+// instruction sets available on this machine, lowest first
+std::vector<SimdLevel> available_levels() {
+  std::vector<SimdLevel> levels = {SimdLevel::SCALAR};
+  if (simd_detect() >= SimdLevel::SSE2) {
+    levels.push_back(SimdLevel::SSE2);
+  }
+  if (simd_detect() >= SimdLevel::AVX2) {
+    levels.push_back(SimdLevel::AVX2);
+  }
+  return levels;
+}
+
+const char* level_name(SimdLevel level) {
+  switch (level) {
+  case SimdLevel::AVX2:
+    return "avx2";
+  case SimdLevel::SSE2:
+    return "sse2";
+  default:
+    return "scalar";
+  }
+}
+
+// fill array with values from ints converted to T
+template <typename T>
+DArray<T> make_array(const std::vector<int>& ints, T scale = T(1)) {
+  auto arr = darray_create<T>(ints.size());
+  for (int x : ints) {
+    darray_push_back(&arr, static_cast<T>(x * scale));
+  }
+  return arr;
+}
+
+// compare every algorithm against a straightforward loop, at every level and
+// at lengths that exercise the scalar tails
+template <typename T> void check_algorithms(T scale) {
+  test::RandomGenerator gen;
+  for (SimdLevel level : available_levels()) {
+    simd_set_level(level);
+    std::string where = std::string(" at ") + level_name(level);
+
+    for (size_t len : {1, 3, 7, 8, 9, 31, 64, 1001}) {
+      auto ints = gen.generate_ints(len, -50, 50);
+      auto arr = make_array<T>(ints, scale);
+      T needle = arr.data[len / 2];
+
+      size_t first = len;
+      size_t matches = 0;
+      darray_sum_t<T> total = 0;
+      T lo = arr.data[0];
+      T hi = arr.data[0];
+      for (size_t i = 0; i < len; ++i) {
+        if (arr.data[i] == needle) {
+          first = std::min(first, i);
+          ++matches;
+        }
+        total += arr.data[i];
+        lo = std::min(lo, arr.data[i]);
+        hi = std::max(hi, arr.data[i]);
+      }
+
+      test::assert_equal(first, darray_find(&arr, needle), "find" + where);
+      test::assert_equal(len, darray_find(&arr, static_cast<T>(100 * scale)),
+                         "find absent" + where);
+      test::assert_equal(matches, darray_count(&arr, needle), "count" + where);
+      test::assert_equal(total, darray_sum(&arr), "sum" + where);
+      test::assert_equal(lo, darray_min(&arr), "min" + where);
+      test::assert_equal(hi, darray_max(&arr), "max" + where);
+
+      for (DArrayCmp op : {DArrayCmp::EQ, DArrayCmp::NE, DArrayCmp::LT,
+                           DArrayCmp::LE, DArrayCmp::GT, DArrayCmp::GE}) {
+        auto out = darray_create<T>();
+        darray_push_back(&out, T(7));
+        darray_filter(&arr, &out, op, needle);
+
+        size_t kept = 1;
+        for (size_t i = 0; i < len; ++i) {
+          if (darray_cmp_apply(arr.data[i], op, needle)) {
+            test::assert_true(kept < out.sz && out.data[kept] == arr.data[i],
+                              "filter" + where);
+            ++kept;
+          }
+        }
+        test::assert_equal(kept, out.sz, "filter size" + where);
+        test::assert_equal(T(7), out.data[0], "filter kept prefix" + where);
+        darray_destroy(&out);
+      }
+
+      darray_fill(&arr, needle);
+      test::assert_equal(len, darray_count(&arr, needle), "fill" + where);
+      darray_destroy(&arr);
+    }
+  }
+  simd_set_level(simd_detect());
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Dynamic Array SIMD Tests");
+
+  suite.add_test("Integer algorithms", []() { check_algorithms<int>(1); });
+
+  suite.add_test("Float algorithms", []() { check_algorithms<float>(0.5f); });
+
+  suite.add_test("Double algorithms", []() { check_algorithms<double>(0.25); });
+
+  suite.add_test("Scalar fallback types", []() {
+    check_algorithms<int64_t>(1);
+    check_algorithms<int16_t>(1);
+  });
+
+  suite.add_test("Predicate filter", []() {
+    auto arr = darray_create<int>();
+    for (int i = 0; i < 100; ++i) {
+      darray_push_back(&arr, i);
+    }
+    auto evens = darray_create<int>();
+    darray_filter_if(&arr, &evens, [](int x) { return x % 2 == 0; });
+    test::assert_equal(size_t(50), darray_size(&evens));
+    test::assert_equal(98, darray_get(&evens, 49));
+
+    darray_destroy(&arr);
+    darray_destroy(&evens);
+  });
+
+  suite.add_test("Integer sum does not overflow", []() {
+    auto arr = darray_create<int>();
+    for (int i = 0; i < 1000; ++i) {
+      darray_push_back(&arr, 2000000000);
+    }
+    for (SimdLevel level : available_levels()) {
+      simd_set_level(level);
+      test::assert_equal(int64_t(2000000000) * 1000, darray_sum(&arr));
+    }
+    simd_set_level(simd_detect());
+
+    darray_destroy(&arr);
+  });
+
+  // error handling tests
+  suite.add_test("Min of empty array", []() {
+    auto arr = darray_create<int>();
+    bool caught_exception = false;
+
+    try {
+      darray_min(&arr);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    darray_destroy(&arr);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: one large scan per call, at every instruction set
+  test::Benchmark bench("Dynamic Array SIMD Benchmarks");
+  const size_t n = 10000000;
+
+  test::RandomGenerator gen;
+  auto ints = gen.generate_ints(n, -1000, 1000);
+  auto arr = make_array<int>(ints);
+  auto out = darray_create<int>(n + 8);
+
+  bench.add_test(
+      "darray_get sum loop",
+      [&]() {
+        int64_t total = 0;
+        for (size_t i = 0; i < darray_size(&arr); ++i) {
+          total += darray_get(&arr, i);
+        }
+        test::do_not_optimize(total);
+      },
+      n);
+
+  for (SimdLevel level : available_levels()) {
+    std::string suffix = std::string(" (") + level_name(level) + ")";
+
+    bench.add_test(
+        "Sum" + suffix,
+        [&, level]() {
+          simd_set_level(level);
+          test::do_not_optimize(darray_sum(&arr));
+        },
+        n);
+
+    bench.add_test(
+        "Count" + suffix,
+        [&, level]() {
+          simd_set_level(level);
+          test::do_not_optimize(darray_count(&arr, 7));
+        },
+        n);
+
+    bench.add_test(
+        "Find absent" + suffix,
+        [&, level]() {
+          simd_set_level(level);
+          test::do_not_optimize(darray_find(&arr, 5000));
+        },
+        n);
+
+    bench.add_test(
+        "Min" + suffix,
+        [&, level]() {
+          simd_set_level(level);
+          test::do_not_optimize(darray_min(&arr));
+        },
+        n);
+
+    bench.add_test(
+        "Filter half" + suffix,
+        [&, level]() {
+          simd_set_level(level);
+          out.sz = 0;
+          darray_filter(&arr, &out, DArrayCmp::LT, 0);
+          test::do_not_optimize(out.sz);
+        },
+        n);
+  }
+
+  // run all benchmarks
+  bench.run();
+  simd_set_level(simd_detect());
+  darray_destroy(&arr);
+  darray_destroy(&out);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Dynamic array SIMD program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,652 @@
+/**
+ * darray_simd.hpp
+ *
+ * Vectorized bulk algorithms over DArray<T> for arithmetic element types.
+ * int32_t, float and double have SSE2 and AVX2 kernels picked at runtime;
+ * every other arithmetic type, and non-x86 targets, use scalar loops.
+ */
+
+#pragma once
+
+#include "darray.hpp"
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DARRAY_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// comparison applied by darray_filter
+enum class DArrayCmp { EQ, NE, LT, LE, GT, GE };
+
+// instruction sets the kernels can run on
+enum class SimdLevel { SCALAR, SSE2, AVX2 };
+
+// integers are summed in 64 bits, floating types in double
+template <typename T>
+using darray_sum_t =
+    std::conditional_t<std::is_floating_point_v<T>, double,
+                       std::conditional_t<std::is_signed_v<T>, int64_t,
+                                          uint64_t>>;
+
+template <typename T> inline bool darray_cmp_apply(T a, DArrayCmp op, T b) {
+  switch (op) {
+  case DArrayCmp::EQ:
+    return a == b;
+  case DArrayCmp::NE:
+    return !(a == b);
+  case DArrayCmp::LT:
+    return a < b;
+  case DArrayCmp::LE:
+    return a <= b;
+  case DArrayCmp::GT:
+    return a > b;
+  case DArrayCmp::GE:
+    return a >= b;
+  }
+  return false;
+}
+
+// best instruction set supported by this cpu
+inline SimdLevel simd_detect() {
+#ifdef DARRAY_SIMD_X86
+  __builtin_cpu_init(); // may run before libgcc's own constructor
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::AVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return SimdLevel::SSE2;
+  }
+#endif
+  return SimdLevel::SCALAR;
+}
+
+namespace darray_simd {
+inline SimdLevel level = simd_detect();
+} // namespace darray_simd
+
+// instruction set currently used by the bulk algorithms
+inline SimdLevel simd_level() { return darray_simd::level; }
+
+// force a lower instruction set (for testing and benchmarking)
+inline void simd_set_level(SimdLevel level) {
+  SimdLevel best = simd_detect();
+  darray_simd::level = level > best ? best : level;
+}
+
+namespace darray_simd {
+// element types with vector kernels
+template <typename T>
+inline constexpr bool vectorized = std::is_same_v<T, int32_t> ||
+                                   std::is_same_v<T, float> ||
+                                   std::is_same_v<T, double>;
+
+namespace scalar {
+template <typename T> size_t find(const T* data, size_t n, T value) {
+  for (size_t i = 0; i < n; ++i) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+  return n;
+}
+
+template <typename T> size_t count(const T* data, size_t n, T value) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    total += data[i] == value;
+  }
+  return total;
+}
+
+template <typename T> darray_sum_t<T> sum(const T* data, size_t n) {
+  darray_sum_t<T> total = 0;
+  for (size_t i = 0; i < n; ++i) {
+    total += data[i];
+  }
+  return total;
+}
+
+template <typename T> T min(const T* data, size_t n) {
+  T best = data[0];
+  for (size_t i = 1; i < n; ++i) {
+    best = data[i] < best ? data[i] : best;
+  }
+  return best;
+}
+
+template <typename T> T max(const T* data, size_t n) {
+  T best = data[0];
+  for (size_t i = 1; i < n; ++i) {
+    best = data[i] > best ? data[i] : best;
+  }
+  return best;
+}
+
+template <typename T> void fill(T* data, size_t n, T value) {
+  for (size_t i = 0; i < n; ++i) {
+    data[i] = value;
+  }
+}
+
+// branchless: always write, advance only on a match
+template <typename T, typename Pred>
+size_t filter_if(const T* data, size_t n, T* out, Pred pred) {
+  size_t kept = 0;
+  for (size_t i = 0; i < n; ++i) {
+    out[kept] = data[i];
+    kept += pred(data[i]) ? 1 : 0;
+  }
+  return kept;
+}
+
+template <typename T>
+size_t filter(const T* data, size_t n, T* out, DArrayCmp op, T value) {
+  return filter_if(data, n, out,
+                   [op, value](T x) { return darray_cmp_apply(x, op, value); });
+}
+} // namespace scalar
+
+#ifdef DARRAY_SIMD_X86
+// write the lanes selected by mask from src, returning how many were kept;
+// branchless, so every lane is written and up to `lanes` slots are touched
+template <size_t lanes, typename T>
+inline unsigned compress_scalar(T* out, const T* src, unsigned mask) {
+  unsigned kept = 0;
+  for (size_t lane = 0; lane < lanes; ++lane) {
+    out[kept] = src[lane];
+    kept += (mask >> lane) & 1u;
+  }
+  return kept;
+}
+
+namespace sse2 {
+template <typename T> struct OpsFor;
+
+template <> struct OpsFor<int32_t> {
+  using V = __m128i;
+  static constexpr size_t lanes = 4;
+
+  static V load(const int32_t* p) { return _mm_loadu_si128((const V*)p); }
+  static void store(int32_t* p, V v) { _mm_storeu_si128((V*)p, v); }
+  static V set1(int32_t x) { return _mm_set1_epi32(x); }
+
+  static unsigned cmp_mask(V a, V b, DArrayCmp op) {
+    V m;
+    bool negate = false;
+    switch (op) {
+    case DArrayCmp::NE:
+      negate = true;
+      [[fallthrough]];
+    case DArrayCmp::EQ:
+      m = _mm_cmpeq_epi32(a, b);
+      break;
+    case DArrayCmp::GE:
+      negate = true;
+      [[fallthrough]];
+    case DArrayCmp::LT:
+      m = _mm_cmplt_epi32(a, b);
+      break;
+    case DArrayCmp::LE:
+      negate = true;
+      [[fallthrough]];
+    default:
+      m = _mm_cmpgt_epi32(a, b);
+      break;
+    }
+    unsigned bits = _mm_movemask_ps(_mm_castsi128_ps(m));
+    return negate ? ~bits & 0xf : bits;
+  }
+
+  // no pminsd/pmaxsd before sse4.1, so select through a comparison
+  static V min(V a, V b) {
+    V gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+  }
+  static V max(V a, V b) {
+    V gt = _mm_cmpgt_epi32(a, b);
+    return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+  }
+  static int32_t reduce_min(V v) {
+    alignas(16) int32_t lane[lanes];
+    _mm_store_si128((V*)lane, v);
+    return scalar::min(lane, lanes);
+  }
+  static int32_t reduce_max(V v) {
+    alignas(16) int32_t lane[lanes];
+    _mm_store_si128((V*)lane, v);
+    return scalar::max(lane, lanes);
+  }
+
+  // sign-extend to two vectors of 64-bit lanes
+  static V acc_zero() { return _mm_setzero_si128(); }
+  static V acc_add(V acc, V v) {
+    V sign = _mm_srai_epi32(v, 31);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+  }
+  static int64_t acc_reduce(V acc) {
+    alignas(16) int64_t lane[2];
+    _mm_store_si128((V*)lane, acc);
+    return lane[0] + lane[1];
+  }
+
+  static unsigned compress_store(int32_t* out, V, const int32_t* src,
+                                 unsigned mask) {
+    return compress_scalar<lanes>(out, src, mask);
+  }
+};
+
+template <> struct OpsFor<float> {
+  using V = __m128;
+  static constexpr size_t lanes = 4;
+
+  static V load(const float* p) { return _mm_loadu_ps(p); }
+  static void store(float* p, V v) { _mm_storeu_ps(p, v); }
+  static V set1(float x) { return _mm_set1_ps(x); }
+
+  static unsigned cmp_mask(V a, V b, DArrayCmp op) {
+    switch (op) {
+    case DArrayCmp::EQ:
+      return _mm_movemask_ps(_mm_cmpeq_ps(a, b));
+    case DArrayCmp::NE:
+      return _mm_movemask_ps(_mm_cmpneq_ps(a, b));
+    case DArrayCmp::LT:
+      return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+    case DArrayCmp::LE:
+      return _mm_movemask_ps(_mm_cmple_ps(a, b));
+    case DArrayCmp::GT:
+      return _mm_movemask_ps(_mm_cmpgt_ps(a, b));
+    default:
+      return _mm_movemask_ps(_mm_cmpge_ps(a, b));
+    }
+  }
+
+  static V min(V a, V b) { return _mm_min_ps(a, b); }
+  static V max(V a, V b) { return _mm_max_ps(a, b); }
+  static float reduce_min(V v) {
+    alignas(16) float lane[lanes];
+    _mm_store_ps(lane, v);
+    return scalar::min(lane, lanes);
+  }
+  static float reduce_max(V v) {
+    alignas(16) float lane[lanes];
+    _mm_store_ps(lane, v);
+    return scalar::max(lane, lanes);
+  }
+
+  // widen to double before adding
+  static __m128d acc_zero() { return _mm_setzero_pd(); }
+  static __m128d acc_add(__m128d acc, V v) {
+    acc = _mm_add_pd(acc, _mm_cvtps_pd(v));
+    return _mm_add_pd(acc, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+  }
+  static double acc_reduce(__m128d acc) {
+    alignas(16) double lane[2];
+    _mm_store_pd(lane, acc);
+    return lane[0] + lane[1];
+  }
+
+  static unsigned compress_store(float* out, V, const float* src,
+                                 unsigned mask) {
+    return compress_scalar<lanes>(out, src, mask);
+  }
+};
+
+template <> struct OpsFor<double> {
+  using V = __m128d;
+  static constexpr size_t lanes = 2;
+
+  static V load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, V v) { _mm_storeu_pd(p, v); }
+  static V set1(double x) { return _mm_set1_pd(x); }
+
+  static unsigned cmp_mask(V a, V b, DArrayCmp op) {
+    switch (op) {
+    case DArrayCmp::EQ:
+      return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+    case DArrayCmp::NE:
+      return _mm_movemask_pd(_mm_cmpneq_pd(a, b));
+    case DArrayCmp::LT:
+      return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+    case DArrayCmp::LE:
+      return _mm_movemask_pd(_mm_cmple_pd(a, b));
+    case DArrayCmp::GT:
+      return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+    default:
+      return _mm_movemask_pd(_mm_cmpge_pd(a, b));
+    }
+  }
+
+  static V min(V a, V b) { return _mm_min_pd(a, b); }
+  static V max(V a, V b) { return _mm_max_pd(a, b); }
+  static double reduce_min(V v) {
+    alignas(16) double lane[lanes];
+    _mm_store_pd(lane, v);
+    return scalar::min(lane, lanes);
+  }
+  static double reduce_max(V v) {
+    alignas(16) double lane[lanes];
+    _mm_store_pd(lane, v);
+    return scalar::max(lane, lanes);
+  }
+
+  static V acc_zero() { return _mm_setzero_pd(); }
+  static V acc_add(V acc, V v) { return _mm_add_pd(acc, v); }
+  static double acc_reduce(V acc) {
+    alignas(16) double lane[2];
+    _mm_store_pd(lane, acc);
+    return lane[0] + lane[1];
+  }
+
+  static unsigned compress_store(double* out, V, const double* src,
+                                 unsigned mask) {
+    return compress_scalar<lanes>(out, src, mask);
+  }
+};
+
+#include "darray_simd_kernels.hpp"
+} // namespace sse2
+
+// permutation indices moving the lanes selected by an 8-bit mask to the front
+struct CompressTable {
+  uint32_t idx[256][8];
+};
+
+constexpr CompressTable make_compress_table() {
+  CompressTable table{};
+  for (unsigned mask = 0; mask < 256; ++mask) {
+    unsigned kept = 0;
+    for (unsigned lane = 0; lane < 8; ++lane) {
+      if (mask & (1u << lane)) {
+        table.idx[mask][kept++] = lane;
+      }
+    }
+  }
+  return table;
+}
+
+alignas(32) inline constexpr CompressTable compress_table =
+    make_compress_table();
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2 {
+template <typename T> struct OpsFor;
+
+// 8-bit lane mask of a 32-bit-lane comparison, optionally negated
+inline unsigned mask_ps(__m256 m, bool negate) {
+  unsigned bits = _mm256_movemask_ps(m);
+  return negate ? ~bits & 0xff : bits;
+}
+
+// store the 32-bit lanes selected by mask contiguously at out
+inline unsigned compress_store_32(void* out, __m256 v, unsigned mask) {
+  __m256i perm = _mm256_loadu_si256((const __m256i*)compress_table.idx[mask]);
+  _mm256_storeu_ps((float*)out, _mm256_permutevar8x32_ps(v, perm));
+  return __builtin_popcount(mask);
+}
+
+template <> struct OpsFor<int32_t> {
+  using V = __m256i;
+  static constexpr size_t lanes = 8;
+
+  static V load(const int32_t* p) { return _mm256_loadu_si256((const V*)p); }
+  static void store(int32_t* p, V v) { _mm256_storeu_si256((V*)p, v); }
+  static V set1(int32_t x) { return _mm256_set1_epi32(x); }
+
+  static unsigned cmp_mask(V a, V b, DArrayCmp op) {
+    switch (op) {
+    case DArrayCmp::EQ:
+      return mask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)), false);
+    case DArrayCmp::NE:
+      return mask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)), true);
+    case DArrayCmp::LT:
+      return mask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)), false);
+    case DArrayCmp::LE:
+      return mask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)), true);
+    case DArrayCmp::GT:
+      return mask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)), false);
+    default:
+      return mask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(b, a)), true);
+    }
+  }
+
+  static V min(V a, V b) { return _mm256_min_epi32(a, b); }
+  static V max(V a, V b) { return _mm256_max_epi32(a, b); }
+  static int32_t reduce_min(V v) {
+    alignas(32) int32_t lane[lanes];
+    _mm256_store_si256((V*)lane, v);
+    return scalar::min(lane, lanes);
+  }
+  static int32_t reduce_max(V v) {
+    alignas(32) int32_t lane[lanes];
+    _mm256_store_si256((V*)lane, v);
+    return scalar::max(lane, lanes);
+  }
+
+  static V acc_zero() { return _mm256_setzero_si256(); }
+  static V acc_add(V acc, V v) {
+    acc = _mm256_add_epi64(
+        acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+    return _mm256_add_epi64(
+        acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+  }
+  static int64_t acc_reduce(V acc) {
+    alignas(32) int64_t lane[4];
+    _mm256_store_si256((V*)lane, acc);
+    return lane[0] + lane[1] + lane[2] + lane[3];
+  }
+
+  static unsigned compress_store(int32_t* out, V v, const int32_t*,
+                                 unsigned mask) {
+    return compress_store_32(out, _mm256_castsi256_ps(v), mask);
+  }
+};
+
+template <> struct OpsFor<float> {
+  using V = __m256;
+  static constexpr size_t lanes = 8;
+
+  static V load(const float* p) { return _mm256_loadu_ps(p); }
+  static void store(float* p, V v) { _mm256_storeu_ps(p, v); }
+  static V set1(float x) { return _mm256_set1_ps(x); }
+
+  static unsigned cmp_mask(V a, V b, DArrayCmp op) {
+    switch (op) {
+    case DArrayCmp::EQ:
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+    case DArrayCmp::NE:
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_NEQ_UQ));
+    case DArrayCmp::LT:
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+    case DArrayCmp::LE:
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LE_OQ));
+    case DArrayCmp::GT:
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ));
+    default:
+      return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GE_OQ));
+    }
+  }
+
+  static V min(V a, V b) { return _mm256_min_ps(a, b); }
+  static V max(V a, V b) { return _mm256_max_ps(a, b); }
+  static float reduce_min(V v) {
+    alignas(32) float lane[lanes];
+    _mm256_store_ps(lane, v);
+    return scalar::min(lane, lanes);
+  }
+  static float reduce_max(V v) {
+    alignas(32) float lane[lanes];
+    _mm256_store_ps(lane, v);
+    return scalar::max(lane, lanes);
+  }
+
+  static __m256d acc_zero() { return _mm256_setzero_pd(); }
+  static __m256d acc_add(__m256d acc, V v) {
+    acc = _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+    return _mm256_add_pd(acc, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+  }
+  static double acc_reduce(__m256d acc) {
+    alignas(32) double lane[4];
+    _mm256_store_pd(lane, acc);
+    return lane[0] + lane[1] + lane[2] + lane[3];
+  }
+
+  static unsigned compress_store(float* out, V v, const float*,
+                                 unsigned mask) {
+    return compress_store_32(out, v, mask);
+  }
+};
+
+template <> struct OpsFor<double> {
+  using V = __m256d;
+  static constexpr size_t lanes = 4;
+
+  static V load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, V v) { _mm256_storeu_pd(p, v); }
+  static V set1(double x) { return _mm256_set1_pd(x); }
+
+  static unsigned cmp_mask(V a, V b, DArrayCmp op) {
+    switch (op) {
+    case DArrayCmp::EQ:
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+    case DArrayCmp::NE:
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_NEQ_UQ));
+    case DArrayCmp::LT:
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ));
+    case DArrayCmp::LE:
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LE_OQ));
+    case DArrayCmp::GT:
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ));
+    default:
+      return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GE_OQ));
+    }
+  }
+
+  static V min(V a, V b) { return _mm256_min_pd(a, b); }
+  static V max(V a, V b) { return _mm256_max_pd(a, b); }
+  static double reduce_min(V v) {
+    alignas(32) double lane[lanes];
+    _mm256_store_pd(lane, v);
+    return scalar::min(lane, lanes);
+  }
+  static double reduce_max(V v) {
+    alignas(32) double lane[lanes];
+    _mm256_store_pd(lane, v);
+    return scalar::max(lane, lanes);
+  }
+
+  static V acc_zero() { return _mm256_setzero_pd(); }
+  static V acc_add(V acc, V v) { return _mm256_add_pd(acc, v); }
+  static double acc_reduce(V acc) {
+    alignas(32) double lane[4];
+    _mm256_store_pd(lane, acc);
+    return lane[0] + lane[1] + lane[2] + lane[3];
+  }
+
+  // a 64-bit lane is a pair of 32-bit lanes: widen each mask bit to two
+  static unsigned compress_store(double* out, V v, const double*,
+                                 unsigned mask) {
+    unsigned wide = 0;
+    for (unsigned lane = 0; lane < lanes; ++lane) {
+      wide |= ((mask >> lane) & 1u) * (3u << (2 * lane));
+    }
+    return compress_store_32(out, _mm256_castpd_ps(v), wide) / 2;
+  }
+};
+
+#include "darray_simd_kernels.hpp"
+} // namespace avx2
+#pragma GCC pop_options
+#endif // DARRAY_SIMD_X86
+} // namespace darray_simd
+
+// run the best available kernel for T
+#ifdef DARRAY_SIMD_X86
+#define DARRAY_SIMD_DISPATCH(T, call)                                          \
+  do {                                                                         \
+    if constexpr (darray_simd::vectorized<T>) {                                \
+      if (simd_level() == SimdLevel::AVX2) {                                   \
+        return darray_simd::avx2::call;                                        \
+      }                                                                        \
+      if (simd_level() == SimdLevel::SSE2) {                                   \
+        return darray_simd::sse2::call;                                        \
+      }                                                                        \
+    }                                                                          \
+    return darray_simd::scalar::call;                                          \
+  } while (0)
+#else
+#define DARRAY_SIMD_DISPATCH(T, call) return darray_simd::scalar::call
+#endif
+
+// index of first element equal to value, or size if absent
+template <typename T> size_t darray_find(const DArray<T>* arr, T value) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  DARRAY_SIMD_DISPATCH(T, find(arr->data, arr->sz, value));
+}
+
+// number of elements equal to value
+template <typename T> size_t darray_count(const DArray<T>* arr, T value) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  DARRAY_SIMD_DISPATCH(T, count(arr->data, arr->sz, value));
+}
+
+// sum of all elements (64-bit integer or double accumulator)
+template <typename T> darray_sum_t<T> darray_sum(const DArray<T>* arr) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  DARRAY_SIMD_DISPATCH(T, sum(arr->data, arr->sz));
+}
+
+// smallest element; result is unspecified if the array holds NaNs
+template <typename T> T darray_min(const DArray<T>* arr) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  if (arr->sz == 0) {
+    throw std::runtime_error("Cannot take min of empty array");
+  }
+  DARRAY_SIMD_DISPATCH(T, min(arr->data, arr->sz));
+}
+
+// largest element; result is unspecified if the array holds NaNs
+template <typename T> T darray_max(const DArray<T>* arr) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  if (arr->sz == 0) {
+    throw std::runtime_error("Cannot take max of empty array");
+  }
+  DARRAY_SIMD_DISPATCH(T, max(arr->data, arr->sz));
+}
+
+// set every element to value
+template <typename T> void darray_fill(DArray<T>* arr, T value) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  DARRAY_SIMD_DISPATCH(T, fill(arr->data, arr->sz, value));
+}
+
+// reserve room in dst for every element of src plus one vector of slack
+template <typename T>
+void darray_filter_reserve(DArray<T>* dst, const DArray<T>* src) {
+  darray_reserve(dst, dst->sz + src->sz + 32 / sizeof(T));
+}
+
+// append elements x of src with `x op value` to dst (dst != src)
+template <typename T>
+void darray_filter(const DArray<T>* src, DArray<T>* dst, DArrayCmp op,
+                   T value) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  darray_filter_reserve(dst, src);
+  T* out = dst->data + dst->sz;
+  size_t kept = [&]() -> size_t {
+    DARRAY_SIMD_DISPATCH(T, filter(src->data, src->sz, out, op, value));
+  }();
+  dst->sz += kept;
+}
+
+// append elements of src satisfying pred to dst (dst != src)
+template <typename T, typename Pred>
+void darray_filter_if(const DArray<T>* src, DArray<T>* dst, Pred pred) {
+  static_assert(std::is_arithmetic_v<T>, "Bulk algorithms need numbers");
+  darray_filter_reserve(dst, src);
+  dst->sz += darray_simd::scalar::filter_if(src->data, src->sz,
+                                            dst->data + dst->sz, pred);
+}
@@ -0,0 +1,127 @@
+/**
+ * darray_simd_kernels.hpp
+ *
+ * Vectorized kernel bodies shared by every instruction set. This file has no
+ * include guard on purpose: darray_simd.hpp includes it once inside each
+ * per-ISA namespace, after defining OpsFor<T> for that ISA, so the same code
+ * is compiled once per target.
+ */
+
+// index of first element equal to value, or n if absent
+template <typename T> size_t find(const T* data, size_t n, T value) {
+  using Ops = OpsFor<T>;
+  auto needle = Ops::set1(value);
+  size_t i = 0;
+  for (; i + Ops::lanes <= n; i += Ops::lanes) {
+    unsigned mask = Ops::cmp_mask(Ops::load(data + i), needle, DArrayCmp::EQ);
+    if (mask) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  for (; i < n; ++i) {
+    if (data[i] == value) {
+      return i;
+    }
+  }
+  return n;
+}
+
+// number of elements equal to value
+template <typename T> size_t count(const T* data, size_t n, T value) {
+  using Ops = OpsFor<T>;
+  auto needle = Ops::set1(value);
+  size_t total = 0;
+  size_t i = 0;
+  for (; i + Ops::lanes <= n; i += Ops::lanes) {
+    total += __builtin_popcount(
+        Ops::cmp_mask(Ops::load(data + i), needle, DArrayCmp::EQ));
+  }
+  for (; i < n; ++i) {
+    total += data[i] == value;
+  }
+  return total;
+}
+
+// sum of all elements in the widened accumulator type
+template <typename T> darray_sum_t<T> sum(const T* data, size_t n) {
+  using Ops = OpsFor<T>;
+  auto acc = Ops::acc_zero();
+  size_t i = 0;
+  for (; i + Ops::lanes <= n; i += Ops::lanes) {
+    acc = Ops::acc_add(acc, Ops::load(data + i));
+  }
+  darray_sum_t<T> total = Ops::acc_reduce(acc);
+  for (; i < n; ++i) {
+    total += data[i];
+  }
+  return total;
+}
+
+// smallest element (n > 0)
+template <typename T> T min(const T* data, size_t n) {
+  using Ops = OpsFor<T>;
+  T best = data[0];
+  size_t i = 0;
+  if (n >= Ops::lanes) {
+    auto acc = Ops::load(data);
+    for (i = Ops::lanes; i + Ops::lanes <= n; i += Ops::lanes) {
+      acc = Ops::min(acc, Ops::load(data + i));
+    }
+    best = Ops::reduce_min(acc);
+  }
+  for (; i < n; ++i) {
+    best = data[i] < best ? data[i] : best;
+  }
+  return best;
+}
+
+// largest element (n > 0)
+template <typename T> T max(const T* data, size_t n) {
+  using Ops = OpsFor<T>;
+  T best = data[0];
+  size_t i = 0;
+  if (n >= Ops::lanes) {
+    auto acc = Ops::load(data);
+    for (i = Ops::lanes; i + Ops::lanes <= n; i += Ops::lanes) {
+      acc = Ops::max(acc, Ops::load(data + i));
+    }
+    best = Ops::reduce_max(acc);
+  }
+  for (; i < n; ++i) {
+    best = data[i] > best ? data[i] : best;
+  }
+  return best;
+}
+
+// set every element to value
+template <typename T> void fill(T* data, size_t n, T value) {
+  using Ops = OpsFor<T>;
+  auto v = Ops::set1(value);
+  size_t i = 0;
+  for (; i + Ops::lanes <= n; i += Ops::lanes) {
+    Ops::store(data + i, v);
+  }
+  for (; i < n; ++i) {
+    data[i] = value;
+  }
+}
+
+// copy elements satisfying `x op value` to out, returning how many; out
+// needs room for n + Ops::lanes elements since full vectors are stored
+template <typename T>
+size_t filter(const T* data, size_t n, T* out, DArrayCmp op, T value) {
+  using Ops = OpsFor<T>;
+  auto rhs = Ops::set1(value);
+  size_t kept = 0;
+  size_t i = 0;
+  for (; i + Ops::lanes <= n; i += Ops::lanes) {
+    auto v = Ops::load(data + i);
+    kept += Ops::compress_store(out + kept, v, data + i,
+                                Ops::cmp_mask(v, rhs, op));
+  }
+  for (; i < n; ++i) {
+    out[kept] = data[i];
+    kept += darray_cmp_apply(data[i], op, value);
+  }
+  return kept;
+}
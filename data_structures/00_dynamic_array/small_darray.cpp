@@ -0,0 +1,201 @@
+/**
+ * small_darray.cpp
+ *
+ * Small-buffer dynamic array tests and benchmarks.
+ */
+
+#include "small_darray.hpp"
+#include "testing.hpp"
+#include <iostream>
+#include <string>
+
+#define INLINE_CAP 8 // inline capacity used by tests and benchmarks
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Small Dynamic Array Tests");
+
+  suite.add_test("Initialization", []() {
+    SmallDArray<int, INLINE_CAP> arr;
+    darray_init(&arr);
+    test::assert_equal(size_t(0), darray_size(&arr));
+    test::assert_equal(size_t(INLINE_CAP), arr.cap);
+    test::assert_true(darray_is_inline(&arr));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Push back and pop back inline", []() {
+    SmallDArray<int, INLINE_CAP> arr;
+    darray_init(&arr);
+    for (int i = 0; i < INLINE_CAP; ++i) {
+      darray_push_back(&arr, i);
+    }
+    test::assert_true(darray_is_inline(&arr), "Spilled before overflow");
+    test::assert_equal(size_t(INLINE_CAP), darray_size(&arr));
+    test::assert_equal(INLINE_CAP - 1, darray_pop_back(&arr));
+    test::assert_equal(0, darray_get(&arr, 0));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Spill to heap", []() {
+    SmallDArray<int, INLINE_CAP> arr;
+    darray_init(&arr);
+    for (int i = 0; i < 4 * INLINE_CAP + 1; ++i) {
+      darray_push_back(&arr, i);
+    }
+    test::assert_false(darray_is_inline(&arr));
+    test::assert_equal(size_t(4 * INLINE_CAP + 1), darray_size(&arr));
+    for (int i = 0; i < 4 * INLINE_CAP + 1; ++i) {
+      test::assert_equal(i, darray_get(&arr, i));
+    }
+
+    darray_destroy(&arr);
+    test::assert_true(darray_is_inline(&arr), "Destroy did not reset");
+  });
+
+  suite.add_test("Get and set", []() {
+    SmallDArray<int, INLINE_CAP> arr;
+    darray_init(&arr);
+    darray_push_back(&arr, 1);
+    darray_push_back(&arr, 3);
+
+    darray_set(&arr, 1, 69);
+    test::assert_equal(69, darray_get(&arr, 1));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Non-trivial element type", []() {
+    SmallDArray<std::string, 2> arr;
+    darray_init(&arr);
+    darray_push_back(&arr, std::string(32, 'a'));
+    darray_emplace_back(&arr, "Plato");
+    darray_push_back(&arr, darray_get(&arr, 1)); // spills while aliasing
+    test::assert_false(darray_is_inline(&arr));
+    test::assert_equal(std::string(32, 'a'), darray_get(&arr, 0));
+    test::assert_equal(std::string("Plato"), darray_get(&arr, 2));
+
+    darray_destroy(&arr);
+  });
+
+  suite.add_test("Reserve", []() {
+    SmallDArray<int, INLINE_CAP> arr;
+    darray_init(&arr);
+    darray_reserve(&arr, INLINE_CAP);
+    test::assert_true(darray_is_inline(&arr));
+    darray_reserve(&arr, 100);
+    test::assert_false(darray_is_inline(&arr));
+    test::assert_equal(size_t(100), arr.cap);
+
+    darray_destroy(&arr);
+  });
+
+  // error handling tests
+  suite.add_test("Pop from empty array", []() {
+    SmallDArray<int, INLINE_CAP> arr;
+    darray_init(&arr);
+    bool caught_exception = false;
+
+    try {
+      darray_pop_back(&arr);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  suite.add_test("Out of bounds access", []() {
+    SmallDArray<int, INLINE_CAP> arr;
+    darray_init(&arr);
+    darray_push_back(&arr, 7);
+    bool caught_exception = false;
+
+    try {
+      darray_get(&arr, 1);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    darray_destroy(&arr);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: many short-lived arrays, the common small case
+  test::Benchmark bench("Small Dynamic Array Benchmarks");
+  const int arrays = 10000;
+  const int small = 4; // fits inline
+  const int large = 4 * INLINE_CAP;
+
+  bench.add_test(
+      "Heap array small push back",
+      []() {
+        for (int a = 0; a < arrays; ++a) {
+          auto arr = darray_create<int>();
+          for (int i = 0; i < small; ++i) {
+            darray_push_back(&arr, i);
+          }
+          test::do_not_optimize(arr.data);
+          darray_destroy(&arr);
+        }
+      },
+      arrays);
+
+  bench.add_test(
+      "Small array small push back",
+      []() {
+        for (int a = 0; a < arrays; ++a) {
+          SmallDArray<int, INLINE_CAP> arr;
+          darray_init(&arr);
+          for (int i = 0; i < small; ++i) {
+            darray_push_back(&arr, i);
+          }
+          test::do_not_optimize(arr.data);
+          darray_destroy(&arr);
+        }
+      },
+      arrays);
+
+  bench.add_test(
+      "Heap array spilling push back",
+      []() {
+        for (int a = 0; a < arrays; ++a) {
+          auto arr = darray_create<int>();
+          for (int i = 0; i < large; ++i) {
+            darray_push_back(&arr, i);
+          }
+          test::do_not_optimize(arr.data);
+          darray_destroy(&arr);
+        }
+      },
+      arrays);
+
+  bench.add_test(
+      "Small array spilling push back",
+      []() {
+        for (int a = 0; a < arrays; ++a) {
+          SmallDArray<int, INLINE_CAP> arr;
+          darray_init(&arr);
+          for (int i = 0; i < large; ++i) {
+            darray_push_back(&arr, i);
+          }
+          test::do_not_optimize(arr.data);
+          darray_destroy(&arr);
+        }
+      },
+      arrays);
+
+  // run all benchmarks
+  bench.run();
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Small dynamic array program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
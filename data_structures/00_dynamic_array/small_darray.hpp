@@ -0,0 +1,140 @@
+/**
+ * small_darray.hpp
+ *
+ * A dynamic array that keeps its first N elements inline and only spills to
+ * the heap on overflow.
+ */
+
+#pragma once
+
+#include "darray.hpp"
+
+template <typename T, size_t N> struct SmallDArray {
+  static_assert(N > 0, "Inline capacity must be positive");
+
+  T* data;    // points at buf until the array spills to the heap
+  size_t sz;  // current number of elements in array
+  size_t cap; // total space available
+  alignas(T) unsigned char buf[N * sizeof(T)]; // inline storage
+
+  SmallDArray() = default;
+  SmallDArray(const SmallDArray&) = delete; // data may point into buf
+  SmallDArray& operator=(const SmallDArray&) = delete;
+};
+
+// initialize small array in place (it must not be moved afterwards)
+template <typename T, size_t N> void darray_init(SmallDArray<T, N>* arr) {
+  arr->data = reinterpret_cast<T*>(arr->buf);
+  arr->sz = 0;
+  arr->cap = N;
+}
+
+// true while elements still live in the inline buffer
+template <typename T, size_t N>
+bool darray_is_inline(const SmallDArray<T, N>* arr) {
+  return arr->data == reinterpret_cast<const T*>(arr->buf);
+}
+
+// free heap memory, if any, and reset to the empty inline state
+template <typename T, size_t N> void darray_destroy(SmallDArray<T, N>* arr) {
+  std::destroy(arr->data, arr->data + arr->sz);
+  if (!darray_is_inline(arr)) {
+    free(arr->data);
+  }
+  darray_init(arr);
+}
+
+// grow capacity to new_cap, moving inline elements to the heap if needed
+template <typename T, size_t N>
+void darray_resize(SmallDArray<T, N>* arr, size_t new_cap) {
+  if (new_cap <= arr->cap) {
+    return;
+  }
+  if (!darray_is_inline(arr)) {
+    arr->data = darray_relocate(arr->data, arr->sz, new_cap);
+    arr->cap = new_cap;
+    return;
+  }
+
+  T* heap = (T*)malloc(new_cap * sizeof(T));
+  if (!heap) {
+    throw std::bad_alloc();
+  }
+  try {
+    if constexpr (std::is_nothrow_move_constructible_v<T> ||
+                  !std::is_copy_constructible_v<T>) {
+      std::uninitialized_move(arr->data, arr->data + arr->sz, heap);
+    } else {
+      std::uninitialized_copy(arr->data, arr->data + arr->sz, heap);
+    }
+  } catch (...) {
+    free(heap);
+    throw;
+  }
+  std::destroy(arr->data, arr->data + arr->sz);
+  arr->data = heap;
+  arr->cap = new_cap;
+}
+
+// ensure capacity for at least cap elements
+template <typename T, size_t N>
+void darray_reserve(SmallDArray<T, N>* arr, size_t cap) {
+  darray_resize(arr, cap);
+}
+
+// construct element in place at end of array
+template <typename T, size_t N, typename... Args>
+T& darray_emplace_back(SmallDArray<T, N>* arr, Args&&... args) {
+  if (arr->sz == arr->cap) {
+    // args may refer into the array, so build the element before growing
+    T elem(std::forward<Args>(args)...);
+    darray_resize(arr, GROWTH_FACTOR * arr->cap);
+    return *new (arr->data + arr->sz++) T(std::move(elem));
+  }
+  return *new (arr->data + arr->sz++) T(std::forward<Args>(args)...);
+}
+
+// append element to end of array
+template <typename T, size_t N>
+void darray_push_back(SmallDArray<T, N>* arr, const T& elem) {
+  darray_emplace_back(arr, elem);
+}
+
+template <typename T, size_t N>
+void darray_push_back(SmallDArray<T, N>* arr, T&& elem) {
+  darray_emplace_back(arr, std::move(elem));
+}
+
+// remove and return element from end of array
+template <typename T, size_t N> T darray_pop_back(SmallDArray<T, N>* arr) {
+  if (arr->sz == 0) {
+    throw std::runtime_error("Cannot pop from empty array");
+  }
+  T elem = std::move(arr->data[--arr->sz]);
+  std::destroy_at(arr->data + arr->sz);
+  return elem;
+}
+
+// get element at index
+template <typename T, size_t N>
+const T& darray_get(const SmallDArray<T, N>* arr, size_t idx) {
+  if (idx >= arr->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  return arr->data[idx];
+}
+
+// set element at index
+template <typename T, size_t N>
+void darray_set(SmallDArray<T, N>* arr, size_t idx, T elem) {
+  if (idx >= arr->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  arr->data[idx] = std::move(elem);
+}
+
+// get current size of array
+template <typename T, size_t N>
+size_t darray_size(const SmallDArray<T, N>* arr) {
+  return arr->sz;
+}
@@ -1,99 +1,35 @@
 /**
  * dll.cpp
  *
- * A doubly-linked list implementation.
+ * Doubly-linked list tests and benchmarks.
  */
 
+#include "dll.hpp"
+#include "sll.hpp"
 #include "testing.hpp"
 #include <cstdlib>
 #include <iostream>
+#include <vector>
 
-template <typename T> struct Node {
-  T data;
-  Node<T>* next; // pointer to next node
-};
-
-// initialize new node
-template <typename T> Node<T>* node_create(T data) {
-  Node<T>* new_node = new Node<T>;
-  if (!new_node) {
-    std::cerr << "Memory allocation failed\n";
-    exit(EXIT_FAILURE);
+// values of an int list, front to back
+std::vector<int> dlist_values(DList* list) {
+  std::vector<int> values;
+  for (DLink* link = dlist_front(list); link; link = dlist_next(list, link)) {
+    values.push_back(dlist_entry<DNode<int>>(link)->data);
   }
-  new_node->data = data;
-  new_node->next = nullptr;
-
-  return new_node;
-}
-
-// add node to head of list
-template <typename T> Node<T>* prepend(Node<T>* head, T data) {
-  Node<T> new_node = node_create(data);
-  new_node->next = head;
-
-  return new_node;
-}
-
-// add node to tail of list
-template <typename T> Node<T>* append(Node<T>* head, T data) {
-  if (!head) { // list is empty (no head)
-    return create_node(data);
-  }
-
-  Node<T>* current = head;
-  while (current->next) { // find tail
-    current = current->next;
-  }
-  current->next = create_node(data);
-
-  return head;
-}
-
-// remove first node with given data
-template <typename T> Node<T> node_remove(Node<T>* head, T data) {
-  if (!head) {
-    return nullptr;
-  }
-
-  if (head->data == data) {
-    Node<T>* new_head = head->next;
-    delete head;
-    return new_head;
-  }
-
-  Node<T>* current = head;
-  while (current->next && current->next->data != data) {
-    current = current->next;
-  }
-
-  if (current->next) {
-    Node<T>* target_node = current->next;
-    current->next = target_node->next;
-    delete target_node;
-  }
-  return head;
+  return values;
 }
 
-// traverse and print entire list
-template <typename T> void traverse(Node<T>* head) {
-  if (!head) {
-    std::cout << "List: ";
-    Node<T>* current = head;
-    while (current) {
-      std::cout << current->data << " -> ";
-      current = current->next;
+// true if every prev pointer mirrors a next pointer
+bool dlist_consistent(DList* list) {
+  size_t count = 0;
+  for (DLink* link = list->head.next; link != &list->head; link = link->next) {
+    if (link->next->prev != link) {
+      return false;
     }
-    std::cout << "NULL" << std::endl;
-  }
-}
-
-// free list
-template <typename T> void free_list(Node<T>* head) {
-  while (head) {
-    Node<T>* temp = head;
-    head = head->next;
-    delete temp;
+    count++;
   }
+  return count == list->sz && list->head.next->prev == &list->head;
 }
 
 // driver program
@@ -101,15 +37,156 @@ int main(void) {
   // test suite
   test::TestSuite suite("Doubly-Linked List Tests");
 
+  suite.add_test("Empty list operations", []() {
+    DList list;
+    dlist_init(&list);
+    test::assert_true(dlist_empty(&list));
+    test::assert_true(dlist_front(&list) == nullptr);
+    test::assert_true(dlist_pop_back(&list) == nullptr);
+    test::assert_false(dlist_remove(&list, 1));
+
+    dlist_free<int>(&list);
+  });
+
+  suite.add_test("Basic operations", []() {
+    DList list;
+    dlist_init(&list);
+    dlist_append(&list, 3);
+    dlist_prepend(&list, 1);
+    dlist_append(&list, 7);
+    test::assert_equal(size_t(3), dlist_size(&list));
+    test::assert_true(dlist_values(&list) == std::vector<int>{1, 3, 7});
+
+    test::assert_true(dlist_remove(&list, 3));
+    test::assert_true(dlist_values(&list) == std::vector<int>{1, 7});
+    test::assert_equal(7, dlist_entry<DNode<int>>(dlist_back(&list))->data);
+    test::assert_true(dlist_consistent(&list));
+
+    dlist_free<int>(&list);
+  });
+
+  suite.add_test("Unlink and move to front by node", []() {
+    DList list;
+    dlist_init(&list);
+    std::vector<DNode<int>*> nodes;
+    for (int i = 0; i < 5; ++i) {
+      nodes.push_back(dlist_append(&list, i));
+    }
+
+    dlist_move_to_front(&list, nodes[3]);
+    test::assert_true(dlist_values(&list) == std::vector<int>{3, 0, 1, 2, 4});
+    dlist_move_to_front(&list, nodes[3]); // already first
+    dlist_move_to_front(&list, nodes[4]); // last
+    test::assert_true(dlist_values(&list) == std::vector<int>{4, 3, 0, 1, 2});
+
+    dlist_unlink(&list, nodes[0]);
+    delete nodes[0];
+    test::assert_true(dlist_values(&list) == std::vector<int>{4, 3, 1, 2});
+    test::assert_true(dlist_consistent(&list));
+
+    dlist_free<int>(&list);
+  });
+
+  suite.add_test("Splice", []() {
+    DList a;
+    DList b;
+    dlist_init(&a);
+    dlist_init(&b);
+    DNode<int>* two = nullptr;
+    for (int i = 0; i < 3; ++i) {
+      DNode<int>* node = dlist_append(&a, i);
+      two = i == 2 ? node : two;
+      dlist_append(&b, 10 + i);
+    }
+
+    // splice into the middle, then onto the end of an empty list
+    dlist_splice(&a, two, &b);
+    test::assert_true(dlist_values(&a) ==
+                      std::vector<int>{0, 1, 10, 11, 12, 2});
+    test::assert_true(dlist_empty(&b) && dlist_consistent(&b));
+    dlist_splice(&b, &b.head, &a);
+    test::assert_equal(size_t(6), dlist_size(&b));
+    test::assert_true(dlist_empty(&a));
+    test::assert_true(dlist_consistent(&b));
+
+    dlist_free<int>(&b);
+  });
+
+  suite.add_test("String operations", []() {
+    DList list;
+    dlist_init(&list);
+    dlist_append(&list, std::string("Plato"));
+    dlist_append(&list, std::string("Aristotle"));
+    dlist_append(&list, std::string("Alexander the Great"));
+    dlist_prepend(&list, std::string("Socrates"));
+    test::assert_true(dlist_find(&list, std::string("Aristotle")) != nullptr);
+
+    dlist_free<std::string>(&list);
+  });
+
   // run all tests
   suite.run();
 
-  // benchmarks
+  // benchmarks: removing a known node, O(1) here and O(n) in a singly-
+  // linked list, which must first find the predecessor
   test::Benchmark bench("Doubly-Linked List Benchmarks");
+  const int n = 100000;
+
+  DList list;
+  dlist_init(&list);
+  std::vector<DNode<int>*> nodes;
+  Node<int>* sll = nullptr;
+  for (int i = n - 1; i >= 0; --i) {
+    nodes.push_back(dlist_prepend(&list, i));
+    sll = prepend(sll, i);
+  }
+  DNode<int>* middle = nodes[n / 2];
+
+  bench.add_test("Unlink and reinsert middle node", [&]() {
+    DLink* pos = middle->next;
+    dlist_unlink(&list, middle);
+    dlist_insert_before(&list, pos, middle);
+    test::do_not_optimize(list.sz);
+  });
+
+  bench.add_test("Move middle node to front and back", [&]() {
+    DLink* pos = middle->next;
+    dlist_move_to_front(&list, middle);
+    dlist_unlink(&list, middle);
+    dlist_insert_before(&list, pos, middle);
+    test::do_not_optimize(list.sz);
+  });
+
+  bench.add_test("Singly-linked remove and reinsert middle", [&]() {
+    sll = node_remove(sll, n / 2);
+    Node<int>* prev = sll;
+    for (int i = 1; i < n / 2; ++i) {
+      prev = prev->next;
+    }
+    Node<int>* node = node_create(n / 2);
+    node->next = prev->next;
+    prev->next = node;
+    test::do_not_optimize(sll);
+  });
+
+  bench.add_test(
+      "Traverse list",
+      [&]() {
+        long sum = 0;
+        for (DLink* link = dlist_front(&list); link;
+             link = dlist_next(&list, link)) {
+          sum += dlist_entry<DNode<int>>(link)->data;
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
 
   // run all benchmarks
   bench.run();
 
+  dlist_free<int>(&list);
+  free_list(sll);
+
   std::cout << "\n" << std::string(50, '=') << std::endl;
   std::cout << "Doubly-linked list program is complete." << std::endl;
   std::cout << "" << std::string(50, '=') << std::endl;
@@ -0,0 +1,192 @@
+/**
+ * dll.hpp
+ *
+ * An intrusive doubly-linked list. Elements embed a DLink (usually by
+ * deriving from it), so unlink, move-to-front and splice are O(1) given
+ * the element and never allocate. DNode<T> wraps a plain value for
+ * ordinary list use.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iostream>
+#include <utility>
+
+// links embedded in every element
+struct DLink {
+  DLink* prev;
+  DLink* next;
+};
+
+// circular list around a sentinel; an empty list links to itself, so no
+// operation has to special-case the ends
+struct DList {
+  DLink head; // sentinel, never an element
+  size_t sz;
+
+  DList() = default;
+  DList(const DList&) = delete; // elements point at head
+  DList& operator=(const DList&) = delete;
+};
+
+// initialize empty list in place (it must not be moved afterwards)
+inline void dlist_init(DList* list) {
+  list->head.prev = &list->head;
+  list->head.next = &list->head;
+  list->sz = 0;
+}
+
+inline bool dlist_empty(const DList* list) { return list->sz == 0; }
+
+inline size_t dlist_size(const DList* list) { return list->sz; }
+
+// first and last elements, or nullptr if empty
+inline DLink* dlist_front(DList* list) {
+  return list->sz ? list->head.next : nullptr;
+}
+
+inline DLink* dlist_back(DList* list) {
+  return list->sz ? list->head.prev : nullptr;
+}
+
+// element after link, or nullptr at the end of the list
+inline DLink* dlist_next(DList* list, DLink* link) {
+  return link->next == &list->head ? nullptr : link->next;
+}
+
+// insert link before pos (pos may be the sentinel)
+inline void dlist_insert_before(DList* list, DLink* pos, DLink* link) {
+  link->prev = pos->prev;
+  link->next = pos;
+  pos->prev->next = link;
+  pos->prev = link;
+  list->sz++;
+}
+
+inline void dlist_push_front(DList* list, DLink* link) {
+  dlist_insert_before(list, list->head.next, link);
+}
+
+inline void dlist_push_back(DList* list, DLink* link) {
+  dlist_insert_before(list, &list->head, link);
+}
+
+// remove link from the list it is on
+inline void dlist_unlink(DList* list, DLink* link) {
+  link->prev->next = link->next;
+  link->next->prev = link->prev;
+  link->prev = link->next = nullptr;
+  list->sz--;
+}
+
+// remove and return first or last element, or nullptr if empty
+inline DLink* dlist_pop_front(DList* list) {
+  DLink* link = dlist_front(list);
+  if (link) {
+    dlist_unlink(list, link);
+  }
+  return link;
+}
+
+inline DLink* dlist_pop_back(DList* list) {
+  DLink* link = dlist_back(list);
+  if (link) {
+    dlist_unlink(list, link);
+  }
+  return link;
+}
+
+// make link, already on list, the first element
+inline void dlist_move_to_front(DList* list, DLink* link) {
+  if (list->head.next == link) {
+    return;
+  }
+  link->prev->next = link->next;
+  link->next->prev = link->prev;
+  link->prev = &list->head;
+  link->next = list->head.next;
+  list->head.next->prev = link;
+  list->head.next = link;
+}
+
+// move every element of src before pos on dst, leaving src empty
+inline void dlist_splice(DList* dst, DLink* pos, DList* src) {
+  if (src->sz == 0) {
+    return;
+  }
+  DLink* first = src->head.next;
+  DLink* last = src->head.prev;
+  first->prev = pos->prev;
+  last->next = pos;
+  pos->prev->next = first;
+  pos->prev = last;
+  dst->sz += src->sz;
+  dlist_init(src);
+}
+
+// element containing link; T must derive from DLink
+template <typename T> T* dlist_entry(DLink* link) {
+  return static_cast<T*>(link);
+}
+
+// plain value on a list
+template <typename T> struct DNode : DLink {
+  T data;
+};
+
+// initialize new node
+template <typename T> DNode<T>* dnode_create(T data) {
+  return new DNode<T>{{nullptr, nullptr}, std::move(data)};
+}
+
+// add value to head or tail of list
+template <typename T> DNode<T>* dlist_prepend(DList* list, T data) {
+  DNode<T>* node = dnode_create(std::move(data));
+  dlist_push_front(list, node);
+  return node;
+}
+
+template <typename T> DNode<T>* dlist_append(DList* list, T data) {
+  DNode<T>* node = dnode_create(std::move(data));
+  dlist_push_back(list, node);
+  return node;
+}
+
+// first node holding data, or nullptr
+template <typename T> DNode<T>* dlist_find(DList* list, const T& data) {
+  for (DLink* link = dlist_front(list); link; link = dlist_next(list, link)) {
+    DNode<T>* node = dlist_entry<DNode<T>>(link);
+    if (node->data == data) {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+// remove first node with given data, returning whether one was found
+template <typename T> bool dlist_remove(DList* list, const T& data) {
+  DNode<T>* node = dlist_find(list, data);
+  if (!node) {
+    return false;
+  }
+  dlist_unlink(list, node);
+  delete node;
+  return true;
+}
+
+// traverse and print entire list
+template <typename T> void dlist_traverse(DList* list) {
+  std::cout << "List: NULL <-> ";
+  for (DLink* link = dlist_front(list); link; link = dlist_next(list, link)) {
+    std::cout << dlist_entry<DNode<T>>(link)->data << " <-> ";
+  }
+  std::cout << "NULL" << std::endl;
+}
+
+// free every DNode<T> on list
+template <typename T> void dlist_free(DList* list) {
+  while (DLink* link = dlist_pop_front(list)) {
+    delete dlist_entry<DNode<T>>(link);
+  }
+}
@@ -0,0 +1,244 @@
+/**
+ * lru.cpp
+ *
+ * LRU cache tests and benchmarks.
+ */
+
+#include "lru.hpp"
+#include "testing.hpp"
+#include <iostream>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+// the textbook std::list + std::unordered_map cache, as a baseline
+struct StdLru {
+  size_t cap;
+  std::list<std::pair<int, int>> order;
+  std::unordered_map<int, std::list<std::pair<int, int>>::iterator> index;
+};
+
+int* std_lru_get(StdLru* cache, int key) {
+  auto it = cache->index.find(key);
+  if (it == cache->index.end()) {
+    return nullptr;
+  }
+  cache->order.splice(cache->order.begin(), cache->order, it->second);
+  return &it->second->second;
+}
+
+void std_lru_put(StdLru* cache, int key, int value) {
+  auto it = cache->index.find(key);
+  if (it != cache->index.end()) {
+    it->second->second = value;
+    cache->order.splice(cache->order.begin(), cache->order, it->second);
+    return;
+  }
+  if (cache->order.size() == cache->cap) {
+    cache->index.erase(cache->order.back().first);
+    cache->order.pop_back();
+  }
+  cache->order.emplace_front(key, value);
+  cache->index[key] = cache->order.begin();
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("LRU Cache Tests");
+
+  suite.add_test("Put and get", []() {
+    LruCache<int, int> cache;
+    lru_init(&cache, 4);
+    test::assert_true(lru_get(&cache, 1) == nullptr);
+
+    lru_put(&cache, 1, 10);
+    lru_put(&cache, 2, 20);
+    test::assert_equal(size_t(2), lru_size(&cache));
+    test::assert_equal(10, *lru_get(&cache, 1));
+    lru_put(&cache, 1, 11); // update in place
+    test::assert_equal(11, *lru_get(&cache, 1));
+    test::assert_equal(size_t(2), lru_size(&cache));
+
+    lru_destroy(&cache);
+  });
+
+  suite.add_test("Evicts least recently used", []() {
+    LruCache<int, int> cache;
+    lru_init(&cache, 3);
+    lru_put(&cache, 1, 1);
+    lru_put(&cache, 2, 2);
+    lru_put(&cache, 3, 3);
+    lru_get(&cache, 1); // 2 is now the oldest
+    lru_put(&cache, 4, 4);
+
+    test::assert_true(lru_get(&cache, 2) == nullptr, "Wrong entry evicted");
+    test::assert_true(lru_get(&cache, 1) && lru_get(&cache, 3) &&
+                      lru_get(&cache, 4));
+    test::assert_equal(size_t(3), lru_size(&cache));
+
+    lru_destroy(&cache);
+  });
+
+  suite.add_test("Erase and reuse", []() {
+    LruCache<int, int> cache;
+    lru_init(&cache, 2);
+    lru_put(&cache, 1, 1);
+    lru_put(&cache, 2, 2);
+    test::assert_true(lru_erase(&cache, 1));
+    test::assert_false(lru_erase(&cache, 1));
+    lru_put(&cache, 3, 3); // reuses the erased entry, evicts nothing
+    test::assert_true(lru_get(&cache, 2) != nullptr);
+    test::assert_equal(3, *lru_get(&cache, 3));
+
+    lru_destroy(&cache);
+  });
+
+  suite.add_test("Matches reference under random load", []() {
+    const size_t cap = 64;
+    LruCache<int, int> cache;
+    lru_init(&cache, cap);
+    StdLru ref{cap, {}, {}};
+    test::RandomGenerator gen;
+    auto keys = gen.generate_ints(20000, 0, 200);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      int key = keys[i];
+      if (i % 3 == 0) {
+        int* got = lru_get(&cache, key);
+        int* want = std_lru_get(&ref, key);
+        test::assert_equal(want != nullptr, got != nullptr);
+        if (want) {
+          test::assert_equal(*want, *got);
+        }
+      } else {
+        lru_put(&cache, key, int(i));
+        std_lru_put(&ref, key, int(i));
+      }
+    }
+    test::assert_equal(ref.order.size(), lru_size(&cache));
+
+    lru_destroy(&cache);
+  });
+
+  suite.add_test("String keys", []() {
+    LruCache<std::string, std::string> cache;
+    lru_init(&cache, 2);
+    lru_put(&cache, std::string("Plato"), std::string("The Republic"));
+    lru_put(&cache, std::string("Aristotle"), std::string("Politics"));
+    lru_put(&cache, std::string("Socrates"), std::string(32, '?'));
+    test::assert_true(lru_get(&cache, std::string("Plato")) == nullptr);
+    test::assert_equal(std::string("Politics"),
+                       *lru_get(&cache, std::string("Aristotle")));
+
+    lru_destroy(&cache);
+  });
+
+  suite.add_test("Hits and misses do not allocate", []() {
+    LruCache<int, int> cache;
+    lru_init(&cache, 16);
+    for (int i = 0; i < 16; ++i) {
+      lru_put(&cache, i, i);
+    }
+
+    test::AllocScope scope;
+    for (int i = 0; i < 64; ++i) {
+      test::do_not_optimize(lru_get(&cache, i % 16));
+      lru_put(&cache, 100 + i, i); // evicts
+    }
+    if (test::alloc_tracking) {
+      test::assert_equal(size_t(0), scope.stats().count);
+    }
+
+    lru_destroy(&cache);
+  });
+
+  // error handling tests
+  suite.add_test("Zero capacity", []() {
+    LruCache<int, int> cache;
+    bool caught_exception = false;
+
+    try {
+      lru_init(&cache, 0);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: hits on a warm cache, then a miss-heavy stream that keeps
+  // evicting
+  test::Benchmark bench("LRU Cache Benchmarks");
+  const size_t cap = 10000;
+  const size_t ops = 100000;
+
+  test::RandomGenerator gen;
+  auto hit_keys = gen.generate_ints(ops, 0, int(cap) - 1);
+  auto miss_keys = gen.generate_ints(ops, 0, int(4 * cap));
+
+  LruCache<int, int> cache;
+  lru_init(&cache, cap);
+  StdLru ref{cap, {}, {}};
+  for (size_t i = 0; i < cap; ++i) {
+    lru_put(&cache, int(i), int(i));
+    std_lru_put(&ref, int(i), int(i));
+  }
+
+  bench.add_test(
+      "std::list + unordered_map hits",
+      [&]() {
+        long sum = 0;
+        for (int key : hit_keys) {
+          sum += *std_lru_get(&ref, key);
+        }
+        test::do_not_optimize(sum);
+      },
+      ops);
+
+  bench.add_test(
+      "LRU cache hits",
+      [&]() {
+        long sum = 0;
+        for (int key : hit_keys) {
+          sum += *lru_get(&cache, key);
+        }
+        test::do_not_optimize(sum);
+      },
+      ops);
+
+  bench.add_test(
+      "std::list + unordered_map get or put",
+      [&]() {
+        for (int key : miss_keys) {
+          if (!std_lru_get(&ref, key)) {
+            std_lru_put(&ref, key, key);
+          }
+        }
+      },
+      ops);
+
+  bench.add_test(
+      "LRU cache get or put",
+      [&]() {
+        for (int key : miss_keys) {
+          if (!lru_get(&cache, key)) {
+            lru_put(&cache, key, key);
+          }
+        }
+      },
+      ops);
+
+  // run all benchmarks
+  bench.run();
+
+  lru_destroy(&cache);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "LRU cache program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
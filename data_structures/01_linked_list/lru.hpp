@@ -0,0 +1,170 @@
+/**
+ * lru.hpp
+ *
+ * A fixed-capacity least-recently-used cache: an intrusive doubly-linked
+ * list in recency order plus an open-addressing index. Entries and index
+ * are allocated once at init, so neither hits nor misses allocate.
+ */
+
+#pragma once
+
+#include "../00_dynamic_array/darray.hpp"
+#include "dll.hpp"
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+template <typename K, typename V> struct LruEntry : DLink {
+  size_t hash; // cached hash of key
+  K key;
+  V value;
+};
+
+template <typename K, typename V> struct LruCache {
+  DArray<LruEntry<K, V>> entries; // never grows, so links stay valid
+  DArray<uint32_t> index;         // entry index + 1 per slot, 0 if empty
+  size_t mask;                    // index capacity - 1
+  DList order;                    // live entries, most recent first
+  DList spare;                    // erased entries ready for reuse
+};
+
+// initialize cache in place with room for cap entries
+template <typename K, typename V>
+void lru_init(LruCache<K, V>* cache, size_t cap) {
+  if (cap == 0 || cap > UINT32_MAX / 2) {
+    throw std::runtime_error("Invalid cache capacity");
+  }
+  // keep the index at most half full so probe sequences stay short
+  size_t slots = 2;
+  while (slots < 2 * cap) {
+    slots <<= 1;
+  }
+  cache->entries = darray_create<LruEntry<K, V>>(cap);
+  cache->index = darray_create<uint32_t>(slots);
+  for (size_t i = 0; i < slots; ++i) {
+    darray_push_back(&cache->index, uint32_t(0));
+  }
+  cache->mask = slots - 1;
+  dlist_init(&cache->order);
+  dlist_init(&cache->spare);
+}
+
+// free entries and index
+template <typename K, typename V> void lru_destroy(LruCache<K, V>* cache) {
+  darray_destroy(&cache->entries);
+  darray_destroy(&cache->index);
+  dlist_init(&cache->order);
+  dlist_init(&cache->spare);
+}
+
+// number of cached entries
+template <typename K, typename V>
+size_t lru_size(const LruCache<K, V>* cache) {
+  return dlist_size(&cache->order);
+}
+
+// slot holding key, or the empty slot where it would go
+template <typename K, typename V>
+size_t lru_slot(const LruCache<K, V>* cache, const K& key, size_t hash) {
+  size_t slot = hash & cache->mask;
+  for (;;) {
+    uint32_t idx = cache->index.data[slot];
+    if (idx == 0) {
+      return slot;
+    }
+    const LruEntry<K, V>& entry = cache->entries.data[idx - 1];
+    if (entry.hash == hash && entry.key == key) {
+      return slot;
+    }
+    slot = (slot + 1) & cache->mask;
+  }
+}
+
+// empty slot and shift later entries of the probe run back into it, so
+// lookups never need tombstones
+template <typename K, typename V>
+void lru_clear_slot(LruCache<K, V>* cache, size_t slot) {
+  size_t hole = slot;
+  size_t next = slot;
+  for (;;) {
+    next = (next + 1) & cache->mask;
+    uint32_t idx = cache->index.data[next];
+    if (idx == 0) {
+      break;
+    }
+    size_t home = cache->entries.data[idx - 1].hash & cache->mask;
+    // leave the entry if its home lies cyclically in (hole, next]
+    bool in_place = hole <= next ? (hole < home && home <= next)
+                                 : (hole < home || home <= next);
+    if (!in_place) {
+      cache->index.data[hole] = idx;
+      hole = next;
+    }
+  }
+  cache->index.data[hole] = 0;
+}
+
+// value cached for key, marking it most recently used; nullptr on a miss
+template <typename K, typename V>
+V* lru_get(LruCache<K, V>* cache, const K& key) {
+  size_t slot = lru_slot(cache, key, std::hash<K>{}(key));
+  uint32_t idx = cache->index.data[slot];
+  if (idx == 0) {
+    return nullptr;
+  }
+  LruEntry<K, V>* entry = cache->entries.data + (idx - 1);
+  dlist_move_to_front(&cache->order, entry);
+  return &entry->value;
+}
+
+// insert or update key, evicting the least recently used entry when full
+template <typename K, typename V>
+void lru_put(LruCache<K, V>* cache, K key, V value) {
+  size_t hash = std::hash<K>{}(key);
+  size_t slot = lru_slot(cache, key, hash);
+  uint32_t idx = cache->index.data[slot];
+  if (idx) {
+    LruEntry<K, V>* entry = cache->entries.data + (idx - 1);
+    entry->value = std::move(value);
+    dlist_move_to_front(&cache->order, entry);
+    return;
+  }
+
+  LruEntry<K, V>* entry;
+  if (DLink* link = dlist_pop_front(&cache->spare)) {
+    entry = dlist_entry<LruEntry<K, V>>(link);
+    entry->key = std::move(key);
+    entry->value = std::move(value);
+  } else if (cache->entries.sz < cache->entries.cap) {
+    entry = &darray_emplace_back(
+        &cache->entries,
+        LruEntry<K, V>{{nullptr, nullptr}, hash, std::move(key),
+                       std::move(value)});
+  } else {
+    entry = dlist_entry<LruEntry<K, V>>(dlist_pop_back(&cache->order));
+    lru_clear_slot(cache, lru_slot(cache, entry->key, entry->hash));
+    // the evicted entry's slot may have been the one found above
+    slot = lru_slot(cache, key, hash);
+    entry->key = std::move(key);
+    entry->value = std::move(value);
+  }
+  entry->hash = hash;
+  cache->index.data[slot] = uint32_t(entry - cache->entries.data) + 1;
+  dlist_push_front(&cache->order, entry);
+}
+
+// drop key from the cache, returning whether it was present
+template <typename K, typename V>
+bool lru_erase(LruCache<K, V>* cache, const K& key) {
+  size_t slot = lru_slot(cache, key, std::hash<K>{}(key));
+  uint32_t idx = cache->index.data[slot];
+  if (idx == 0) {
+    return false;
+  }
+  LruEntry<K, V>* entry = cache->entries.data + (idx - 1);
+  lru_clear_slot(cache, slot);
+  dlist_unlink(&cache->order, entry);
+  dlist_push_front(&cache->spare, entry);
+  return true;
+}
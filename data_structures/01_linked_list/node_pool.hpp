@@ -0,0 +1,110 @@
+/**
+ * node_pool.hpp
+ *
+ * A slab allocator for fixed-size nodes. Nodes are carved out of contiguous
+ * chunks, freed nodes are recycled through an intrusive free list, and the
+ * whole pool is released in O(chunks).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#define POOL_CHUNK_NODES 1024 // default nodes per chunk
+
+// header at the start of every chunk
+struct PoolChunk {
+  PoolChunk* next;
+};
+
+// freed slot, linked through its own storage
+struct PoolSlot {
+  PoolSlot* next;
+};
+
+template <typename N> struct NodePool {
+  static_assert(alignof(N) <= alignof(std::max_align_t),
+                "Pool chunks come from malloc");
+
+  // each slot holds a node or, once freed, a free list link
+  static constexpr size_t slot_align =
+      alignof(N) > alignof(PoolSlot) ? alignof(N) : alignof(PoolSlot);
+  static constexpr size_t slot_size =
+      ((sizeof(N) > sizeof(PoolSlot) ? sizeof(N) : sizeof(PoolSlot)) +
+       slot_align - 1) /
+      slot_align * slot_align;
+  // slots start after the chunk header, suitably aligned
+  static constexpr size_t header_size =
+      (sizeof(PoolChunk) + slot_align - 1) / slot_align * slot_align;
+
+  PoolChunk* chunks;   // every chunk allocated so far
+  PoolSlot* free_list; // recycled slots
+  char* bump;          // next never-used slot in the newest chunk
+  char* bump_end;      // end of the newest chunk
+  size_t chunk_nodes;  // slots per chunk
+  size_t num_chunks;   // chunks allocated so far
+};
+
+// initialize empty pool; no memory is allocated until the first node
+template <typename N>
+NodePool<N> node_pool_create(size_t chunk_nodes = POOL_CHUNK_NODES) {
+  NodePool<N> pool;
+  pool.chunks = nullptr;
+  pool.free_list = nullptr;
+  pool.bump = nullptr;
+  pool.bump_end = nullptr;
+  pool.chunk_nodes = chunk_nodes ? chunk_nodes : 1;
+  pool.num_chunks = 0;
+
+  return pool;
+}
+
+// get uninitialized storage for one node
+template <typename N> void* node_pool_alloc(NodePool<N>* pool) {
+  if (pool->free_list) {
+    PoolSlot* slot = pool->free_list;
+    pool->free_list = slot->next;
+    return slot;
+  }
+
+  if (pool->bump == pool->bump_end) {
+    size_t bytes = NodePool<N>::header_size +
+                   pool->chunk_nodes * NodePool<N>::slot_size;
+    PoolChunk* chunk = (PoolChunk*)malloc(bytes);
+    if (!chunk) {
+      throw std::bad_alloc();
+    }
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+    pool->num_chunks++;
+    pool->bump = (char*)chunk + NodePool<N>::header_size;
+    pool->bump_end = (char*)chunk + bytes;
+  }
+
+  void* slot = pool->bump;
+  pool->bump += NodePool<N>::slot_size;
+  return slot;
+}
+
+// return storage of an already destroyed node to the pool
+template <typename N> void node_pool_free(NodePool<N>* pool, void* ptr) {
+  PoolSlot* slot = (PoolSlot*)ptr;
+  slot->next = pool->free_list;
+  pool->free_list = slot;
+}
+
+// release every chunk at once; node destructors are not run, so nodes with
+// non-trivial members must be freed individually first
+template <typename N> void node_pool_destroy(NodePool<N>* pool) {
+  while (pool->chunks) {
+    PoolChunk* next = pool->chunks->next;
+    free(pool->chunks);
+    pool->chunks = next;
+  }
+  pool->free_list = nullptr;
+  pool->bump = nullptr;
+  pool->bump_end = nullptr;
+  pool->num_chunks = 0;
+}
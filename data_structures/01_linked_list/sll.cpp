@@ -1,100 +1,15 @@
 /**
  * sll.cpp
  *
- * A singly-linked list implementation.
+ * Singly-linked list tests and benchmarks.
  */
 
+#include "sll.hpp"
 #include "testing.hpp"
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
 
-template <typename T> struct Node {
-  T data;
-  Node<T>* next; // pointer to next node
-};
-
-// initialize new node
-template <typename T> Node<T>* node_create(T data) {
-  Node<T>* new_node = new Node<T>;
-  if (!new_node) {
-    std::cerr << "Memory allocation failed\n";
-    exit(EXIT_FAILURE);
-  }
-  new_node->data = data;
-  new_node->next = nullptr;
-
-  return new_node;
-}
-
-// add node to head of list
-template <typename T> Node<T>* prepend(Node<T>* head, T data) {
-  Node<T>* new_node = node_create(data);
-  new_node->next = head;
-
-  return new_node;
-}
-
-// add node to tail of list
-template <typename T> Node<T>* append(Node<T>* head, T data) {
-  if (!head) { // list is empty (no head)
-    return node_create(data);
-  }
-
-  Node<T>* current = head;
-  while (current->next) { // find tail
-    current = current->next;
-  }
-  current->next = node_create(data);
-
-  return head;
-}
-
-// remove first node with given data
-template <typename T> Node<T>* node_remove(Node<T>* head, T data) {
-  if (!head) {
-    return nullptr;
-  }
-
-  if (head->data == data) {
-    Node<T>* new_head = head->next;
-    delete head;
-    return new_head;
-  }
-
-  Node<T>* current = head;
-  while (current->next && current->next->data != data) {
-    current = current->next;
-  }
-
-  if (current->next) {
-    Node<T>* target_node = current->next;
-    current->next = target_node->next;
-    delete target_node;
-  }
-  return head;
-}
-
-// traverse and print entire list
-template <typename T> void traverse(Node<T>* head) {
-  std::cout << "List: ";
-  Node<T>* current = head;
-  while (current) {
-    std::cout << current->data << " -> ";
-    current = current->next;
-  }
-  std::cout << "NULL" << std::endl;
-}
-
-// free list
-template <typename T> void free_list(Node<T>* head) {
-  while (head) {
-    Node<T>* temp = head;
-    head = head->next;
-    delete temp;
-  }
-}
-
 // driver program
 int main(void) {
   // test suite
@@ -140,13 +55,288 @@ int main(void) {
     free_list(list);
   });
 
+  suite.add_test("Pooled operations", []() {
+    auto pool = node_pool_create<Node<int>>(4);
+    Node<int>* list = nullptr;
+
+    list = append(list, 3, &pool);
+    list = prepend(list, 1, &pool);
+    list = append(list, 7, &pool);
+    test::assert_equal(1, list->data);
+    test::assert_equal(7, list->next->next->data);
+
+    // freed nodes are recycled before new chunks are carved
+    Node<int>* seven = list->next->next;
+    list = node_remove(list, 7, &pool);
+    list = append(list, 9, &pool);
+    test::assert_true(list->next->next == seven, "Freed node not reused");
+    test::assert_equal(size_t(1), pool.num_chunks);
+
+    free_list(list, &pool);
+    node_pool_destroy(&pool);
+  });
+
+  suite.add_test("Pool spans chunks", []() {
+    auto pool = node_pool_create<Node<int>>(16);
+    Node<int>* list = nullptr;
+    for (int i = 0; i < 100; ++i) {
+      list = prepend(list, i, &pool);
+    }
+    test::assert_equal(size_t(7), pool.num_chunks);
+
+    int expected = 99;
+    for (Node<int>* cur = list; cur; cur = cur->next) {
+      test::assert_equal(expected--, cur->data);
+    }
+
+    // trivially destructible nodes: drop the whole list with the pool
+    node_pool_destroy(&pool);
+    test::assert_equal(size_t(0), pool.num_chunks);
+  });
+
+  suite.add_test("Pooled string operations", []() {
+    auto pool = node_pool_create<Node<std::string>>();
+    Node<std::string>* list = nullptr;
+    list = append(list, std::string("Plato"), &pool);
+    list = prepend(list, std::string("Socrates"), &pool);
+    test::assert_equal(std::string("Plato"), list->next->data);
+
+    free_list(list, &pool);
+    node_pool_destroy(&pool);
+  });
+
+  suite.add_test("List handle operations", []() {
+    auto list = list_create<int>();
+    test::assert_equal(size_t(0), list_size(&list));
+
+    list_append(&list, 3);
+    list_prepend(&list, 1);
+    list_append(&list, 7);
+    test::assert_equal(size_t(3), list_size(&list));
+    test::assert_equal(1, list.head->data);
+    test::assert_equal(7, list.tail->data);
+
+    // removing the tail moves it back
+    test::assert_true(list_remove(&list, 7));
+    test::assert_false(list_remove(&list, 42));
+    test::assert_equal(3, list.tail->data);
+    list_append(&list, 9);
+    test::assert_equal(9, list.head->next->next->data);
+
+    test::assert_equal(1, list_pop_front(&list));
+    test::assert_equal(size_t(2), list_size(&list));
+
+    list_destroy(&list);
+    test::assert_true(list.head == nullptr && list.tail == nullptr);
+  });
+
+  suite.add_test("List splice", []() {
+    auto pool = node_pool_create<Node<int>>();
+    auto front = list_create<int>(&pool);
+    auto back = list_create<int>(&pool);
+    for (int i = 0; i < 3; ++i) {
+      list_append(&front, i);
+      list_append(&back, 3 + i);
+    }
+
+    list_splice(&front, &back);
+    test::assert_equal(size_t(6), list_size(&front));
+    test::assert_equal(size_t(0), list_size(&back));
+    test::assert_equal(5, front.tail->data);
+    int expected = 0;
+    for (Node<int>* cur = front.head; cur; cur = cur->next) {
+      test::assert_equal(expected++, cur->data);
+    }
+
+    // splicing into an empty list takes over head and tail
+    list_splice(&back, &front);
+    test::assert_equal(size_t(6), list_size(&back));
+    test::assert_true(front.head == nullptr && front.tail == nullptr);
+    list_append(&back, 6);
+    test::assert_equal(6, back.tail->data);
+
+    list_destroy(&back);
+    node_pool_destroy(&pool);
+  });
+
+  suite.add_test("List adopt and release raw nodes", []() {
+    Node<std::string>* raw = nullptr;
+    raw = append(raw, std::string("Plato"));
+    raw = prepend(raw, std::string("Socrates"));
+
+    auto list = list_adopt(raw);
+    test::assert_equal(size_t(2), list_size(&list));
+    list_append(&list, std::string("Aristotle"));
+    test::assert_equal(std::string("Aristotle"), list.tail->data);
+
+    raw = list_release(&list);
+    test::assert_equal(size_t(0), list_size(&list));
+    raw = node_remove(raw, std::string("Socrates"));
+    test::assert_equal(std::string("Plato"), raw->data);
+
+    free_list(raw);
+  });
+
+  // error handling tests
+  suite.add_test("Pop from empty list", []() {
+    auto list = list_create<int>();
+    bool caught_exception = false;
+
+    try {
+      list_pop_front(&list);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  suite.add_test("Splice across pools", []() {
+    auto pool = node_pool_create<Node<int>>();
+    auto pooled = list_create<int>(&pool);
+    auto heap = list_create<int>();
+    list_append(&heap, 1);
+    bool caught_exception = false;
+
+    try {
+      list_splice(&pooled, &heap);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    list_destroy(&heap);
+    node_pool_destroy(&pool);
+  });
+
   // benchmarks
   test::Benchmark bench("Singly-Linked List Benchmarks");
+  bench.enable_counters();
+  const int n = 100000;
+
+  bench.add_test(
+      "Build and free with new/delete",
+      []() {
+        Node<int>* list = nullptr;
+        for (int i = 0; i < n; ++i) {
+          list = prepend(list, i);
+        }
+        test::do_not_optimize(list);
+        free_list(list);
+      },
+      n);
+
+  bench.add_test(
+      "Build and free node by node with pool",
+      []() {
+        auto pool = node_pool_create<Node<int>>();
+        Node<int>* list = nullptr;
+        for (int i = 0; i < n; ++i) {
+          list = prepend(list, i, &pool);
+        }
+        test::do_not_optimize(list);
+        free_list(list, &pool);
+        node_pool_destroy(&pool);
+      },
+      n);
+
+  bench.add_test(
+      "Build and release whole pool",
+      []() {
+        auto pool = node_pool_create<Node<int>>();
+        Node<int>* list = nullptr;
+        for (int i = 0; i < n; ++i) {
+          list = prepend(list, i, &pool);
+        }
+        test::do_not_optimize(list);
+        node_pool_destroy(&pool);
+      },
+      n);
+
+  // appending: the raw function walks to the tail every call, so it is
+  // measured on a much shorter list
+  const int short_n = 2000;
+
+  bench.add_test(
+      "Raw append (walks to tail)",
+      []() {
+        Node<int>* list = nullptr;
+        for (int i = 0; i < short_n; ++i) {
+          list = append(list, i);
+        }
+        test::do_not_optimize(list);
+        free_list(list);
+      },
+      short_n);
+
+  bench.add_test(
+      "List handle append",
+      []() {
+        auto list = list_create<int>();
+        for (int i = 0; i < n; ++i) {
+          list_append(&list, i);
+        }
+        test::do_not_optimize(list.head);
+        list_destroy(&list);
+      },
+      n);
+
+  bench.add_test(
+      "List handle append with pool",
+      []() {
+        auto pool = node_pool_create<Node<int>>();
+        auto list = list_create<int>(&pool);
+        for (int i = 0; i < n; ++i) {
+          list_append(&list, i);
+        }
+        test::do_not_optimize(list.head);
+        node_pool_destroy(&pool);
+      },
+      n);
+
+  // traversal over a list whose nodes were allocated interleaved with
+  // other allocations, as happens in a long-running program
+  std::vector<int*> noise;
+  Node<int>* heap_list = nullptr;
+  auto pool = node_pool_create<Node<int>>();
+  Node<int>* pool_list = nullptr;
+  for (int i = 0; i < n; ++i) {
+    heap_list = prepend(heap_list, i);
+    pool_list = prepend(pool_list, i, &pool);
+    noise.push_back(new int[1 + i % 8]);
+  }
+
+  bench.add_test(
+      "Traverse heap list",
+      [&]() {
+        long sum = 0;
+        for (Node<int>* cur = heap_list; cur; cur = cur->next) {
+          sum += cur->data;
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  bench.add_test(
+      "Traverse pooled list",
+      [&]() {
+        long sum = 0;
+        for (Node<int>* cur = pool_list; cur; cur = cur->next) {
+          sum += cur->data;
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
 
   // run all tests and benchmarks
   suite.run();
   bench.run();
 
+  free_list(heap_list);
+  node_pool_destroy(&pool);
+  for (int* p : noise) {
+    delete[] p;
+  }
+
   std::cout << "\n" << std::string(50, '=') << std::endl;
   std::cout << "Singly-linked list program is complete." << std::endl;
   std::cout << "" << std::string(50, '=') << std::endl;
@@ -0,0 +1,247 @@
+/**
+ * sll.hpp
+ *
+ * A singly-linked list implementation.
+ */
+
+#pragma once
+
+#include "node_pool.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+template <typename T> struct Node {
+  T data;
+  Node<T>* next; // pointer to next node
+};
+
+// nodes come from the global heap unless a pool is given
+template <typename T> using SllPool = NodePool<Node<T>>;
+
+// initialize new node
+template <typename T>
+Node<T>* node_create(T data, SllPool<T>* pool = nullptr) {
+  void* mem = pool ? node_pool_alloc(pool) : ::operator new(sizeof(Node<T>));
+  if (!mem) {
+    std::cerr << "Memory allocation failed\n";
+    exit(EXIT_FAILURE);
+  }
+  return new (mem) Node<T>{std::move(data), nullptr};
+}
+
+// destroy node and return its memory to where it came from
+template <typename T>
+void node_free(Node<T>* node, SllPool<T>* pool = nullptr) {
+  if (pool) {
+    node->~Node<T>();
+    node_pool_free(pool, node);
+  } else {
+    delete node;
+  }
+}
+
+// add node to head of list
+template <typename T>
+Node<T>* prepend(Node<T>* head, T data, SllPool<T>* pool = nullptr) {
+  Node<T>* new_node = node_create(std::move(data), pool);
+  new_node->next = head;
+
+  return new_node;
+}
+
+// add node to tail of list
+template <typename T>
+Node<T>* append(Node<T>* head, T data, SllPool<T>* pool = nullptr) {
+  if (!head) { // list is empty (no head)
+    return node_create(std::move(data), pool);
+  }
+
+  Node<T>* current = head;
+  while (current->next) { // find tail
+    current = current->next;
+  }
+  current->next = node_create(std::move(data), pool);
+
+  return head;
+}
+
+// remove first node with given data
+template <typename T>
+Node<T>* node_remove(Node<T>* head, T data, SllPool<T>* pool = nullptr) {
+  if (!head) {
+    return nullptr;
+  }
+
+  if (head->data == data) {
+    Node<T>* new_head = head->next;
+    node_free(head, pool);
+    return new_head;
+  }
+
+  Node<T>* current = head;
+  while (current->next && current->next->data != data) {
+    current = current->next;
+  }
+
+  if (current->next) {
+    Node<T>* target_node = current->next;
+    current->next = target_node->next;
+    node_free(target_node, pool);
+  }
+  return head;
+}
+
+// traverse and print entire list
+template <typename T> void traverse(Node<T>* head) {
+  std::cout << "List: ";
+  Node<T>* current = head;
+  while (current) {
+    std::cout << current->data << " -> ";
+    current = current->next;
+  }
+  std::cout << "NULL" << std::endl;
+}
+
+// free list; a pooled list of trivially destructible nodes can instead be
+// dropped all at once with node_pool_destroy
+template <typename T>
+void free_list(Node<T>* head, SllPool<T>* pool = nullptr) {
+  while (head) {
+    Node<T>* temp = head;
+    head = head->next;
+    node_free(temp, pool);
+  }
+}
+
+// list handle tracking tail and length, so append, prepend, size and splice
+// are O(1); the raw node functions above still work on list.head, but any
+// change made through them must be followed by list_adopt
+template <typename T> struct List {
+  Node<T>* head;
+  Node<T>* tail;
+  size_t sz;
+  SllPool<T>* pool; // where nodes come from, or nullptr for the heap
+};
+
+// initialize empty list
+template <typename T> List<T> list_create(SllPool<T>* pool = nullptr) {
+  return List<T>{nullptr, nullptr, 0, pool};
+}
+
+// wrap an existing raw list, walking it once to find tail and length
+template <typename T>
+List<T> list_adopt(Node<T>* head, SllPool<T>* pool = nullptr) {
+  List<T> list = list_create<T>(pool);
+  list.head = head;
+  for (Node<T>* cur = head; cur; cur = cur->next) {
+    list.tail = cur;
+    list.sz++;
+  }
+  return list;
+}
+
+// give up ownership of the nodes, returning the raw head
+template <typename T> Node<T>* list_release(List<T>* list) {
+  Node<T>* head = list->head;
+  list->head = list->tail = nullptr;
+  list->sz = 0;
+  return head;
+}
+
+// add node to head of list
+template <typename T> void list_prepend(List<T>* list, T data) {
+  Node<T>* new_node = node_create(std::move(data), list->pool);
+  new_node->next = list->head;
+  list->head = new_node;
+  if (!list->tail) {
+    list->tail = new_node;
+  }
+  list->sz++;
+}
+
+// add node to tail of list
+template <typename T> void list_append(List<T>* list, T data) {
+  Node<T>* new_node = node_create(std::move(data), list->pool);
+  if (list->tail) {
+    list->tail->next = new_node;
+  } else {
+    list->head = new_node;
+  }
+  list->tail = new_node;
+  list->sz++;
+}
+
+// remove and return head element
+template <typename T> T list_pop_front(List<T>* list) {
+  if (!list->head) {
+    throw std::runtime_error("Cannot pop from empty list");
+  }
+  Node<T>* old_head = list->head;
+  T data = std::move(old_head->data);
+  list->head = old_head->next;
+  if (!list->head) {
+    list->tail = nullptr;
+  }
+  list->sz--;
+  node_free(old_head, list->pool);
+
+  return data;
+}
+
+// remove first node with given data, returning whether one was found
+template <typename T> bool list_remove(List<T>* list, const T& data) {
+  Node<T>* prev = nullptr;
+  Node<T>* current = list->head;
+  while (current && !(current->data == data)) {
+    prev = current;
+    current = current->next;
+  }
+  if (!current) {
+    return false;
+  }
+
+  if (prev) {
+    prev->next = current->next;
+  } else {
+    list->head = current->next;
+  }
+  if (list->tail == current) {
+    list->tail = prev;
+  }
+  list->sz--;
+  node_free(current, list->pool);
+
+  return true;
+}
+
+// number of nodes in list
+template <typename T> size_t list_size(const List<T>* list) {
+  return list->sz;
+}
+
+// move every node of src to the end of dst, leaving src empty; both lists
+// must take their nodes from the same place
+template <typename T> void list_splice(List<T>* dst, List<T>* src) {
+  if (dst->pool != src->pool) {
+    throw std::runtime_error("Cannot splice lists with different pools");
+  }
+  if (!src->head) {
+    return;
+  }
+
+  if (dst->tail) {
+    dst->tail->next = src->head;
+  } else {
+    dst->head = src->head;
+  }
+  dst->tail = src->tail;
+  dst->sz += src->sz;
+  list_release(src);
+}
+
+// free every node and reset to empty
+template <typename T> void list_destroy(List<T>* list) {
+  free_list(list_release(list), list->pool);
+}
@@ -0,0 +1,336 @@
+/**
+ * unrolled.cpp
+ *
+ * Unrolled linked list tests and benchmarks against Node<T> and DArray.
+ */
+
+#include "../00_dynamic_array/darray.hpp"
+#include "sll.hpp"
+#include "testing.hpp"
+#include "unrolled.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+
+// check list contents against a reference vector, node invariants included
+template <typename T>
+void check_matches(const Unrolled<T>* list, const std::vector<T>& expected) {
+  test::assert_equal(expected.size(), unrolled_size(list));
+  size_t i = 0;
+  size_t nodes = 0;
+  for (const UNode<T>* node = list->head; node; node = node->next) {
+    test::assert_true(node->count > 0, "Empty node left in list");
+    for (size_t j = 0; j < node->count; ++j) {
+      test::assert_true(unode_elems(node)[j] == expected[i++]);
+    }
+    if (!node->next) {
+      test::assert_true(node == list->tail, "Tail pointer is stale");
+    }
+    nodes++;
+  }
+  test::assert_equal(nodes, list->nodes);
+}
+
+// insert after the node at position idx - 1 of a raw list (idx > 0)
+void sll_insert_at(Node<int>* head, size_t idx, int data) {
+  Node<int>* prev = head;
+  for (size_t i = 1; i < idx; ++i) {
+    prev = prev->next;
+  }
+  Node<int>* new_node = node_create(data);
+  new_node->next = prev->next;
+  prev->next = new_node;
+}
+
+// remove the node at position idx of a raw list (idx > 0)
+int sll_remove_at(Node<int>* head, size_t idx) {
+  Node<int>* prev = head;
+  for (size_t i = 1; i < idx; ++i) {
+    prev = prev->next;
+  }
+  Node<int>* node = prev->next;
+  prev->next = node->next;
+  int data = node->data;
+  node_free(node);
+  return data;
+}
+
+// insert into an array by shifting the tail up one slot
+void darray_insert_at(DArray<int>* arr, size_t idx, int elem) {
+  darray_push_back(arr, elem);
+  std::copy_backward(arr->data + idx, arr->data + arr->sz - 1,
+                     arr->data + arr->sz);
+  arr->data[idx] = elem;
+}
+
+// remove from an array by shifting the tail down one slot
+int darray_remove_at(DArray<int>* arr, size_t idx) {
+  int elem = arr->data[idx];
+  std::copy(arr->data + idx + 1, arr->data + arr->sz, arr->data + idx);
+  arr->sz--;
+  return elem;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Unrolled Linked List Tests");
+
+  suite.add_test("Initialization", []() {
+    auto list = unrolled_create<int>();
+    test::assert_equal(size_t(0), unrolled_size(&list));
+    test::assert_true(list.head == nullptr && list.tail == nullptr);
+    test::assert_true(UNode<int>::capacity > 1, "Node holds one element");
+    test::assert_true(sizeof(UNode<int>) <= UNROLLED_NODE_BYTES);
+
+    unrolled_destroy(&list);
+  });
+
+  suite.add_test("Push back fills nodes", []() {
+    auto list = unrolled_create<int>();
+    const size_t cap = UNode<int>::capacity;
+    std::vector<int> expected;
+    for (int i = 0; i < int(3 * cap + 1); ++i) {
+      unrolled_push_back(&list, i);
+      expected.push_back(i);
+    }
+    check_matches(&list, expected);
+    test::assert_equal(size_t(4), list.nodes);
+    test::assert_equal(int(cap), unrolled_get(&list, cap));
+
+    unrolled_destroy(&list);
+  });
+
+  suite.add_test("Insert splits full nodes", []() {
+    auto list = unrolled_create<int>();
+    const size_t cap = UNode<int>::capacity;
+    std::vector<int> expected;
+    for (int i = 0; i < int(cap); ++i) {
+      unrolled_push_back(&list, i);
+      expected.push_back(i);
+    }
+
+    unrolled_insert(&list, 3, -1);
+    expected.insert(expected.begin() + 3, -1);
+    test::assert_equal(size_t(2), list.nodes);
+    unrolled_insert(&list, 0, -2);
+    expected.insert(expected.begin(), -2);
+    unrolled_insert(&list, expected.size(), -3);
+    expected.push_back(-3);
+    check_matches(&list, expected);
+
+    unrolled_destroy(&list);
+  });
+
+  suite.add_test("Insert with one element per node", []() {
+    struct Big {
+      char bytes[208];
+      bool operator==(const Big& other) const {
+        return bytes[0] == other.bytes[0];
+      }
+    };
+    test::assert_equal(size_t(1), UNode<Big>::capacity);
+
+    auto list = unrolled_create<Big>();
+    std::vector<Big> expected;
+    for (char c : {'a', 'b'}) {
+      Big big{};
+      big.bytes[0] = c;
+      unrolled_push_back(&list, big);
+      expected.push_back(big);
+    }
+    Big x{};
+    x.bytes[0] = 'x';
+    unrolled_insert(&list, 1, x);
+    expected.insert(expected.begin() + 1, x);
+    Big y{};
+    y.bytes[0] = 'y';
+    unrolled_insert(&list, 0, y);
+    expected.insert(expected.begin(), y);
+    check_matches(&list, expected);
+
+    unrolled_remove(&list, 1);
+    expected.erase(expected.begin() + 1);
+    check_matches(&list, expected);
+
+    unrolled_destroy(&list);
+  });
+
+  suite.add_test("Remove borrows and merges", []() {
+    auto list = unrolled_create<int>();
+    std::vector<int> expected;
+    for (int i = 0; i < 500; ++i) {
+      unrolled_push_back(&list, i);
+      expected.push_back(i);
+    }
+
+    // drain from the middle until empty, checking after every step
+    while (!expected.empty()) {
+      size_t idx = expected.size() / 3;
+      test::assert_equal(expected[idx], unrolled_remove(&list, idx));
+      expected.erase(expected.begin() + idx);
+      check_matches(&list, expected);
+    }
+    test::assert_true(list.head == nullptr && list.tail == nullptr);
+    test::assert_equal(size_t(0), list.nodes);
+  });
+
+  suite.add_test("Random insert and remove", []() {
+    auto list = unrolled_create<int>();
+    std::vector<int> expected;
+    test::RandomGenerator gen;
+    auto values = gen.generate_ints(4000, 0, 1 << 20);
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (expected.empty() || values[i] % 3 != 0) {
+        size_t idx = values[i] % (expected.size() + 1);
+        unrolled_insert(&list, idx, values[i]);
+        expected.insert(expected.begin() + idx, values[i]);
+      } else {
+        size_t idx = values[i] % expected.size();
+        test::assert_equal(expected[idx], unrolled_remove(&list, idx));
+        expected.erase(expected.begin() + idx);
+      }
+    }
+    check_matches(&list, expected);
+
+    long sum = 0;
+    long expected_sum = 0;
+    unrolled_for_each(&list, [&](int x) { sum += x; });
+    for (int x : expected) {
+      expected_sum += x;
+    }
+    test::assert_equal(expected_sum, sum);
+
+    unrolled_destroy(&list);
+  });
+
+  suite.add_test("String operations", []() {
+    auto list = unrolled_create<std::string>();
+    std::vector<std::string> expected;
+    for (int i = 0; i < 20; ++i) {
+      std::string s(24, char('a' + i));
+      unrolled_insert(&list, expected.size() / 2, s);
+      expected.insert(expected.begin() + expected.size() / 2, s);
+    }
+    unrolled_set(&list, 5, std::string("Plato"));
+    expected[5] = "Plato";
+    test::assert_equal(expected[7], unrolled_remove(&list, 7));
+    expected.erase(expected.begin() + 7);
+    check_matches(&list, expected);
+
+    unrolled_destroy(&list);
+  });
+
+  // error handling tests
+  suite.add_test("Out of bounds access", []() {
+    auto list = unrolled_create<int>();
+    unrolled_push_back(&list, 7);
+    bool caught_exception = false;
+
+    try {
+      unrolled_get(&list, 1);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    unrolled_destroy(&list);
+  });
+
+  suite.add_test("Remove from empty list", []() {
+    auto list = unrolled_create<int>();
+    bool caught_exception = false;
+
+    try {
+      unrolled_remove(&list, 0);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: the same n ints held by each container
+  test::Benchmark bench("Unrolled Linked List Benchmarks");
+  const size_t n = 100000;
+  const size_t mid = n / 2;
+
+  // nodes allocated interleaved with other allocations, as in a
+  // long-running program
+  std::vector<int*> noise;
+  Node<int>* sll = nullptr;
+  auto arr = darray_create<int>(n + 1);
+  auto list = unrolled_create<int>();
+  for (size_t i = 0; i < n; ++i) {
+    sll = prepend(sll, int(n - 1 - i));
+    darray_push_back(&arr, int(i));
+    unrolled_push_back(&list, int(i));
+    noise.push_back(new int[1 + i % 8]);
+  }
+
+  bench.add_test(
+      "Scan Node<T> list",
+      [&]() {
+        long sum = 0;
+        for (Node<int>* cur = sll; cur; cur = cur->next) {
+          sum += cur->data;
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  bench.add_test(
+      "Scan DArray",
+      [&]() {
+        long sum = 0;
+        for (size_t i = 0; i < arr.sz; ++i) {
+          sum += arr.data[i];
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  bench.add_test(
+      "Scan unrolled list",
+      [&]() {
+        long sum = 0;
+        unrolled_for_each(&list, [&](int x) { sum += x; });
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  // each call inserts then removes so sizes stay at n; the cost is
+  // dominated by finding (lists) or shifting (array) the middle
+  bench.add_test("Middle insert and remove Node<T> list", [&]() {
+    sll_insert_at(sll, mid, -1);
+    test::do_not_optimize(sll_remove_at(sll, mid));
+  });
+
+  bench.add_test("Middle insert and remove DArray", [&]() {
+    darray_insert_at(&arr, mid, -1);
+    test::do_not_optimize(darray_remove_at(&arr, mid));
+  });
+
+  bench.add_test("Middle insert and remove unrolled list", [&]() {
+    unrolled_insert(&list, mid, -1);
+    test::do_not_optimize(unrolled_remove(&list, mid));
+  });
+
+  // run all benchmarks
+  bench.run();
+
+  free_list(sll);
+  darray_destroy(&arr);
+  unrolled_destroy(&list);
+  for (int* p : noise) {
+    delete[] p;
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Unrolled linked list program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,282 @@
+/**
+ * unrolled.hpp
+ *
+ * An unrolled linked list: each node holds a small array of elements sized
+ * to a couple of cache lines, so scans touch memory almost like an array
+ * while inserts and removes only shift elements within one node.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#define CACHE_LINE 64           // bytes per cache line
+#define UNROLLED_NODE_BYTES 128 // target node size, header included
+
+template <typename T> struct alignas(CACHE_LINE) UNode {
+  static_assert(alignof(T) <= CACHE_LINE, "Element over-aligned");
+
+  // elements that fit next to the header, at least one
+  static constexpr size_t capacity =
+      sizeof(T) + 2 * sizeof(void*) > UNROLLED_NODE_BYTES
+          ? 1
+          : (UNROLLED_NODE_BYTES - 2 * sizeof(void*)) / sizeof(T);
+
+  UNode<T>* next; // pointer to next node
+  uint32_t count; // elements in use, always at the front of buf
+  alignas(T) unsigned char buf[capacity * sizeof(T)]; // element storage
+};
+
+template <typename T> struct Unrolled {
+  UNode<T>* head;
+  UNode<T>* tail;
+  size_t sz;    // total elements across all nodes
+  size_t nodes; // number of nodes
+};
+
+// elements of a node
+template <typename T> T* unode_elems(UNode<T>* node) {
+  return reinterpret_cast<T*>(node->buf);
+}
+
+template <typename T> const T* unode_elems(const UNode<T>* node) {
+  return reinterpret_cast<const T*>(node->buf);
+}
+
+// open a hole of raw storage at idx by shifting [idx, count) right by one
+template <typename T>
+void unode_shift_right(T* elems, size_t count, size_t idx) {
+  if (idx == count) {
+    return;
+  }
+  new (elems + count) T(std::move(elems[count - 1]));
+  std::move_backward(elems + idx, elems + count - 1, elems + count);
+  std::destroy_at(elems + idx);
+}
+
+// close the hole of raw storage at idx by shifting (idx, count) left by one
+template <typename T>
+void unode_shift_left(T* elems, size_t count, size_t idx) {
+  if (idx + 1 == count) {
+    return;
+  }
+  new (elems + idx) T(std::move(elems[idx + 1]));
+  std::move(elems + idx + 2, elems + count, elems + idx + 1);
+  std::destroy_at(elems + count - 1);
+}
+
+// initialize empty list
+template <typename T> Unrolled<T> unrolled_create() {
+  return Unrolled<T>{nullptr, nullptr, 0, 0};
+}
+
+// allocate empty node linked after prev (or as head if prev is null)
+template <typename T>
+UNode<T>* unrolled_new_node(Unrolled<T>* list, UNode<T>* prev) {
+  UNode<T>* node = new UNode<T>;
+  node->count = 0;
+  if (prev) {
+    node->next = prev->next;
+    prev->next = node;
+  } else {
+    node->next = list->head;
+    list->head = node;
+  }
+  if (list->tail == prev) {
+    list->tail = node;
+  }
+  list->nodes++;
+
+  return node;
+}
+
+// unlink empty node that follows prev (or the head if prev is null)
+template <typename T>
+void unrolled_free_node(Unrolled<T>* list, UNode<T>* prev, UNode<T>* node) {
+  if (prev) {
+    prev->next = node->next;
+  } else {
+    list->head = node->next;
+  }
+  if (list->tail == node) {
+    list->tail = prev;
+  }
+  list->nodes--;
+  delete node;
+}
+
+// free every node and reset to empty
+template <typename T> void unrolled_destroy(Unrolled<T>* list) {
+  UNode<T>* node = list->head;
+  while (node) {
+    UNode<T>* next = node->next;
+    std::destroy(unode_elems(node), unode_elems(node) + node->count);
+    delete node;
+    node = next;
+  }
+  *list = unrolled_create<T>();
+}
+
+// number of elements in list
+template <typename T> size_t unrolled_size(const Unrolled<T>* list) {
+  return list->sz;
+}
+
+// append element, starting a new node when the tail is full so that lists
+// built front to back stay fully packed
+template <typename T> void unrolled_push_back(Unrolled<T>* list, T elem) {
+  UNode<T>* node = list->tail;
+  if (!node || node->count == UNode<T>::capacity) {
+    node = unrolled_new_node(list, node);
+  }
+  new (unode_elems(node) + node->count) T(std::move(elem));
+  node->count++;
+  list->sz++;
+}
+
+// insert element before position idx (idx == size appends); a full node is
+// split in half first
+template <typename T>
+void unrolled_insert(Unrolled<T>* list, size_t idx, T elem) {
+  if (idx > list->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  if (idx == list->sz) {
+    unrolled_push_back(list, std::move(elem));
+    return;
+  }
+
+  UNode<T>* node = list->head;
+  while (idx > node->count) {
+    idx -= node->count;
+    node = node->next;
+  }
+
+  constexpr size_t cap = UNode<T>::capacity;
+  if (cap == 1 && node->count == 1) {
+    // a one-element node cannot be halved; link a new node after it and
+    // put whichever element comes second there
+    UNode<T>* fresh = unrolled_new_node(list, node);
+    T* elems = unode_elems(node);
+    if (idx == 0) {
+      new (unode_elems(fresh)) T(std::move(elems[0]));
+      elems[0] = std::move(elem);
+    } else {
+      new (unode_elems(fresh)) T(std::move(elem));
+    }
+    fresh->count = 1;
+    list->sz++;
+    return;
+  }
+  if (node->count == cap) {
+    size_t half = cap / 2;
+    UNode<T>* upper = unrolled_new_node(list, node);
+    T* from = unode_elems(node);
+    std::uninitialized_move(from + half, from + cap, unode_elems(upper));
+    std::destroy(from + half, from + cap);
+    node->count = half;
+    upper->count = cap - half;
+    if (idx > half) {
+      idx -= half;
+      node = upper;
+    }
+  }
+
+  T* elems = unode_elems(node);
+  unode_shift_right(elems, node->count, idx);
+  new (elems + idx) T(std::move(elem));
+  node->count++;
+  list->sz++;
+}
+
+// remove and return element at position idx; a node left less than half
+// full borrows from or merges with its successor
+template <typename T> T unrolled_remove(Unrolled<T>* list, size_t idx) {
+  if (idx >= list->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+
+  UNode<T>* prev = nullptr;
+  UNode<T>* node = list->head;
+  while (idx >= node->count) {
+    idx -= node->count;
+    prev = node;
+    node = node->next;
+  }
+
+  T* elems = unode_elems(node);
+  T elem = std::move(elems[idx]);
+  std::destroy_at(elems + idx);
+  unode_shift_left(elems, node->count, idx);
+  node->count--;
+  list->sz--;
+
+  constexpr size_t cap = UNode<T>::capacity;
+  UNode<T>* next = node->next;
+  if (node->count == 0) {
+    unrolled_free_node(list, prev, node);
+  } else if (node->count < cap / 2 && next) {
+    T* next_elems = unode_elems(next);
+    if (node->count + next->count <= cap) {
+      std::uninitialized_move(next_elems, next_elems + next->count,
+                              elems + node->count);
+      std::destroy(next_elems, next_elems + next->count);
+      node->count += next->count;
+      next->count = 0;
+      unrolled_free_node(list, node, next);
+    } else {
+      new (elems + node->count) T(std::move(next_elems[0]));
+      std::destroy_at(next_elems);
+      unode_shift_left(next_elems, next->count, 0);
+      node->count++;
+      next->count--;
+    }
+  }
+
+  return elem;
+}
+
+// get element at index
+template <typename T>
+const T& unrolled_get(const Unrolled<T>* list, size_t idx) {
+  if (idx >= list->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  const UNode<T>* node = list->head;
+  while (idx >= node->count) {
+    idx -= node->count;
+    node = node->next;
+  }
+  return unode_elems(node)[idx];
+}
+
+// set element at index
+template <typename T>
+void unrolled_set(Unrolled<T>* list, size_t idx, T elem) {
+  if (idx >= list->sz) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  UNode<T>* node = list->head;
+  while (idx >= node->count) {
+    idx -= node->count;
+    node = node->next;
+  }
+  unode_elems(node)[idx] = std::move(elem);
+}
+
+// call f on every element in order, one contiguous block at a time
+template <typename T, typename F>
+void unrolled_for_each(const Unrolled<T>* list, F f) {
+  for (const UNode<T>* node = list->head; node; node = node->next) {
+    const T* elems = unode_elems(node);
+    for (size_t i = 0; i < node->count; ++i) {
+      f(elems[i]);
+    }
+  }
+}
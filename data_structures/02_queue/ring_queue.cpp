@@ -0,0 +1,470 @@
+/**
+ * ring_queue.cpp
+ *
+ * Ring-buffer queue tests and multi-threaded benchmarks against a
+ * mutex-guarded linked list.
+ */
+
+#include "../01_linked_list/sll.hpp"
+#include "ring_queue.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BATCH 32 // elements per batch operation in tests and benchmarks
+
+// linked list behind one lock, the baseline being replaced
+template <typename T> struct LockedList {
+  std::mutex lock;
+  List<T> list;
+};
+
+template <typename T> bool locked_try_push(LockedList<T>* q, T elem) {
+  std::lock_guard<std::mutex> guard(q->lock);
+  list_append(&q->list, std::move(elem));
+  return true;
+}
+
+template <typename T> bool locked_try_pop(LockedList<T>* q, T* out) {
+  std::lock_guard<std::mutex> guard(q->lock);
+  if (list_size(&q->list) == 0) {
+    return false;
+  }
+  *out = list_pop_front(&q->list);
+  return true;
+}
+
+// pass ids 0..items-1 from `pairs` producer threads to `pairs` consumer
+// threads; producers yield while the queue is full and consumers while it
+// is empty, so oversubscribed runs still make progress. Returns the sum of
+// everything consumed.
+template <typename Push, typename Pop>
+long run_pipeline(size_t pairs, size_t items, Push push, Pop pop) {
+  std::atomic<size_t> consumed{0};
+  std::atomic<long> total{0};
+  std::vector<std::thread> threads;
+
+  for (size_t p = 0; p < pairs; ++p) {
+    threads.emplace_back([&, p]() {
+      for (size_t i = p; i < items; i += pairs) {
+        while (!push(int(i))) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (size_t c = 0; c < pairs; ++c) {
+    threads.emplace_back([&]() {
+      long sum = 0;
+      int elem;
+      while (consumed.load(std::memory_order_relaxed) < items) {
+        if (pop(&elem)) {
+          sum += elem;
+          consumed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+      total.fetch_add(sum);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  return total.load();
+}
+
+// same as run_pipeline, moving elements BATCH at a time
+template <typename PushBatch, typename PopBatch>
+long run_batch_pipeline(size_t pairs, size_t items, PushBatch push_batch,
+                        PopBatch pop_batch) {
+  std::atomic<size_t> consumed{0};
+  std::atomic<long> total{0};
+  std::vector<std::thread> threads;
+
+  for (size_t p = 0; p < pairs; ++p) {
+    threads.emplace_back([&, p]() {
+      int elems[BATCH];
+      size_t i = p;
+      while (i < items) {
+        size_t n = 0;
+        for (; n < BATCH && i < items; ++n, i += pairs) {
+          elems[n] = int(i);
+        }
+        for (size_t done = 0; done < n;) {
+          size_t k = push_batch(elems + done, n - done);
+          if (k == 0) {
+            std::this_thread::yield();
+          }
+          done += k;
+        }
+      }
+    });
+  }
+  for (size_t c = 0; c < pairs; ++c) {
+    threads.emplace_back([&]() {
+      long sum = 0;
+      int elems[BATCH];
+      while (consumed.load(std::memory_order_relaxed) < items) {
+        size_t k = pop_batch(elems, BATCH);
+        if (k == 0) {
+          std::this_thread::yield();
+          continue;
+        }
+        for (size_t j = 0; j < k; ++j) {
+          sum += elems[j];
+        }
+        consumed.fetch_add(k, std::memory_order_relaxed);
+      }
+      total.fetch_add(sum);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  return total.load();
+}
+
+// bounce one element between two threads `trips` times through a pair of
+// queues, measuring hand-off latency rather than throughput
+template <typename Push, typename Pop, typename PushBack, typename PopBack>
+void run_ping_pong(size_t trips, Push push, Pop pop, PushBack push_back,
+                   PopBack pop_back) {
+  std::thread echo([&]() {
+    int elem;
+    for (size_t i = 0; i < trips; ++i) {
+      while (!pop(&elem)) {
+        std::this_thread::yield();
+      }
+      while (!push_back(elem)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+  int elem;
+  for (size_t i = 0; i < trips; ++i) {
+    while (!push(int(i))) {
+      std::this_thread::yield();
+    }
+    while (!pop_back(&elem)) {
+      std::this_thread::yield();
+    }
+  }
+  echo.join();
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Ring Buffer Queue Tests");
+
+  suite.add_test("Capacity rounds up to a power of two", []() {
+    test::assert_equal(size_t(1), ring_capacity(1));
+    test::assert_equal(size_t(8), ring_capacity(5));
+    test::assert_equal(size_t(64), ring_capacity(64));
+  });
+
+  suite.add_test("SPSC push and pop", []() {
+    SpscQueue<int> q;
+    spsc_init(&q, 4);
+    int out = 0;
+    test::assert_false(spsc_try_pop(&q, &out), "Popped from empty queue");
+
+    // wrap around the ring several times
+    for (int i = 0; i < 10; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        test::assert_true(spsc_try_push(&q, 4 * i + j));
+      }
+      test::assert_false(spsc_try_push(&q, -1), "Pushed to full queue");
+      test::assert_equal(size_t(4), spsc_size(&q));
+      for (int j = 0; j < 4; ++j) {
+        test::assert_true(spsc_try_pop(&q, &out));
+        test::assert_equal(4 * i + j, out);
+      }
+    }
+
+    spsc_destroy(&q);
+  });
+
+  suite.add_test("SPSC batch operations", []() {
+    SpscQueue<int> q;
+    spsc_init(&q, 8);
+    int in[12];
+    int out[12];
+    for (int i = 0; i < 12; ++i) {
+      in[i] = i;
+    }
+    test::assert_equal(size_t(8), spsc_push_batch(&q, in, 12));
+    test::assert_equal(size_t(5), spsc_pop_batch(&q, out, 5));
+    test::assert_equal(size_t(4), spsc_push_batch(&q, in + 8, 4));
+    test::assert_equal(size_t(7), spsc_pop_batch(&q, out + 5, 12));
+    for (int i = 0; i < 12; ++i) {
+      test::assert_equal(i, out[i]);
+    }
+
+    spsc_destroy(&q);
+  });
+
+  suite.add_test("MPMC push and pop", []() {
+    MpmcQueue<int> q;
+    mpmc_init(&q, 4);
+    int out = 0;
+    test::assert_false(mpmc_try_pop(&q, &out), "Popped from empty queue");
+
+    for (int i = 0; i < 10; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        test::assert_true(mpmc_try_push(&q, 4 * i + j));
+      }
+      test::assert_false(mpmc_try_push(&q, -1), "Pushed to full queue");
+      test::assert_equal(size_t(4), mpmc_size(&q));
+      for (int j = 0; j < 4; ++j) {
+        test::assert_true(mpmc_try_pop(&q, &out));
+        test::assert_equal(4 * i + j, out);
+      }
+    }
+
+    mpmc_destroy(&q);
+  });
+
+  suite.add_test("MPMC batch operations", []() {
+    MpmcQueue<int> q;
+    mpmc_init(&q, 8);
+    int in[12];
+    int out[12];
+    for (int i = 0; i < 12; ++i) {
+      in[i] = i;
+    }
+    test::assert_equal(size_t(8), mpmc_push_batch(&q, in, 12));
+    test::assert_equal(size_t(0), mpmc_push_batch(&q, in, 1));
+    test::assert_equal(size_t(5), mpmc_pop_batch(&q, out, 5));
+    test::assert_equal(size_t(4), mpmc_push_batch(&q, in + 8, 4));
+    test::assert_equal(size_t(7), mpmc_pop_batch(&q, out + 5, 12));
+    for (int i = 0; i < 12; ++i) {
+      test::assert_equal(i, out[i]);
+    }
+
+    mpmc_destroy(&q);
+  });
+
+  suite.add_test("Non-trivial element type", []() {
+    SpscQueue<std::string> spsc;
+    MpmcQueue<std::string> mpmc;
+    spsc_init(&spsc, 2);
+    mpmc_init(&mpmc, 2);
+    std::string plato(32, 'p');
+    spsc_try_push(&spsc, plato);
+    mpmc_try_push(&mpmc, plato);
+    spsc_try_push(&spsc, std::string("Aristotle"));
+    mpmc_try_push(&mpmc, std::string("Aristotle"));
+
+    std::string out;
+    test::assert_true(spsc_try_pop(&spsc, &out));
+    test::assert_equal(plato, out);
+    test::assert_true(mpmc_try_pop(&mpmc, &out));
+    test::assert_equal(plato, out);
+
+    // the remaining elements are freed by destroy
+    spsc_destroy(&spsc);
+    mpmc_destroy(&mpmc);
+  });
+
+  suite.add_test("SPSC preserves order across threads", []() {
+    SpscQueue<int> q;
+    spsc_init(&q, 64);
+    const int items = 100000;
+    bool in_order = true;
+
+    std::thread consumer([&]() {
+      int out;
+      for (int expected = 0; expected < items; ++expected) {
+        while (!spsc_try_pop(&q, &out)) {
+          std::this_thread::yield();
+        }
+        in_order = in_order && out == expected;
+      }
+    });
+    for (int i = 0; i < items; ++i) {
+      while (!spsc_try_push(&q, i)) {
+        std::this_thread::yield();
+      }
+    }
+    consumer.join();
+    test::assert_true(in_order, "Elements reordered");
+
+    spsc_destroy(&q);
+  });
+
+  suite.add_test("MPMC delivers every element once", []() {
+    MpmcQueue<int> q;
+    mpmc_init(&q, 64);
+    const size_t items = 100000;
+    long expected = long(items) * (items - 1) / 2;
+
+    long sum = run_pipeline(
+        4, items, [&](int x) { return mpmc_try_push(&q, x); },
+        [&](int* out) { return mpmc_try_pop(&q, out); });
+    test::assert_equal(expected, sum);
+
+    sum = run_batch_pipeline(
+        4, items,
+        [&](const int* elems, size_t n) {
+          return mpmc_push_batch(&q, elems, n);
+        },
+        [&](int* out, size_t n) { return mpmc_pop_batch(&q, out, n); });
+    test::assert_equal(expected, sum);
+    test::assert_equal(size_t(0), mpmc_size(&q));
+
+    mpmc_destroy(&q);
+  });
+
+  // error handling tests
+  suite.add_test("Zero capacity", []() {
+    MpmcQueue<int> q;
+    bool caught_exception = false;
+
+    try {
+      mpmc_init(&q, 0);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: throughput across 1 to max(2, cores) producer/consumer
+  // pairs, then single hand-off latency
+  test::Benchmark bench("Ring Buffer Queue Benchmarks");
+  const size_t items = 200000;
+  const size_t cap = 1024;
+  const size_t trips = 20000;
+  size_t max_pairs = std::max(2u, std::thread::hardware_concurrency());
+
+  SpscQueue<int> spsc;
+  SpscQueue<int> spsc_back;
+  MpmcQueue<int> mpmc;
+  MpmcQueue<int> mpmc_back;
+  LockedList<int> locked;
+  LockedList<int> locked_back;
+  spsc_init(&spsc, cap);
+  spsc_init(&spsc_back, cap);
+  mpmc_init(&mpmc, cap);
+  mpmc_init(&mpmc_back, cap);
+  locked.list = list_create<int>();
+  locked_back.list = list_create<int>();
+
+  bench.add_test(
+      "SPSC 1 pair",
+      [&]() {
+        test::do_not_optimize(run_pipeline(
+            1, items, [&](int x) { return spsc_try_push(&spsc, x); },
+            [&](int* out) { return spsc_try_pop(&spsc, out); }));
+      },
+      items);
+
+  bench.add_test(
+      "SPSC batch 1 pair",
+      [&]() {
+        test::do_not_optimize(run_batch_pipeline(
+            1, items,
+            [&](const int* elems, size_t n) {
+              return spsc_push_batch(&spsc, elems, n);
+            },
+            [&](int* out, size_t n) {
+              return spsc_pop_batch(&spsc, out, n);
+            }));
+      },
+      items);
+
+  for (size_t pairs = 1; pairs <= max_pairs; pairs *= 2) {
+    std::string suffix = " " + std::to_string(pairs) +
+                         (pairs == 1 ? " pair" : " pairs");
+
+    bench.add_test(
+        "Mutex list" + suffix,
+        [&, pairs]() {
+          test::do_not_optimize(run_pipeline(
+              pairs, items, [&](int x) { return locked_try_push(&locked, x); },
+              [&](int* out) { return locked_try_pop(&locked, out); }));
+        },
+        items);
+
+    bench.add_test(
+        "MPMC" + suffix,
+        [&, pairs]() {
+          test::do_not_optimize(run_pipeline(
+              pairs, items, [&](int x) { return mpmc_try_push(&mpmc, x); },
+              [&](int* out) { return mpmc_try_pop(&mpmc, out); }));
+        },
+        items);
+
+    bench.add_test(
+        "MPMC batch" + suffix,
+        [&, pairs]() {
+          test::do_not_optimize(run_batch_pipeline(
+              pairs, items,
+              [&](const int* elems, size_t n) {
+                return mpmc_push_batch(&mpmc, elems, n);
+              },
+              [&](int* out, size_t n) {
+                return mpmc_pop_batch(&mpmc, out, n);
+              }));
+        },
+        items);
+  }
+
+  bench.add_test(
+      "Mutex list round trip",
+      [&]() {
+        run_ping_pong(
+            trips, [&](int x) { return locked_try_push(&locked, x); },
+            [&](int* out) { return locked_try_pop(&locked, out); },
+            [&](int x) { return locked_try_push(&locked_back, x); },
+            [&](int* out) { return locked_try_pop(&locked_back, out); });
+      },
+      trips);
+
+  bench.add_test(
+      "SPSC round trip",
+      [&]() {
+        run_ping_pong(
+            trips, [&](int x) { return spsc_try_push(&spsc, x); },
+            [&](int* out) { return spsc_try_pop(&spsc, out); },
+            [&](int x) { return spsc_try_push(&spsc_back, x); },
+            [&](int* out) { return spsc_try_pop(&spsc_back, out); });
+      },
+      trips);
+
+  bench.add_test(
+      "MPMC round trip",
+      [&]() {
+        run_ping_pong(
+            trips, [&](int x) { return mpmc_try_push(&mpmc, x); },
+            [&](int* out) { return mpmc_try_pop(&mpmc, out); },
+            [&](int x) { return mpmc_try_push(&mpmc_back, x); },
+            [&](int* out) { return mpmc_try_pop(&mpmc_back, out); });
+      },
+      trips);
+
+  // run all benchmarks
+  bench.run();
+
+  spsc_destroy(&spsc);
+  spsc_destroy(&spsc_back);
+  mpmc_destroy(&mpmc);
+  mpmc_destroy(&mpmc_back);
+  list_destroy(&locked.list);
+  list_destroy(&locked_back.list);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Ring buffer queue program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
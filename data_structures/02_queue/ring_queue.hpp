@@ -0,0 +1,313 @@
+/**
+ * ring_queue.hpp
+ *
+ * Bounded lock-free queues over a power-of-two ring buffer held in a DArray:
+ * a single-producer/single-consumer queue and a multi-producer/
+ * multi-consumer queue with per-slot sequence numbers.
+ */
+
+#pragma once
+
+#include "../00_dynamic_array/darray.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#define CACHE_LINE 64 // bytes per cache line
+
+// round requested capacity up to a power of two
+inline size_t ring_capacity(size_t cap) {
+  if (cap == 0) {
+    throw std::runtime_error("Queue capacity must be positive");
+  }
+  size_t pow2 = 1;
+  while (pow2 < cap) {
+    pow2 <<= 1;
+  }
+  return pow2;
+}
+
+// single-producer/single-consumer queue; each side keeps a cached copy of
+// the other side's index so it only touches the shared line when the queue
+// looks full (producer) or empty (consumer)
+template <typename T> struct SpscQueue {
+  DArray<T> ring; // slot storage; ring.sz stays 0, head/tail track elements
+  size_t mask;    // capacity - 1
+
+  alignas(CACHE_LINE) std::atomic<size_t> head; // next slot to pop
+  size_t cached_tail;                           // consumer's view of tail
+
+  alignas(CACHE_LINE) std::atomic<size_t> tail; // next slot to push
+  size_t cached_head;                           // producer's view of head
+};
+
+// initialize queue in place with room for at least cap elements
+template <typename T> void spsc_init(SpscQueue<T>* q, size_t cap) {
+  cap = ring_capacity(cap);
+  q->ring = darray_create<T>(cap);
+  q->mask = cap - 1;
+  q->head.store(0, std::memory_order_relaxed);
+  q->cached_tail = 0;
+  q->tail.store(0, std::memory_order_relaxed);
+  q->cached_head = 0;
+}
+
+// destroy queued elements and free the ring; no other thread may be using
+// the queue
+template <typename T> void spsc_destroy(SpscQueue<T>* q) {
+  size_t tail = q->tail.load(std::memory_order_relaxed);
+  for (size_t i = q->head.load(std::memory_order_relaxed); i != tail; ++i) {
+    std::destroy_at(q->ring.data + (i & q->mask));
+  }
+  darray_destroy(&q->ring);
+  q->head.store(0, std::memory_order_relaxed);
+  q->tail.store(0, std::memory_order_relaxed);
+}
+
+// free slots seen by the producer, refreshing its view of head when fewer
+// than want are known to be free
+template <typename T>
+size_t spsc_free_slots(SpscQueue<T>* q, size_t tail, size_t want) {
+  size_t free_slots = q->ring.cap - (tail - q->cached_head);
+  if (free_slots < want) {
+    q->cached_head = q->head.load(std::memory_order_acquire);
+    free_slots = q->ring.cap - (tail - q->cached_head);
+  }
+  return free_slots;
+}
+
+// queued elements seen by the consumer, refreshing its view of tail when
+// fewer than want are known to be queued
+template <typename T>
+size_t spsc_used_slots(SpscQueue<T>* q, size_t head, size_t want) {
+  size_t used = q->cached_tail - head;
+  if (used < want) {
+    q->cached_tail = q->tail.load(std::memory_order_acquire);
+    used = q->cached_tail - head;
+  }
+  return used;
+}
+
+// construct element at the back (producer only); false if full
+template <typename T, typename... Args>
+bool spsc_try_emplace(SpscQueue<T>* q, Args&&... args) {
+  size_t tail = q->tail.load(std::memory_order_relaxed);
+  if (spsc_free_slots(q, tail, 1) == 0) {
+    return false;
+  }
+  new (q->ring.data + (tail & q->mask)) T(std::forward<Args>(args)...);
+  q->tail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T> bool spsc_try_push(SpscQueue<T>* q, const T& elem) {
+  return spsc_try_emplace(q, elem);
+}
+
+template <typename T> bool spsc_try_push(SpscQueue<T>* q, T&& elem) {
+  return spsc_try_emplace(q, std::move(elem));
+}
+
+// move front element into out (consumer only); false if empty
+template <typename T> bool spsc_try_pop(SpscQueue<T>* q, T* out) {
+  size_t head = q->head.load(std::memory_order_relaxed);
+  if (spsc_used_slots(q, head, 1) == 0) {
+    return false;
+  }
+  T* slot = q->ring.data + (head & q->mask);
+  *out = std::move(*slot);
+  std::destroy_at(slot);
+  q->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+// copy up to n elements to the back with a single publish, returning how
+// many fit (producer only)
+template <typename T>
+size_t spsc_push_batch(SpscQueue<T>* q, const T* elems, size_t n) {
+  size_t tail = q->tail.load(std::memory_order_relaxed);
+  size_t free_slots = spsc_free_slots(q, tail, n);
+  size_t k = n < free_slots ? n : free_slots;
+  for (size_t i = 0; i < k; ++i) {
+    new (q->ring.data + ((tail + i) & q->mask)) T(elems[i]);
+  }
+  q->tail.store(tail + k, std::memory_order_release);
+  return k;
+}
+
+// move up to n front elements into out with a single release, returning
+// how many were taken (consumer only)
+template <typename T>
+size_t spsc_pop_batch(SpscQueue<T>* q, T* out, size_t n) {
+  size_t head = q->head.load(std::memory_order_relaxed);
+  size_t used = spsc_used_slots(q, head, n);
+  size_t k = n < used ? n : used;
+  for (size_t i = 0; i < k; ++i) {
+    T* slot = q->ring.data + ((head + i) & q->mask);
+    out[i] = std::move(*slot);
+    std::destroy_at(slot);
+  }
+  q->head.store(head + k, std::memory_order_release);
+  return k;
+}
+
+// number of queued elements; only a snapshot while other threads run
+template <typename T> size_t spsc_size(const SpscQueue<T>* q) {
+  return q->tail.load(std::memory_order_acquire) -
+         q->head.load(std::memory_order_acquire);
+}
+
+// ring slot of the multi-producer/multi-consumer queue; seq equals the
+// ticket of the producer it awaits, or that ticket + 1 once it holds an
+// element for the matching consumer
+template <typename T> struct MpmcSlot {
+  std::atomic<size_t> seq;
+  alignas(T) unsigned char buf[sizeof(T)]; // element storage
+};
+
+// multi-producer/multi-consumer queue; producers and consumers each take
+// tickets from their own cache-line padded counter
+template <typename T> struct MpmcQueue {
+  DArray<MpmcSlot<T>> ring; // every slot constructed, ring.sz == ring.cap
+  size_t mask;              // capacity - 1
+
+  alignas(CACHE_LINE) std::atomic<size_t> tail; // next producer ticket
+  alignas(CACHE_LINE) std::atomic<size_t> head; // next consumer ticket
+};
+
+// element storage of a slot
+template <typename T> T* mpmc_elem(MpmcSlot<T>* slot) {
+  return reinterpret_cast<T*>(slot->buf);
+}
+
+// initialize queue in place with room for at least cap elements
+template <typename T> void mpmc_init(MpmcQueue<T>* q, size_t cap) {
+  cap = ring_capacity(cap);
+  q->ring = darray_create<MpmcSlot<T>>(cap);
+  for (size_t i = 0; i < cap; ++i) {
+    new (&q->ring.data[i].seq) std::atomic<size_t>(i);
+  }
+  q->ring.sz = cap;
+  q->mask = cap - 1;
+  q->tail.store(0, std::memory_order_relaxed);
+  q->head.store(0, std::memory_order_relaxed);
+}
+
+// destroy queued elements and free the ring; no other thread may be using
+// the queue
+template <typename T> void mpmc_destroy(MpmcQueue<T>* q) {
+  size_t tail = q->tail.load(std::memory_order_relaxed);
+  for (size_t i = q->head.load(std::memory_order_relaxed); i != tail; ++i) {
+    std::destroy_at(mpmc_elem(q->ring.data + (i & q->mask)));
+  }
+  darray_destroy(&q->ring);
+  q->tail.store(0, std::memory_order_relaxed);
+  q->head.store(0, std::memory_order_relaxed);
+}
+
+// claim up to n consecutive tickets from counter whose slots are ready,
+// i.e. have seq == ticket + offset (0 for producers, 1 for consumers);
+// returns how many were claimed, 0 if the queue is full or empty
+template <typename T>
+size_t mpmc_claim(MpmcQueue<T>* q, std::atomic<size_t>* counter,
+                  size_t offset, size_t n, size_t* first) {
+  size_t pos = counter->load(std::memory_order_relaxed);
+  for (;;) {
+    MpmcSlot<T>* slot = q->ring.data + (pos & q->mask);
+    size_t seq = slot->seq.load(std::memory_order_acquire);
+    intptr_t diff = (intptr_t)(seq - (pos + offset));
+    if (diff < 0) {
+      return 0; // slot still holds the previous lap
+    }
+    if (diff > 0) { // another thread took this ticket
+      pos = counter->load(std::memory_order_relaxed);
+      continue;
+    }
+
+    // slots only change hands through their ticket, so every slot seen
+    // ready here stays ready until this thread owns it
+    size_t k = 1;
+    while (k < n && q->ring.data[(pos + k) & q->mask].seq.load(
+                        std::memory_order_acquire) == pos + k + offset) {
+      ++k;
+    }
+    if (counter->compare_exchange_weak(pos, pos + k,
+                                       std::memory_order_relaxed)) {
+      *first = pos;
+      return k;
+    }
+  }
+}
+
+// construct element at the back; false if full
+template <typename T, typename... Args>
+bool mpmc_try_emplace(MpmcQueue<T>* q, Args&&... args) {
+  size_t pos;
+  if (!mpmc_claim(q, &q->tail, 0, 1, &pos)) {
+    return false;
+  }
+  MpmcSlot<T>* slot = q->ring.data + (pos & q->mask);
+  new (mpmc_elem(slot)) T(std::forward<Args>(args)...);
+  slot->seq.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T> bool mpmc_try_push(MpmcQueue<T>* q, const T& elem) {
+  return mpmc_try_emplace(q, elem);
+}
+
+template <typename T> bool mpmc_try_push(MpmcQueue<T>* q, T&& elem) {
+  return mpmc_try_emplace(q, std::move(elem));
+}
+
+// move front element into out; false if empty
+template <typename T> bool mpmc_try_pop(MpmcQueue<T>* q, T* out) {
+  size_t pos;
+  if (!mpmc_claim(q, &q->head, 1, 1, &pos)) {
+    return false;
+  }
+  MpmcSlot<T>* slot = q->ring.data + (pos & q->mask);
+  *out = std::move(*mpmc_elem(slot));
+  std::destroy_at(mpmc_elem(slot));
+  slot->seq.store(pos + q->ring.cap, std::memory_order_release);
+  return true;
+}
+
+// copy up to n elements to the back claiming all slots with one CAS,
+// returning how many were pushed
+template <typename T>
+size_t mpmc_push_batch(MpmcQueue<T>* q, const T* elems, size_t n) {
+  size_t pos;
+  size_t k = n ? mpmc_claim(q, &q->tail, 0, n, &pos) : 0;
+  for (size_t i = 0; i < k; ++i) {
+    MpmcSlot<T>* slot = q->ring.data + ((pos + i) & q->mask);
+    new (mpmc_elem(slot)) T(elems[i]);
+    slot->seq.store(pos + i + 1, std::memory_order_release);
+  }
+  return k;
+}
+
+// move up to n front elements into out claiming all slots with one CAS,
+// returning how many were taken
+template <typename T>
+size_t mpmc_pop_batch(MpmcQueue<T>* q, T* out, size_t n) {
+  size_t pos;
+  size_t k = n ? mpmc_claim(q, &q->head, 1, n, &pos) : 0;
+  for (size_t i = 0; i < k; ++i) {
+    MpmcSlot<T>* slot = q->ring.data + ((pos + i) & q->mask);
+    out[i] = std::move(*mpmc_elem(slot));
+    std::destroy_at(mpmc_elem(slot));
+    slot->seq.store(pos + i + q->ring.cap, std::memory_order_release);
+  }
+  return k;
+}
+
+// number of queued elements; only a snapshot while other threads run
+template <typename T> size_t mpmc_size(const MpmcQueue<T>* q) {
+  size_t head = q->head.load(std::memory_order_acquire);
+  size_t tail = q->tail.load(std::memory_order_acquire);
+  return tail > head ? tail - head : 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * ebr.hpp
+ *
+ * Epoch-based reclamation for lock-free structures. Readers pin the current
+ * epoch while they may hold pointers into the structure; a retired node is
+ * only freed once the global epoch has moved two steps past its retirement,
+ * by which point no pinned thread can still see it.
+ */
+
+#pragma once
+
+#include "../00_dynamic_array/darray.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#define CACHE_LINE 64       // bytes per cache line
+#define EBR_MAX_THREADS 64  // threads that may be registered at once
+#define EBR_RETIRE_BATCH 64 // retirements between epoch advance attempts
+#define EBR_BUCKETS 3       // limbo lists, one per epoch still in flight
+
+// per-thread state, padded so pinning never shares a line
+template <typename N> struct alignas(CACHE_LINE) EbrThread {
+  std::atomic<uint64_t> epoch;       // pinned epoch << 1 | 1, or 0
+  std::atomic<bool> in_use;          // slot owned by a registered thread
+  DArray<N*> limbo[EBR_BUCKETS];     // retired nodes by epoch % buckets
+  uint64_t limbo_epoch[EBR_BUCKETS]; // epoch each limbo list was filled in
+  size_t since_advance;              // retirements since last advance try
+};
+
+template <typename N> struct EbrDomain {
+  alignas(CACHE_LINE) std::atomic<uint64_t> global_epoch;
+  EbrThread<N> threads[EBR_MAX_THREADS];
+};
+
+// initialize domain in place
+template <typename N> void ebr_init(EbrDomain<N>* domain) {
+  domain->global_epoch.store(2);
+  for (EbrThread<N>& t : domain->threads) {
+    t.epoch.store(0);
+    t.in_use.store(false);
+    for (size_t b = 0; b < EBR_BUCKETS; ++b) {
+      t.limbo[b] = darray_create<N*>(0);
+      t.limbo_epoch[b] = 0;
+    }
+    t.since_advance = 0;
+  }
+}
+
+// delete every node in a limbo list
+template <typename N> void ebr_free_limbo(DArray<N*>* limbo) {
+  for (size_t i = 0; i < limbo->sz; ++i) {
+    delete limbo->data[i];
+  }
+  limbo->sz = 0;
+}
+
+// free all retired nodes; no thread may be pinned
+template <typename N> void ebr_destroy(EbrDomain<N>* domain) {
+  for (EbrThread<N>& t : domain->threads) {
+    for (size_t b = 0; b < EBR_BUCKETS; ++b) {
+      ebr_free_limbo(&t.limbo[b]);
+      darray_destroy(&t.limbo[b]);
+    }
+  }
+}
+
+// claim a thread slot; its leftover limbo lists come with it
+template <typename N> EbrThread<N>* ebr_register(EbrDomain<N>* domain) {
+  for (EbrThread<N>& t : domain->threads) {
+    bool expected = false;
+    if (!t.in_use.load(std::memory_order_relaxed) &&
+        t.in_use.compare_exchange_strong(expected, true)) {
+      return &t;
+    }
+  }
+  throw std::runtime_error("Too many threads registered");
+}
+
+// give the slot back; nodes still in limbo are freed by its next owner or
+// by ebr_destroy
+template <typename N> void ebr_unregister(EbrThread<N>* t) {
+  t->epoch.store(0);
+  t->in_use.store(false);
+}
+
+// free limbo lists retired at least two epochs before global
+template <typename N> void ebr_collect(EbrThread<N>* t, uint64_t global) {
+  for (size_t b = 0; b < EBR_BUCKETS; ++b) {
+    if (t->limbo[b].sz && t->limbo_epoch[b] + 2 <= global) {
+      ebr_free_limbo(&t->limbo[b]);
+    }
+  }
+}
+
+// announce that the caller may dereference shared nodes; the announcement
+// is retried until it matches the global epoch, so an advance can never
+// slip in between reading the epoch and publishing it
+template <typename N> void ebr_pin(EbrDomain<N>* domain, EbrThread<N>* t) {
+  uint64_t global = domain->global_epoch.load();
+  for (;;) {
+    t->epoch.store(global << 1 | 1);
+    uint64_t now = domain->global_epoch.load();
+    if (now == global) {
+      break;
+    }
+    global = now;
+  }
+}
+
+// leave the critical section
+template <typename N> void ebr_unpin(EbrThread<N>* t) {
+  t->epoch.store(0, std::memory_order_release);
+}
+
+// move the global epoch forward if every pinned thread has seen it
+template <typename N> void ebr_try_advance(EbrDomain<N>* domain) {
+  uint64_t global = domain->global_epoch.load();
+  for (EbrThread<N>& t : domain->threads) {
+    uint64_t e = t.epoch.load();
+    if ((e & 1) && (e >> 1) != global) {
+      return;
+    }
+  }
+  domain->global_epoch.compare_exchange_strong(global, global + 1);
+}
+
+// hand over a node that is no longer reachable; the caller must be pinned.
+// The node is tagged with the global epoch read after it was unlinked, not
+// the caller's pinned epoch: readers pinned one epoch ahead of the caller
+// may still have seen it.
+template <typename N>
+void ebr_retire(EbrDomain<N>* domain, EbrThread<N>* t, N* node) {
+  uint64_t epoch = domain->global_epoch.load();
+  size_t b = epoch % EBR_BUCKETS;
+  if (t->limbo_epoch[b] != epoch) {
+    // the list holds nodes from at least EBR_BUCKETS epochs ago
+    ebr_free_limbo(&t->limbo[b]);
+    t->limbo_epoch[b] = epoch;
+  }
+  darray_push_back(&t->limbo[b], node);
+
+  if (++t->since_advance >= EBR_RETIRE_BATCH) {
+    t->since_advance = 0;
+    ebr_try_advance(domain);
+    ebr_collect(t, domain->global_epoch.load());
+  }
+}
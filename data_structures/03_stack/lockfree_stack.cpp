@@ -0,0 +1,240 @@
+/**
+ * lockfree_stack.cpp
+ *
+ * Lock-free stack tests and scaling benchmarks against a mutex-guarded
+ * stack.
+ */
+
+#include "lockfree_stack.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// singly-linked stack behind one lock, the baseline
+template <typename T> struct LockedStack {
+  std::mutex lock;
+  Node<T>* head;
+};
+
+template <typename T> void locked_push(LockedStack<T>* stack, T data) {
+  Node<T>* new_node = node_create(std::move(data));
+  std::lock_guard<std::mutex> guard(stack->lock);
+  new_node->next = stack->head;
+  stack->head = new_node;
+}
+
+template <typename T> bool locked_pop(LockedStack<T>* stack, T* out) {
+  Node<T>* top;
+  {
+    std::lock_guard<std::mutex> guard(stack->lock);
+    top = stack->head;
+    if (!top) {
+      return false;
+    }
+    stack->head = top->next;
+  }
+  *out = std::move(top->data);
+  node_free(top);
+  return true;
+}
+
+// nodes waiting in a domain's limbo lists
+template <typename N> size_t limbo_size(const EbrDomain<N>* domain) {
+  size_t total = 0;
+  for (const EbrThread<N>& t : domain->threads) {
+    for (size_t b = 0; b < EBR_BUCKETS; ++b) {
+      total += t.limbo[b].sz;
+    }
+  }
+  return total;
+}
+
+// run f(thread index) on `threads` threads and wait for all of them
+template <typename F> void run_threads(size_t threads, F f) {
+  std::vector<std::thread> pool;
+  for (size_t i = 0; i < threads; ++i) {
+    pool.emplace_back(f, i);
+  }
+  for (auto& t : pool) {
+    t.join();
+  }
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Lock-Free Stack Tests");
+
+  suite.add_test("Push and pop", []() {
+    LockFreeStack<int> stack;
+    lfstack_init(&stack);
+    StackThread<int>* t = lfstack_register(&stack);
+    int out = 0;
+    test::assert_true(lfstack_empty(&stack));
+    test::assert_false(lfstack_pop(&stack, t, &out), "Popped empty stack");
+
+    for (int i = 0; i < 10; ++i) {
+      lfstack_push(&stack, i);
+    }
+    for (int i = 9; i >= 0; --i) {
+      test::assert_true(lfstack_pop(&stack, t, &out));
+      test::assert_equal(i, out);
+    }
+    test::assert_true(lfstack_empty(&stack));
+
+    lfstack_unregister(t);
+    lfstack_destroy(&stack);
+  });
+
+  suite.add_test("String operations", []() {
+    LockFreeStack<std::string> stack;
+    lfstack_init(&stack);
+    StackThread<std::string>* t = lfstack_register(&stack);
+    lfstack_push(&stack, std::string("Plato"));
+    lfstack_push(&stack, std::string(32, 'a'));
+    lfstack_push(&stack, std::string("Aristotle"));
+
+    std::string out;
+    test::assert_true(lfstack_pop(&stack, t, &out));
+    test::assert_equal(std::string("Aristotle"), out);
+
+    // remaining and retired nodes are freed by destroy
+    lfstack_unregister(t);
+    lfstack_destroy(&stack);
+  });
+
+  suite.add_test("Popped nodes are reclaimed", []() {
+    LockFreeStack<int> stack;
+    lfstack_init(&stack);
+    StackThread<int>* t = lfstack_register(&stack);
+    int out;
+    for (int i = 0; i < 100000; ++i) {
+      lfstack_push(&stack, i);
+      lfstack_pop(&stack, t, &out);
+    }
+    // with no other thread pinned, limbo never holds more than a few
+    // batches
+    test::assert_true(limbo_size(&stack.ebr) <= EBR_BUCKETS * EBR_RETIRE_BATCH,
+                      "Retired nodes are not being freed");
+
+    lfstack_unregister(t);
+    lfstack_destroy(&stack);
+  });
+
+  suite.add_test("Concurrent push and pop", []() {
+    LockFreeStack<int> stack;
+    lfstack_init(&stack);
+    const size_t threads = 4;
+    const int per_thread = 50000;
+    std::atomic<long> popped_sum{0};
+
+    // every thread pushes its own range, popping as it goes
+    run_threads(threads, [&](size_t id) {
+      StackThread<int>* t = lfstack_register(&stack);
+      long sum = 0;
+      int out;
+      for (int i = 0; i < per_thread; ++i) {
+        lfstack_push(&stack, int(id) * per_thread + i);
+        if (i % 2 && lfstack_pop(&stack, t, &out)) {
+          sum += out;
+        }
+      }
+      popped_sum.fetch_add(sum);
+      lfstack_unregister(t);
+    });
+
+    StackThread<int>* t = lfstack_register(&stack);
+    long sum = popped_sum.load();
+    int out;
+    while (lfstack_pop(&stack, t, &out)) {
+      sum += out;
+    }
+    long n = long(threads) * per_thread;
+    test::assert_equal(n * (n - 1) / 2, sum);
+
+    lfstack_unregister(t);
+    lfstack_destroy(&stack);
+  });
+
+  // error handling tests
+  suite.add_test("Too many threads", []() {
+    LockFreeStack<int> stack;
+    lfstack_init(&stack);
+    bool caught_exception = false;
+
+    try {
+      for (int i = 0; i <= EBR_MAX_THREADS; ++i) {
+        lfstack_register(&stack);
+      }
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    lfstack_destroy(&stack);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: the same total number of push/pop pairs split across
+  // 1 to max(2, cores) threads
+  test::Benchmark bench("Lock-Free Stack Benchmarks");
+  const size_t pairs = 200000;
+  size_t max_threads = std::max(2u, std::thread::hardware_concurrency());
+
+  LockFreeStack<int> lfstack;
+  lfstack_init(&lfstack);
+  LockedStack<int> locked;
+  locked.head = nullptr;
+
+  for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+    std::string suffix = " " + std::to_string(threads) +
+                         (threads == 1 ? " thread" : " threads");
+
+    bench.add_test(
+        "Mutex stack push/pop" + suffix,
+        [&, threads]() {
+          run_threads(threads, [&](size_t) {
+            int out;
+            for (size_t i = 0; i < pairs / threads; ++i) {
+              locked_push(&locked, int(i));
+              test::do_not_optimize(locked_pop(&locked, &out));
+            }
+          });
+        },
+        pairs);
+
+    bench.add_test(
+        "Lock-free stack push/pop" + suffix,
+        [&, threads]() {
+          run_threads(threads, [&](size_t) {
+            StackThread<int>* t = lfstack_register(&lfstack);
+            int out;
+            for (size_t i = 0; i < pairs / threads; ++i) {
+              lfstack_push(&lfstack, int(i));
+              test::do_not_optimize(lfstack_pop(&lfstack, t, &out));
+            }
+            lfstack_unregister(t);
+          });
+        },
+        pairs);
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  lfstack_destroy(&lfstack);
+  free_list(locked.head);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Lock-free stack program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * lockfree_stack.hpp
+ *
+ * A lock-free Treiber stack of singly-linked Node<T>s. Push and pop swing
+ * the head pointer with CAS; popped nodes are retired through epoch-based
+ * reclamation, which also rules out ABA: a node cannot be freed and reused
+ * at the same address while a popper that read it is still pinned.
+ */
+
+#pragma once
+
+#include "../01_linked_list/sll.hpp"
+#include "ebr.hpp"
+#include <atomic>
+#include <utility>
+
+template <typename T> struct LockFreeStack {
+  alignas(CACHE_LINE) std::atomic<Node<T>*> head;
+  EbrDomain<Node<T>> ebr; // reclaims popped nodes
+};
+
+// handle a thread needs to pop from a stack
+template <typename T> using StackThread = EbrThread<Node<T>>;
+
+// initialize empty stack in place
+template <typename T> void lfstack_init(LockFreeStack<T>* stack) {
+  stack->head.store(nullptr);
+  ebr_init(&stack->ebr);
+}
+
+// free remaining and retired nodes; no thread may be using the stack
+template <typename T> void lfstack_destroy(LockFreeStack<T>* stack) {
+  free_list(stack->head.load());
+  stack->head.store(nullptr);
+  ebr_destroy(&stack->ebr);
+}
+
+// register calling thread for pops
+template <typename T>
+StackThread<T>* lfstack_register(LockFreeStack<T>* stack) {
+  return ebr_register(&stack->ebr);
+}
+
+template <typename T> void lfstack_unregister(StackThread<T>* t) {
+  ebr_unregister(t);
+}
+
+// push element; needs no registration since it never reads other nodes
+template <typename T> void lfstack_push(LockFreeStack<T>* stack, T data) {
+  Node<T>* new_node = node_create(std::move(data));
+  new_node->next = stack->head.load(std::memory_order_relaxed);
+  while (!stack->head.compare_exchange_weak(new_node->next, new_node,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+  }
+}
+
+// pop top element into out; false if empty
+template <typename T>
+bool lfstack_pop(LockFreeStack<T>* stack, StackThread<T>* t, T* out) {
+  ebr_pin(&stack->ebr, t);
+  Node<T>* top = stack->head.load(std::memory_order_acquire);
+  while (top && !stack->head.compare_exchange_weak(
+                    top, top->next, std::memory_order_acquire,
+                    std::memory_order_acquire)) {
+  }
+  if (!top) {
+    ebr_unpin(t);
+    return false;
+  }
+
+  // other poppers may still read top->next, but never the data
+  *out = std::move(top->data);
+  ebr_retire(&stack->ebr, t, top);
+  ebr_unpin(t);
+  return true;
+}
+
+// true if the stack held no elements at the time of the call
+template <typename T> bool lfstack_empty(const LockFreeStack<T>* stack) {
+  return stack->head.load(std::memory_order_acquire) == nullptr;
+}
@@ -0,0 +1,215 @@
+/**
+ * concurrent_map.cpp
+ *
+ * Sharded concurrent hash map tests and throughput benchmarks against a
+ * single-lock map.
+ */
+
+#include "concurrent_map.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// one Swiss table behind one lock, the baseline
+struct LockedMap {
+  std::mutex lock;
+  SwissMap<int, int> map;
+};
+
+// run f(thread index) on `threads` threads and wait for all of them
+template <typename F> void run_threads(size_t threads, F f) {
+  std::vector<std::thread> pool;
+  for (size_t i = 0; i < threads; ++i) {
+    pool.emplace_back(f, i);
+  }
+  for (auto& t : pool) {
+    t.join();
+  }
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Concurrent Hash Map Tests");
+
+  suite.add_test("Insert, find and erase", []() {
+    ConcurrentMap<int, int> map;
+    cmap_init(&map, 4);
+    int out = 0;
+    test::assert_false(cmap_find(&map, 1, &out));
+
+    test::assert_true(cmap_insert(&map, 1, 10));
+    test::assert_false(cmap_insert(&map, 1, 11), "Duplicate inserted");
+    test::assert_true(cmap_find(&map, 1, &out));
+    test::assert_equal(11, out);
+    test::assert_true(cmap_erase(&map, 1));
+    test::assert_false(cmap_contains(&map, 1));
+    test::assert_equal(size_t(0), cmap_size(&map));
+
+    cmap_destroy(&map);
+  });
+
+  suite.add_test("Keys spread across shards", []() {
+    ConcurrentMap<int, int> map;
+    cmap_init(&map, 5); // rounds up to 8
+    test::assert_equal(size_t(8), map.num_shards);
+    for (int i = 0; i < 8000; ++i) {
+      cmap_insert(&map, i, i);
+    }
+    for (size_t s = 0; s < map.num_shards; ++s) {
+      size_t n = swiss_size(&map.shards[s].map);
+      test::assert_true(n > 500 && n < 1500, "Shards badly unbalanced");
+    }
+    test::assert_equal(size_t(8000), cmap_size(&map));
+
+    cmap_destroy(&map);
+  });
+
+  suite.add_test("Single shard", []() {
+    ConcurrentMap<std::string, int> map;
+    cmap_init(&map, 1);
+    cmap_insert(&map, std::string("Plato"), 1);
+    cmap_insert(&map, std::string("Aristotle"), 2);
+    int out;
+    test::assert_true(cmap_find(&map, std::string("Aristotle"), &out));
+    test::assert_equal(2, out);
+
+    cmap_destroy(&map);
+  });
+
+  suite.add_test("Concurrent writers and readers", []() {
+    ConcurrentMap<int, int> map;
+    cmap_init(&map);
+    const size_t threads = 4;
+    const int per_thread = 20000;
+    std::atomic<bool> consistent{true};
+
+    // each thread writes its own keys with value -key, erases every third,
+    // and reads keys written by the others, which must either be missing
+    // or hold the value they were written with
+    run_threads(threads, [&](size_t id) {
+      for (int i = 0; i < per_thread; ++i) {
+        int key = int(id) * per_thread + i;
+        cmap_insert(&map, key, -key);
+        if (i % 3 == 0) {
+          cmap_erase(&map, key);
+        }
+        int other = int((id + 1) % threads) * per_thread + i;
+        int out;
+        if (cmap_find(&map, other, &out) && out != -other) {
+          consistent = false;
+        }
+      }
+    });
+
+    test::assert_true(consistent.load(), "Read a torn or stale value");
+    size_t expected = 0;
+    for (int i = 0; i < per_thread; ++i) {
+      expected += i % 3 != 0;
+    }
+    test::assert_equal(threads * expected, cmap_size(&map));
+
+    cmap_destroy(&map);
+  });
+
+  // error handling tests
+  suite.add_test("Zero shards", []() {
+    ConcurrentMap<int, int> map;
+    bool caught_exception = false;
+
+    try {
+      cmap_init(&map, 0);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: the same total number of operations split across 1 to
+  // max(2, cores) threads at several read/write ratios; writes alternate
+  // insert and erase so the maps stay near their starting size
+  test::Benchmark bench("Concurrent Hash Map Benchmarks");
+  const size_t ops = 400000;
+  const int key_range = 1 << 20;
+  size_t max_threads = std::max(2u, std::thread::hardware_concurrency());
+
+  test::RandomGenerator gen;
+  auto keys = gen.generate_ints(ops, 0, key_range - 1);
+  auto dice = gen.generate_ints(ops, 0, 99);
+
+  ConcurrentMap<int, int> cmap;
+  cmap_init(&cmap);
+  LockedMap locked;
+  locked.map = swiss_create<int, int>();
+  for (int i = 0; i < key_range; i += 2) {
+    cmap_insert(&cmap, i, i);
+    swiss_insert(&locked.map, i, i);
+  }
+
+  for (int read_pct : {100, 90, 50}) {
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+      std::string suffix = " " + std::to_string(read_pct) + "% reads, " +
+                           std::to_string(threads) +
+                           (threads == 1 ? " thread" : " threads");
+
+      bench.add_test(
+          "Single lock" + suffix,
+          [&, read_pct, threads]() {
+            run_threads(threads, [&](size_t id) {
+              long found = 0;
+              for (size_t i = id; i < ops; i += threads) {
+                std::lock_guard<std::mutex> guard(locked.lock);
+                if (dice[i] < read_pct) {
+                  found += swiss_contains(&locked.map, keys[i]);
+                } else if (i & 1) {
+                  swiss_insert(&locked.map, keys[i], keys[i]);
+                } else {
+                  swiss_erase(&locked.map, keys[i]);
+                }
+              }
+              test::do_not_optimize(found);
+            });
+          },
+          ops);
+
+      bench.add_test(
+          "Sharded" + suffix,
+          [&, read_pct, threads]() {
+            run_threads(threads, [&](size_t id) {
+              long found = 0;
+              for (size_t i = id; i < ops; i += threads) {
+                if (dice[i] < read_pct) {
+                  found += cmap_contains(&cmap, keys[i]);
+                } else if (i & 1) {
+                  cmap_insert(&cmap, keys[i], keys[i]);
+                } else {
+                  cmap_erase(&cmap, keys[i]);
+                }
+              }
+              test::do_not_optimize(found);
+            });
+          },
+          ops);
+    }
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  cmap_destroy(&cmap);
+  swiss_destroy(&locked.map);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Concurrent hash map program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
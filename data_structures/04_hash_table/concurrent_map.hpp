@@ -0,0 +1,123 @@
+/**
+ * concurrent_map.hpp
+ *
+ * A concurrent hash map split into independently locked shards, each a
+ * Swiss table. Lookups take a shard's lock in shared mode only, and a
+ * shard that fills up rehashes under its own lock while every other shard
+ * keeps serving.
+ */
+
+#pragma once
+
+#include "swiss_map.hpp"
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+#define CACHE_LINE 64  // bytes per cache line
+#define CMAP_SHARDS 64 // default number of shards
+
+// one lock and its table, on lines of their own so neighbouring shards
+// never contend on the same cache line
+template <typename K, typename V, typename Hash>
+struct alignas(CACHE_LINE) MapShard {
+  std::shared_mutex lock;
+  SwissMap<K, V, Hash> map;
+};
+
+template <typename K, typename V, typename Hash = SwissHash<K>>
+struct ConcurrentMap {
+  MapShard<K, V, Hash>* shards;
+  size_t num_shards; // a power of two
+  unsigned shift;    // hash >> shift selects the shard
+  Hash hash;
+};
+
+// initialize map with at least num_shards shards
+template <typename K, typename V, typename Hash>
+void cmap_init(ConcurrentMap<K, V, Hash>* map, size_t num_shards = CMAP_SHARDS,
+               Hash hash = Hash()) {
+  if (num_shards == 0) {
+    throw std::runtime_error("Map needs at least one shard");
+  }
+  // shards are chosen by the top bits, which Swiss tables use least
+  unsigned bits = 0;
+  while ((size_t(1) << bits) < num_shards) {
+    bits++;
+  }
+  map->num_shards = size_t(1) << bits;
+  map->shift = 64 - bits;
+  map->hash = hash;
+  map->shards = new MapShard<K, V, Hash>[map->num_shards];
+  for (size_t i = 0; i < map->num_shards; ++i) {
+    map->shards[i].map = swiss_create<K, V, Hash>(0, hash);
+  }
+}
+
+// free every shard; no other thread may be using the map
+template <typename K, typename V, typename Hash>
+void cmap_destroy(ConcurrentMap<K, V, Hash>* map) {
+  for (size_t i = 0; i < map->num_shards; ++i) {
+    swiss_destroy(&map->shards[i].map);
+  }
+  delete[] map->shards;
+  map->shards = nullptr;
+  map->num_shards = 0;
+}
+
+// shard responsible for key
+template <typename K, typename V, typename Hash>
+MapShard<K, V, Hash>* cmap_shard(ConcurrentMap<K, V, Hash>* map,
+                                 const K& key) {
+  size_t hash = map->hash(key);
+  return map->shards + (map->shift == 64 ? 0 : hash >> map->shift);
+}
+
+// copy the value of key into out; false if absent
+template <typename K, typename V, typename Hash>
+bool cmap_find(ConcurrentMap<K, V, Hash>* map, const K& key, V* out) {
+  MapShard<K, V, Hash>* shard = cmap_shard(map, key);
+  std::shared_lock<std::shared_mutex> guard(shard->lock);
+  V* value = swiss_find(&shard->map, key);
+  if (!value) {
+    return false;
+  }
+  *out = *value;
+  return true;
+}
+
+template <typename K, typename V, typename Hash>
+bool cmap_contains(ConcurrentMap<K, V, Hash>* map, const K& key) {
+  MapShard<K, V, Hash>* shard = cmap_shard(map, key);
+  std::shared_lock<std::shared_mutex> guard(shard->lock);
+  return swiss_contains(&shard->map, key);
+}
+
+// insert key, or assign value if already present; true if newly inserted
+template <typename K, typename V, typename Hash>
+bool cmap_insert(ConcurrentMap<K, V, Hash>* map, K key, V value) {
+  MapShard<K, V, Hash>* shard = cmap_shard(map, key);
+  std::unique_lock<std::shared_mutex> guard(shard->lock);
+  return swiss_insert(&shard->map, std::move(key), std::move(value));
+}
+
+// remove key, returning whether it was present
+template <typename K, typename V, typename Hash>
+bool cmap_erase(ConcurrentMap<K, V, Hash>* map, const K& key) {
+  MapShard<K, V, Hash>* shard = cmap_shard(map, key);
+  std::unique_lock<std::shared_mutex> guard(shard->lock);
+  return swiss_erase(&shard->map, key);
+}
+
+// number of entries; shards are counted one at a time, so this is only a
+// snapshot while other threads write
+template <typename K, typename V, typename Hash>
+size_t cmap_size(ConcurrentMap<K, V, Hash>* map) {
+  size_t total = 0;
+  for (size_t i = 0; i < map->num_shards; ++i) {
+    std::shared_lock<std::shared_mutex> guard(map->shards[i].lock);
+    total += swiss_size(&map->shards[i].map);
+  }
+  return total;
+}
@@ -0,0 +1,297 @@
+/**
+ * swiss_map.cpp
+ *
+ * Swiss-table hash map tests and benchmarks against std::unordered_map.
+ */
+
+#include "swiss_map.hpp"
+#include "testing.hpp"
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// distinct, well-spread keys: an odd multiplier is a bijection on 64 bits
+uint64_t bench_key(uint64_t i) { return i * 0x9E3779B97F4A7C15ull + 1; }
+
+// hash that sends every key to the same group and tag
+struct CollidingHash {
+  size_t operator()(int) const { return 0; }
+};
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Swiss Table Tests");
+
+  suite.add_test("Initialization", []() {
+    auto map = swiss_create<int, int>();
+    test::assert_equal(size_t(0), swiss_size(&map));
+    test::assert_true(swiss_find(&map, 1) == nullptr);
+    test::assert_false(swiss_erase(&map, 1));
+
+    swiss_destroy(&map);
+  });
+
+  suite.add_test("Insert, find and assign", []() {
+    auto map = swiss_create<int, int>();
+    test::assert_true(swiss_insert(&map, 1, 10));
+    test::assert_true(swiss_insert(&map, 2, 20));
+    test::assert_false(swiss_insert(&map, 1, 11), "Duplicate inserted");
+    test::assert_equal(size_t(2), swiss_size(&map));
+    test::assert_equal(11, *swiss_find(&map, 1));
+    test::assert_true(swiss_contains(&map, 2));
+    test::assert_false(swiss_contains(&map, 3));
+
+    swiss_destroy(&map);
+  });
+
+  suite.add_test("Grows and matches reference", []() {
+    auto map = swiss_create<int, int>();
+    std::unordered_map<int, int> ref;
+    test::RandomGenerator gen;
+    auto keys = gen.generate_ints(50000, 0, 100000);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      int key = keys[i];
+      if (i % 4 == 3) {
+        test::assert_equal(ref.erase(key) == 1, swiss_erase(&map, key));
+      } else {
+        bool inserted = ref.insert_or_assign(key, int(i)).second;
+        test::assert_equal(inserted, swiss_insert(&map, key, int(i)));
+      }
+    }
+    test::assert_equal(ref.size(), swiss_size(&map));
+    for (const auto& [key, value] : ref) {
+      int* found = swiss_find(&map, key);
+      test::assert_true(found && *found == value);
+    }
+    size_t visited = 0;
+    swiss_for_each(&map, [&](int key, int value) {
+      visited++;
+      test::assert_equal(ref[key], value);
+    });
+    test::assert_equal(ref.size(), visited);
+
+    swiss_destroy(&map);
+  });
+
+  suite.add_test("Erase leaves no tombstone in a sparse group", []() {
+    auto map = swiss_create<int, int>();
+    swiss_insert(&map, 1, 1);
+    size_t growth = map.growth_left;
+    swiss_erase(&map, 1);
+    test::assert_equal(growth + 1, map.growth_left);
+    for (size_t i = 0; i < map.cap; ++i) {
+      test::assert_true(map.ctrl[i] == SWISS_EMPTY, "Tombstone left");
+    }
+
+    swiss_destroy(&map);
+  });
+
+  suite.add_test("Full probe chains with a degenerate hash", []() {
+    auto map = swiss_create<int, int, CollidingHash>();
+    for (int i = 0; i < 100; ++i) {
+      swiss_insert(&map, i, i);
+    }
+    // erase from full groups, forcing tombstones, then churn through them
+    for (int i = 0; i < 100; i += 2) {
+      test::assert_true(swiss_erase(&map, i));
+    }
+    for (int round = 0; round < 20; ++round) {
+      for (int i = 0; i < 100; i += 2) {
+        swiss_insert(&map, 1000 * round + i, i);
+        swiss_erase(&map, 1000 * round + i);
+      }
+    }
+    for (int i = 0; i < 100; ++i) {
+      test::assert_equal(i % 2 == 1, swiss_contains(&map, i));
+    }
+    test::assert_equal(size_t(50), swiss_size(&map));
+
+    swiss_destroy(&map);
+  });
+
+  suite.add_test("Reserve and rehash move entries", []() {
+    auto map = swiss_create<std::string, std::string>(100);
+    size_t cap = map.cap;
+    test::assert_true(swiss_max_load(cap) >= 100);
+    for (int i = 0; i < 100; ++i) {
+      std::string value(32, char('a' + i % 26));
+      swiss_insert(&map, std::to_string(i), value);
+    }
+    test::assert_equal(cap, map.cap, "Reserved map rehashed");
+
+    swiss_rehash(&map, 4 * cap);
+    test::assert_equal(size_t(100), swiss_size(&map));
+    test::assert_equal(std::string(32, 'd'),
+                       *swiss_find(&map, std::string("3")));
+
+    swiss_destroy(&map);
+  });
+
+  // error handling tests
+  suite.add_test("Rehash below size", []() {
+    auto map = swiss_create<int, int>();
+    for (int i = 0; i < 100; ++i) {
+      swiss_insert(&map, i, i);
+    }
+    bool caught_exception = false;
+
+    try {
+      swiss_rehash(&map, SWISS_MIN_CAP);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    swiss_destroy(&map);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: lookups and churn in maps of 10^3 to 10^7 keys; each
+  // call does a fixed number of operations so sizes are comparable
+  test::Benchmark bench("Swiss Table Benchmarks");
+  const size_t lookups = 100000;
+  const size_t churn = 10000;
+  test::RandomGenerator gen;
+
+  std::vector<SwissMap<uint64_t, uint64_t>> swiss_maps;
+  std::vector<std::unordered_map<uint64_t, uint64_t>> std_maps;
+  std::vector<size_t> sizes = {1000, 10000, 100000, 1000000, 10000000};
+  swiss_maps.reserve(sizes.size());
+  std_maps.reserve(sizes.size());
+
+  for (size_t n : sizes) {
+    auto& swiss = swiss_maps.emplace_back(swiss_create<uint64_t, uint64_t>());
+    auto& std_map = std_maps.emplace_back();
+    for (size_t i = 0; i < n; ++i) {
+      swiss_insert(&swiss, bench_key(i), uint64_t(i));
+      std_map.emplace(bench_key(i), i);
+    }
+
+    // random present keys, absent keys, and a window of fresh keys
+    auto idx = gen.generate_ints(lookups, 0, int(n) - 1);
+    std::vector<uint64_t> hits;
+    std::vector<uint64_t> misses;
+    std::vector<uint64_t> fresh;
+    for (size_t i = 0; i < lookups; ++i) {
+      hits.push_back(bench_key(idx[i]));
+      misses.push_back(bench_key(n + idx[i]));
+    }
+    for (size_t i = 0; i < churn; ++i) {
+      fresh.push_back(bench_key(2 * n + i));
+    }
+    std::string suffix = " (" + std::to_string(n) + " keys)";
+
+    bench.add_test(
+        "std::unordered_map hit" + suffix,
+        [&std_map, hits]() {
+          uint64_t sum = 0;
+          for (uint64_t key : hits) {
+            sum += std_map.find(key)->second;
+          }
+          test::do_not_optimize(sum);
+        },
+        lookups);
+
+    bench.add_test(
+        "Swiss table hit" + suffix,
+        [&swiss, hits]() {
+          uint64_t sum = 0;
+          for (uint64_t key : hits) {
+            sum += *swiss_find(&swiss, key);
+          }
+          test::do_not_optimize(sum);
+        },
+        lookups);
+
+    bench.add_test(
+        "std::unordered_map miss" + suffix,
+        [&std_map, misses]() {
+          size_t found = 0;
+          for (uint64_t key : misses) {
+            found += std_map.count(key);
+          }
+          test::do_not_optimize(found);
+        },
+        lookups);
+
+    bench.add_test(
+        "Swiss table miss" + suffix,
+        [&swiss, misses]() {
+          size_t found = 0;
+          for (uint64_t key : misses) {
+            found += swiss_contains(&swiss, key);
+          }
+          test::do_not_optimize(found);
+        },
+        lookups);
+
+    // insert a window of fresh keys then erase them again, so the map
+    // stays at n keys across calls
+    bench.add_test(
+        "std::unordered_map insert + erase" + suffix,
+        [&std_map, fresh]() {
+          for (uint64_t key : fresh) {
+            std_map.emplace(key, key);
+          }
+          for (uint64_t key : fresh) {
+            std_map.erase(key);
+          }
+        },
+        2 * churn);
+
+    bench.add_test(
+        "Swiss table insert + erase" + suffix,
+        [&swiss, fresh]() {
+          for (uint64_t key : fresh) {
+            swiss_insert(&swiss, key, key);
+          }
+          for (uint64_t key : fresh) {
+            swiss_erase(&swiss, key);
+          }
+        },
+        2 * churn);
+  }
+
+  // building from empty, including every rehash on the way
+  const size_t build = 1000000;
+  bench.add_test(
+      "std::unordered_map build (1000000 keys)",
+      []() {
+        std::unordered_map<uint64_t, uint64_t> map;
+        for (size_t i = 0; i < build; ++i) {
+          map.emplace(bench_key(i), i);
+        }
+        test::do_not_optimize(map.size());
+      },
+      build);
+
+  bench.add_test(
+      "Swiss table build (1000000 keys)",
+      []() {
+        auto map = swiss_create<uint64_t, uint64_t>();
+        for (size_t i = 0; i < build; ++i) {
+          swiss_insert(&map, bench_key(i), uint64_t(i));
+        }
+        test::do_not_optimize(map.sz);
+        swiss_destroy(&map);
+      },
+      build);
+
+  // run all benchmarks
+  bench.run();
+
+  for (auto& map : swiss_maps) {
+    swiss_destroy(&map);
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Swiss table program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,300 @@
+/**
+ * swiss_map.hpp
+ *
+ * An open-addressing hash map in the style of Swiss tables. A separate
+ * array of one-byte control tags holds 7 bits of each key's hash; lookups
+ * compare a whole 16-tag group at once (SSE2 where available) and only
+ * touch slots whose tag matches.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define SWISS_GROUP 16   // control tags probed together
+#define SWISS_MIN_CAP 16 // smallest non-empty table, one group
+#define SWISS_LOAD_NUM 7 // max load factor numerator
+#define SWISS_LOAD_DEN 8 // max load factor denominator
+
+// control tags: a full slot holds the low 7 bits of its hash (0..127)
+#define SWISS_EMPTY ((int8_t)-128) // never used since the last rehash
+#define SWISS_DELETED ((int8_t)-2) // erased; probing must continue past it
+
+// default hash: std::hash mixed so that both the low bits (tag) and the
+// high bits (position) are well distributed, even for identity hashes
+template <typename K> struct SwissHash {
+  size_t operator()(const K& key) const {
+    __uint128_t m = (__uint128_t)std::hash<K>{}(key) * 0x9E3779B97F4A7C15ull;
+    return size_t(m >> 64) ^ size_t(m);
+  }
+};
+
+template <typename K, typename V> struct SwissEntry {
+  K key;
+  V value;
+};
+
+template <typename K, typename V, typename Hash = SwissHash<K>>
+struct SwissMap {
+  int8_t* ctrl;            // one tag per slot
+  SwissEntry<K, V>* slots; // entry storage, constructed where full
+  size_t cap;              // slots, a power of two >= SWISS_MIN_CAP or 0
+  size_t sz;               // full slots
+  size_t growth_left;      // empty slots that may still be filled
+  Hash hash;
+};
+
+// bit i set for each tag i of a group that equals h2, is empty, or is free
+// (empty or deleted)
+#if defined(__SSE2__)
+inline unsigned swiss_match(const int8_t* group, int8_t h2) {
+  __m128i tags = _mm_loadu_si128((const __m128i*)group);
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(tags, _mm_set1_epi8(h2)));
+}
+
+inline unsigned swiss_match_empty(const int8_t* group) {
+  return swiss_match(group, SWISS_EMPTY);
+}
+
+inline unsigned swiss_match_free(const int8_t* group) {
+  __m128i tags = _mm_loadu_si128((const __m128i*)group);
+  return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), tags));
+}
+#else
+inline unsigned swiss_match(const int8_t* group, int8_t h2) {
+  unsigned mask = 0;
+  for (int i = 0; i < SWISS_GROUP; ++i) {
+    mask |= unsigned(group[i] == h2) << i;
+  }
+  return mask;
+}
+
+inline unsigned swiss_match_empty(const int8_t* group) {
+  return swiss_match(group, SWISS_EMPTY);
+}
+
+inline unsigned swiss_match_free(const int8_t* group) {
+  unsigned mask = 0;
+  for (int i = 0; i < SWISS_GROUP; ++i) {
+    mask |= unsigned(group[i] < -1) << i;
+  }
+  return mask;
+}
+#endif
+
+// tag and starting group of a hash
+inline int8_t swiss_h2(size_t hash) { return int8_t(hash & 0x7F); }
+
+inline size_t swiss_h1(size_t hash) { return hash >> 7; }
+
+// most slots that may be filled before the table must grow
+inline size_t swiss_max_load(size_t cap) {
+  return cap / SWISS_LOAD_DEN * SWISS_LOAD_NUM;
+}
+
+// destroy entries and free memory
+template <typename K, typename V, typename Hash>
+void swiss_destroy(SwissMap<K, V, Hash>* map) {
+  for (size_t i = 0; i < map->cap; ++i) {
+    if (map->ctrl[i] >= 0) {
+      std::destroy_at(map->slots + i);
+    }
+  }
+  free(map->ctrl);
+  free(map->slots);
+  map->ctrl = nullptr;
+  map->slots = nullptr;
+  map->cap = map->sz = map->growth_left = 0;
+}
+
+// number of entries
+template <typename K, typename V, typename Hash>
+size_t swiss_size(const SwissMap<K, V, Hash>* map) {
+  return map->sz;
+}
+
+// index of the slot holding key, or cap if absent; groups are visited in
+// triangular order, which covers every group of a power-of-two table
+template <typename K, typename V, typename Hash>
+size_t swiss_find_slot(const SwissMap<K, V, Hash>* map, const K& key,
+                       size_t hash) {
+  if (map->cap == 0) {
+    return map->cap;
+  }
+  size_t group_mask = map->cap / SWISS_GROUP - 1;
+  size_t group = swiss_h1(hash) & group_mask;
+  int8_t h2 = swiss_h2(hash);
+  for (size_t step = 1;; ++step) {
+    const int8_t* tags = map->ctrl + group * SWISS_GROUP;
+    for (unsigned m = swiss_match(tags, h2); m; m &= m - 1) {
+      size_t slot = group * SWISS_GROUP + __builtin_ctz(m);
+      if (map->slots[slot].key == key) {
+        return slot;
+      }
+    }
+    if (swiss_match_empty(tags)) {
+      return map->cap;
+    }
+    group = (group + step) & group_mask;
+  }
+}
+
+// first empty or deleted slot on the probe sequence of hash
+template <typename K, typename V, typename Hash>
+size_t swiss_free_slot(const SwissMap<K, V, Hash>* map, size_t hash) {
+  size_t group_mask = map->cap / SWISS_GROUP - 1;
+  size_t group = swiss_h1(hash) & group_mask;
+  for (size_t step = 1;; ++step) {
+    unsigned m = swiss_match_free(map->ctrl + group * SWISS_GROUP);
+    if (m) {
+      return group * SWISS_GROUP + __builtin_ctz(m);
+    }
+    group = (group + step) & group_mask;
+  }
+}
+
+// move every entry into a fresh table of new_cap slots (a power of two
+// >= SWISS_MIN_CAP that fits them); also clears all tombstones
+template <typename K, typename V, typename Hash>
+void swiss_rehash(SwissMap<K, V, Hash>* map, size_t new_cap) {
+  if (new_cap < SWISS_MIN_CAP || (new_cap & (new_cap - 1)) ||
+      swiss_max_load(new_cap) < map->sz) {
+    throw std::runtime_error("Invalid hash table capacity");
+  }
+  int8_t* ctrl = (int8_t*)malloc(new_cap);
+  SwissEntry<K, V>* slots =
+      (SwissEntry<K, V>*)malloc(new_cap * sizeof(SwissEntry<K, V>));
+  if (!ctrl || !slots) {
+    free(ctrl);
+    free(slots);
+    throw std::bad_alloc();
+  }
+  memset(ctrl, SWISS_EMPTY, new_cap);
+
+  int8_t* old_ctrl = map->ctrl;
+  SwissEntry<K, V>* old_slots = map->slots;
+  size_t old_cap = map->cap;
+  map->ctrl = ctrl;
+  map->slots = slots;
+  map->cap = new_cap;
+  for (size_t i = 0; i < old_cap; ++i) {
+    if (old_ctrl[i] >= 0) {
+      size_t hash = map->hash(old_slots[i].key);
+      size_t slot = swiss_free_slot(map, hash);
+      ctrl[slot] = swiss_h2(hash);
+      new (slots + slot) SwissEntry<K, V>(std::move(old_slots[i]));
+      std::destroy_at(old_slots + i);
+    }
+  }
+  map->growth_left = swiss_max_load(new_cap) - map->sz;
+  free(old_ctrl);
+  free(old_slots);
+}
+
+// ensure room for n entries without further rehashing
+template <typename K, typename V, typename Hash>
+void swiss_reserve(SwissMap<K, V, Hash>* map, size_t n) {
+  if (n <= map->sz + map->growth_left) {
+    return;
+  }
+  size_t cap = map->cap ? map->cap : SWISS_MIN_CAP;
+  while (swiss_max_load(cap) < n) {
+    cap *= 2;
+  }
+  swiss_rehash(map, cap);
+}
+
+// initialize empty map; no memory is allocated until the first insert
+// unless cap is given
+template <typename K, typename V, typename Hash = SwissHash<K>>
+SwissMap<K, V, Hash> swiss_create(size_t cap = 0, Hash hash = Hash()) {
+  SwissMap<K, V, Hash> map{nullptr, nullptr, 0, 0, 0, std::move(hash)};
+  if (cap) {
+    swiss_reserve(&map, cap);
+  }
+  return map;
+}
+
+// pointer to the value of key, or nullptr if absent
+template <typename K, typename V, typename Hash>
+V* swiss_find(SwissMap<K, V, Hash>* map, const K& key) {
+  size_t slot = swiss_find_slot(map, key, map->hash(key));
+  return slot < map->cap ? &map->slots[slot].value : nullptr;
+}
+
+template <typename K, typename V, typename Hash>
+bool swiss_contains(const SwissMap<K, V, Hash>* map, const K& key) {
+  return swiss_find_slot(map, key, map->hash(key)) < map->cap;
+}
+
+// insert key, or assign value if already present; true if newly inserted
+template <typename K, typename V, typename Hash>
+bool swiss_insert(SwissMap<K, V, Hash>* map, K key, V value) {
+  size_t hash = map->hash(key);
+  size_t slot = swiss_find_slot(map, key, hash);
+  if (slot < map->cap) {
+    map->slots[slot].value = std::move(value);
+    return false;
+  }
+
+  if (map->cap == 0) {
+    swiss_rehash(map, SWISS_MIN_CAP);
+  }
+  slot = swiss_free_slot(map, hash);
+  if (map->ctrl[slot] == SWISS_EMPTY && map->growth_left == 0) {
+    // if at least half the used slots are tombstones, clearing them frees
+    // enough room; otherwise double
+    bool crowded = map->sz * 2 > swiss_max_load(map->cap);
+    swiss_rehash(map, crowded ? map->cap * 2 : map->cap);
+    slot = swiss_free_slot(map, hash);
+  }
+
+  map->growth_left -= map->ctrl[slot] == SWISS_EMPTY;
+  map->ctrl[slot] = swiss_h2(hash);
+  new (map->slots + slot) SwissEntry<K, V>{std::move(key), std::move(value)};
+  map->sz++;
+  return true;
+}
+
+// remove key, returning whether it was present. The slot becomes empty
+// again when its group still has an empty tag: no probe sequence has ever
+// continued past such a group, so no tombstone is needed.
+template <typename K, typename V, typename Hash>
+bool swiss_erase(SwissMap<K, V, Hash>* map, const K& key) {
+  size_t slot = swiss_find_slot(map, key, map->hash(key));
+  if (slot >= map->cap) {
+    return false;
+  }
+  std::destroy_at(map->slots + slot);
+  const int8_t* group = map->ctrl + slot / SWISS_GROUP * SWISS_GROUP;
+  if (swiss_match_empty(group)) {
+    map->ctrl[slot] = SWISS_EMPTY;
+    map->growth_left++;
+  } else {
+    map->ctrl[slot] = SWISS_DELETED;
+  }
+  map->sz--;
+  return true;
+}
+
+// call f(key, value) on every entry, in table order
+template <typename K, typename V, typename Hash, typename F>
+void swiss_for_each(SwissMap<K, V, Hash>* map, F f) {
+  for (size_t i = 0; i < map->cap; ++i) {
+    if (map->ctrl[i] >= 0) {
+      f(map->slots[i].key, map->slots[i].value);
+    }
+  }
+}
@@ -0,0 +1,394 @@
+/**
+ * avl.cpp
+ *
+ * AVL tree tests and benchmarks against std::map.
+ */
+
+#include "avl.hpp"
+#include "testing.hpp"
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+// check order, balance, heights and sizes below node; returns its height
+template <typename K, typename V>
+int avl_check(const AvlNode<K, V>* node, const K* lo, const K* hi) {
+  if (!node) {
+    return 0;
+  }
+  test::assert_true(!lo || *lo < node->key, "Keys out of order");
+  test::assert_true(!hi || node->key < *hi, "Keys out of order");
+  int left = avl_check(node->left, lo, &node->key);
+  int right = avl_check(node->right, &node->key, hi);
+  test::assert_true(left - right <= 1 && right - left <= 1, "Unbalanced");
+  test::assert_equal(1 + std::max(left, right), node->height);
+  test::assert_equal(1 + avl_size(node->left) + avl_size(node->right),
+                     node->size);
+  return node->height;
+}
+
+template <typename K, typename V> void avl_check(const AvlTree<K, V>* tree) {
+  avl_check<K, V>(tree->root, nullptr, nullptr);
+}
+
+// sorted entries i -> 10 * i for i in [0, n)
+DArray<AvlEntry<int, int>> sorted_entries(size_t n) {
+  auto entries = darray_create<AvlEntry<int, int>>(n ? n : 1);
+  for (size_t i = 0; i < n; ++i) {
+    darray_push_back(&entries, AvlEntry<int, int>{int(i), int(10 * i)});
+  }
+  return entries;
+}
+
+// value that counts live copies and throws from the copy that would take
+// the copy budget below zero
+struct Fragile {
+  static long live;
+  static long copies_left;
+  int v;
+
+  explicit Fragile(int v) : v(v) { live++; }
+  Fragile(const Fragile& other) : v(other.v) {
+    if (copies_left-- == 0) {
+      throw std::runtime_error("Copy failed");
+    }
+    live++;
+  }
+  Fragile& operator=(const Fragile&) = default;
+  ~Fragile() { live--; }
+};
+long Fragile::live = 0;
+long Fragile::copies_left = -1;
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("AVL Tree Tests");
+
+  suite.add_test("Insert, find and assign", []() {
+    auto tree = avl_create<int, int>();
+    test::assert_true(avl_find(&tree, 1) == nullptr);
+    test::assert_true(avl_insert(&tree, 2, 20));
+    test::assert_true(avl_insert(&tree, 1, 10));
+    test::assert_false(avl_insert(&tree, 2, 21), "Duplicate inserted");
+    test::assert_equal(size_t(2), avl_size(&tree));
+    test::assert_equal(21, *avl_find(&tree, 2));
+    test::assert_true(avl_contains(&tree, 1));
+    test::assert_false(avl_contains(&tree, 3));
+
+    avl_destroy(&tree);
+  });
+
+  suite.add_test("Sorted inserts stay balanced", []() {
+    auto tree = avl_create<int, int>();
+    for (int i = 0; i < 1023; ++i) {
+      avl_insert(&tree, i, i);
+    }
+    avl_check(&tree);
+    // a perfect tree, the best any tree of 2^10 - 1 nodes can do
+    test::assert_equal(10, avl_height(&tree));
+
+    avl_destroy(&tree);
+  });
+
+  suite.add_test("Matches reference under random load", []() {
+    auto tree = avl_create<int, int>();
+    std::map<int, int> ref;
+    test::RandomGenerator gen;
+    auto keys = gen.generate_ints(20000, 0, 5000);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+      int key = keys[i];
+      if (i % 3 == 2) {
+        test::assert_equal(ref.erase(key) == 1, avl_erase(&tree, key));
+      } else {
+        bool inserted = ref.insert_or_assign(key, int(i)).second;
+        test::assert_equal(inserted, avl_insert(&tree, key, int(i)));
+      }
+    }
+    avl_check(&tree);
+    test::assert_equal(ref.size(), avl_size(&tree));
+
+    auto it = ref.begin();
+    avl_for_each(&tree, [&](int key, int value) {
+      test::assert_equal(it->first, key);
+      test::assert_equal(it->second, value);
+      ++it;
+    });
+    test::assert_true(it == ref.end(), "Entries missing from traversal");
+
+    avl_destroy(&tree);
+  });
+
+  suite.add_test("Rank and select", []() {
+    auto tree = avl_create<int, int>();
+    for (int i = 0; i < 500; ++i) {
+      avl_insert(&tree, 2 * i, i); // even keys only
+    }
+    for (int i = 0; i < 500; ++i) {
+      test::assert_equal(size_t(i), avl_rank(&tree, 2 * i));
+      test::assert_equal(size_t(i + 1), avl_rank(&tree, 2 * i + 1));
+      test::assert_equal(2 * i, avl_select(&tree, i)->key);
+    }
+    test::assert_equal(size_t(0), avl_rank(&tree, -5));
+
+    // the median stays right while the tree shrinks from the front
+    for (int i = 0; i < 100; ++i) {
+      avl_erase(&tree, 2 * i);
+    }
+    test::assert_equal(2 * 300, avl_select(&tree, 200)->key);
+
+    avl_destroy(&tree);
+  });
+
+  suite.add_test("Range iteration", []() {
+    auto tree = avl_create<int, int>();
+    for (int i = 0; i < 100; ++i) {
+      avl_insert(&tree, i, i);
+    }
+    std::vector<int> seen;
+    avl_for_range(&tree, 10, 20, [&](int key, int) { seen.push_back(key); });
+    test::assert_equal(size_t(10), seen.size());
+    for (int i = 0; i < 10; ++i) {
+      test::assert_equal(10 + i, seen[i]);
+    }
+
+    size_t count = 0;
+    avl_for_range(&tree, 50, 50, [&](int, int) { count++; });
+    avl_for_range(&tree, 200, 300, [&](int, int) { count++; });
+    test::assert_equal(size_t(0), count);
+
+    avl_destroy(&tree);
+  });
+
+  suite.add_test("Bulk build", []() {
+    for (size_t n : {0, 1, 2, 3, 7, 8, 100, 1000}) {
+      auto entries = sorted_entries(n);
+      auto tree = avl_build(&entries);
+      avl_check(&tree);
+      test::assert_equal(n, avl_size(&tree));
+      int min_height = 0;
+      while ((size_t(1) << min_height) <= n) {
+        min_height++;
+      }
+      test::assert_equal(min_height, avl_height(&tree));
+      for (size_t i = 0; i < n; ++i) {
+        test::assert_equal(int(10 * i), *avl_find(&tree, int(i)));
+      }
+
+      // a built tree takes ordinary updates afterwards
+      avl_insert(&tree, -1, -1);
+      test::assert_equal(n > 0, avl_erase(&tree, 0));
+      avl_check(&tree);
+      test::assert_equal(n > 0 ? n : 1, avl_size(&tree));
+
+      avl_destroy(&tree);
+      darray_destroy(&entries);
+    }
+  });
+
+  suite.add_test("Bulk build allocates one chunk", []() {
+    auto entries = sorted_entries(5000);
+    test::AllocScope scope;
+    auto tree = avl_build(&entries);
+    if (test::alloc_tracking) {
+      test::assert_equal(size_t(1), scope.stats().count);
+    }
+    test::assert_equal(size_t(1), tree.pool.num_chunks);
+
+    avl_destroy(&tree);
+    darray_destroy(&entries);
+  });
+
+  suite.add_test("String keys", []() {
+    auto tree = avl_create<std::string, std::string>();
+    avl_insert(&tree, std::string("Plato"), std::string("The Republic"));
+    avl_insert(&tree, std::string("Aristotle"), std::string("Politics"));
+    avl_insert(&tree, std::string("Socrates"), std::string(32, '?'));
+    test::assert_equal(std::string("Aristotle"), avl_select(&tree, 0)->key);
+    test::assert_true(avl_erase(&tree, std::string("Plato")));
+    test::assert_equal(std::string("Socrates"), avl_select(&tree, 1)->key);
+
+    avl_destroy(&tree);
+  });
+
+  // error handling tests
+  suite.add_test("Select out of bounds", []() {
+    auto tree = avl_create<int, int>();
+    avl_insert(&tree, 1, 1);
+    bool caught_exception = false;
+
+    try {
+      avl_select(&tree, 1);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    avl_destroy(&tree);
+  });
+
+  suite.add_test("Bulk build from unsorted entries", []() {
+    auto entries = sorted_entries(10);
+    entries.data[5].key = entries.data[4].key; // duplicate
+    bool caught_exception = false;
+
+    try {
+      avl_build(&entries);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    darray_destroy(&entries);
+  });
+
+  suite.add_test("Bulk build with a throwing copy", []() {
+    auto entries = darray_create<AvlEntry<int, Fragile>>(100);
+    for (int i = 0; i < 100; ++i) {
+      darray_push_back(&entries, AvlEntry<int, Fragile>{i, Fragile(i)});
+    }
+    long before = Fragile::live;
+    bool caught_exception = false;
+
+    // fail after the root, its whole left subtree and some of the right
+    Fragile::copies_left = 70;
+    try {
+      avl_build(&entries);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    Fragile::copies_left = -1;
+    test::assert_true(caught_exception, "Expected exception not thrown");
+    test::assert_equal(before, Fragile::live);
+
+    darray_destroy(&entries);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: loading a sorted index, lookups, and percentiles
+  test::Benchmark bench("AVL Tree Benchmarks");
+  const size_t n = 1000000;
+  const size_t lookups = 100000;
+
+  auto entries = sorted_entries(n);
+  test::RandomGenerator gen;
+  auto keys = gen.generate_ints(lookups, 0, int(n) - 1);
+
+  bench.add_test(
+      "std::map sorted inserts (1000000 keys)",
+      [&]() {
+        std::map<int, int> map;
+        for (size_t i = 0; i < n; ++i) {
+          map.emplace(entries.data[i].key, entries.data[i].value);
+        }
+        test::do_not_optimize(map.size());
+      },
+      n);
+
+  bench.add_test(
+      "AVL sorted inserts (1000000 keys)",
+      [&]() {
+        auto tree = avl_create<int, int>();
+        for (size_t i = 0; i < n; ++i) {
+          avl_insert(&tree, entries.data[i].key, entries.data[i].value);
+        }
+        test::do_not_optimize(avl_size(&tree));
+        avl_destroy(&tree);
+      },
+      n);
+
+  bench.add_test(
+      "AVL bulk build (1000000 keys)",
+      [&]() {
+        auto tree = avl_build(&entries);
+        test::do_not_optimize(avl_size(&tree));
+        avl_destroy(&tree);
+      },
+      n);
+
+  std::map<int, int> map;
+  for (size_t i = 0; i < n; ++i) {
+    map.emplace_hint(map.end(), entries.data[i].key, entries.data[i].value);
+  }
+  auto inserted = avl_create<int, int>();
+  for (size_t i = 0; i < n; ++i) {
+    avl_insert(&inserted, entries.data[i].key, entries.data[i].value);
+  }
+  auto built = avl_build(&entries);
+
+  bench.add_test(
+      "std::map lookup",
+      [&]() {
+        long sum = 0;
+        for (int key : keys) {
+          sum += map.find(key)->second;
+        }
+        test::do_not_optimize(sum);
+      },
+      lookups);
+
+  bench.add_test(
+      "AVL lookup, built by inserts",
+      [&]() {
+        long sum = 0;
+        for (int key : keys) {
+          sum += *avl_find(&inserted, key);
+        }
+        test::do_not_optimize(sum);
+      },
+      lookups);
+
+  bench.add_test(
+      "AVL lookup, bulk built",
+      [&]() {
+        long sum = 0;
+        for (int key : keys) {
+          sum += *avl_find(&built, key);
+        }
+        test::do_not_optimize(sum);
+      },
+      lookups);
+
+  // the 0th, 10th, ..., 90th percentile keys: std::map has to walk to each
+  bench.add_test(
+      "std::map percentile by iteration",
+      [&]() {
+        long sum = 0;
+        for (size_t p = 0; p < 100; p += 10) {
+          auto it = map.begin();
+          std::advance(it, map.size() * p / 100);
+          sum += it->first;
+        }
+        test::do_not_optimize(sum);
+      },
+      10);
+
+  bench.add_test(
+      "AVL percentile by select",
+      [&]() {
+        long sum = 0;
+        for (size_t p = 0; p < 100; p += 10) {
+          sum += avl_select(&built, avl_size(&built) * p / 100)->key;
+        }
+        test::do_not_optimize(sum);
+      },
+      10);
+
+  // run all benchmarks
+  bench.run();
+
+  avl_destroy(&inserted);
+  avl_destroy(&built);
+  darray_destroy(&entries);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "AVL tree program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,365 @@
+/**
+ * avl.hpp
+ *
+ * An AVL tree map whose nodes come from a NodePool. Every node also stores
+ * the size of its subtree, so the rank of a key and the key of a given
+ * rank (order statistics) take O(log n). A tree can be built in O(n) from
+ * an already sorted array, into a single pool chunk.
+ */
+
+#pragma once
+
+#include "../00_dynamic_array/darray.hpp"
+#include "../01_linked_list/node_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename K, typename V> struct AvlNode {
+  AvlNode* left;
+  AvlNode* right;
+  size_t size; // nodes in this subtree
+  int height;  // levels in this subtree, 1 for a leaf
+  K key;
+  V value;
+};
+
+// input to avl_build
+template <typename K, typename V> struct AvlEntry {
+  K key;
+  V value;
+};
+
+template <typename K, typename V> struct AvlTree {
+  AvlNode<K, V>* root;
+  NodePool<AvlNode<K, V>> pool;
+};
+
+// initialize empty tree; no memory is allocated until the first insert
+template <typename K, typename V>
+AvlTree<K, V> avl_create(size_t chunk_nodes = POOL_CHUNK_NODES) {
+  return AvlTree<K, V>{nullptr, node_pool_create<AvlNode<K, V>>(chunk_nodes)};
+}
+
+// destroy every node below node, returning none of them to the pool
+template <typename K, typename V> void avl_destroy_nodes(AvlNode<K, V>* node) {
+  if (node) {
+    avl_destroy_nodes(node->left);
+    avl_destroy_nodes(node->right);
+    std::destroy_at(node);
+  }
+}
+
+// destroy every entry and release the pool
+template <typename K, typename V> void avl_destroy(AvlTree<K, V>* tree) {
+  if constexpr (!std::is_trivially_destructible_v<AvlNode<K, V>>) {
+    avl_destroy_nodes(tree->root);
+  }
+  node_pool_destroy(&tree->pool);
+  tree->root = nullptr;
+}
+
+template <typename K, typename V> size_t avl_size(const AvlNode<K, V>* node) {
+  return node ? node->size : 0;
+}
+
+template <typename K, typename V> int avl_height(const AvlNode<K, V>* node) {
+  return node ? node->height : 0;
+}
+
+// number of entries
+template <typename K, typename V> size_t avl_size(const AvlTree<K, V>* tree) {
+  return avl_size(tree->root);
+}
+
+// levels in the tree, 0 when empty
+template <typename K, typename V> int avl_height(const AvlTree<K, V>* tree) {
+  return avl_height(tree->root);
+}
+
+// recompute size and height of node from its children
+template <typename K, typename V> void avl_update(AvlNode<K, V>* node) {
+  node->size = 1 + avl_size(node->left) + avl_size(node->right);
+  node->height = 1 + std::max(avl_height(node->left), avl_height(node->right));
+}
+
+template <typename K, typename V>
+AvlNode<K, V>* avl_rotate_right(AvlNode<K, V>* node) {
+  AvlNode<K, V>* left = node->left;
+  node->left = left->right;
+  left->right = node;
+  avl_update(node);
+  avl_update(left);
+  return left;
+}
+
+template <typename K, typename V>
+AvlNode<K, V>* avl_rotate_left(AvlNode<K, V>* node) {
+  AvlNode<K, V>* right = node->right;
+  node->right = right->left;
+  right->left = node;
+  avl_update(node);
+  avl_update(right);
+  return right;
+}
+
+// restore the balance of node after one of its subtrees changed height by
+// one; returns the new root of the subtree
+template <typename K, typename V>
+AvlNode<K, V>* avl_rebalance(AvlNode<K, V>* node) {
+  avl_update(node);
+  int balance = avl_height(node->left) - avl_height(node->right);
+  if (balance > 1) {
+    if (avl_height(node->left->left) < avl_height(node->left->right)) {
+      node->left = avl_rotate_left(node->left);
+    }
+    return avl_rotate_right(node);
+  }
+  if (balance < -1) {
+    if (avl_height(node->right->right) < avl_height(node->right->left)) {
+      node->right = avl_rotate_right(node->right);
+    }
+    return avl_rotate_left(node);
+  }
+  return node;
+}
+
+// node holding key, or nullptr
+template <typename K, typename V>
+AvlNode<K, V>* avl_find_node(const AvlTree<K, V>* tree, const K& key) {
+  AvlNode<K, V>* node = tree->root;
+  while (node) {
+    if (key < node->key) {
+      node = node->left;
+    } else if (node->key < key) {
+      node = node->right;
+    } else {
+      return node;
+    }
+  }
+  return nullptr;
+}
+
+// pointer to the value of key, or nullptr if absent
+template <typename K, typename V>
+V* avl_find(AvlTree<K, V>* tree, const K& key) {
+  AvlNode<K, V>* node = avl_find_node(tree, key);
+  return node ? &node->value : nullptr;
+}
+
+template <typename K, typename V>
+bool avl_contains(const AvlTree<K, V>* tree, const K& key) {
+  return avl_find_node(tree, key) != nullptr;
+}
+
+// insert below node; returns the new subtree root
+template <typename K, typename V>
+AvlNode<K, V>* avl_insert_at(AvlTree<K, V>* tree, AvlNode<K, V>* node, K& key,
+                             V& value, bool* inserted) {
+  if (!node) {
+    *inserted = true;
+    void* mem = node_pool_alloc(&tree->pool);
+    return new (mem)
+        AvlNode<K, V>{nullptr, nullptr, 1, 1, std::move(key), std::move(value)};
+  }
+  if (key < node->key) {
+    node->left = avl_insert_at(tree, node->left, key, value, inserted);
+  } else if (node->key < key) {
+    node->right = avl_insert_at(tree, node->right, key, value, inserted);
+  } else {
+    node->value = std::move(value);
+    return node;
+  }
+  return avl_rebalance(node);
+}
+
+// insert key, or assign value if already present; true if newly inserted
+template <typename K, typename V>
+bool avl_insert(AvlTree<K, V>* tree, K key, V value) {
+  bool inserted = false;
+  tree->root = avl_insert_at(tree, tree->root, key, value, &inserted);
+  return inserted;
+}
+
+// unlink the leftmost node below node into *min; returns the new root
+template <typename K, typename V>
+AvlNode<K, V>* avl_detach_min(AvlNode<K, V>* node, AvlNode<K, V>** min) {
+  if (!node->left) {
+    *min = node;
+    return node->right;
+  }
+  node->left = avl_detach_min(node->left, min);
+  return avl_rebalance(node);
+}
+
+// erase below node; returns the new subtree root
+template <typename K, typename V>
+AvlNode<K, V>* avl_erase_at(AvlTree<K, V>* tree, AvlNode<K, V>* node,
+                            const K& key, bool* erased) {
+  if (!node) {
+    return nullptr;
+  }
+  if (key < node->key) {
+    node->left = avl_erase_at(tree, node->left, key, erased);
+  } else if (node->key < key) {
+    node->right = avl_erase_at(tree, node->right, key, erased);
+  } else {
+    *erased = true;
+    AvlNode<K, V>* left = node->left;
+    AvlNode<K, V>* right = node->right;
+    std::destroy_at(node);
+    node_pool_free(&tree->pool, node);
+    if (!left || !right) {
+      return left ? left : right;
+    }
+    // the successor takes the erased node's place; entries never move
+    AvlNode<K, V>* successor = nullptr;
+    right = avl_detach_min(right, &successor);
+    successor->left = left;
+    successor->right = right;
+    return avl_rebalance(successor);
+  }
+  return avl_rebalance(node);
+}
+
+// remove key, returning whether it was present
+template <typename K, typename V>
+bool avl_erase(AvlTree<K, V>* tree, const K& key) {
+  bool erased = false;
+  tree->root = avl_erase_at(tree, tree->root, key, &erased);
+  return erased;
+}
+
+// number of keys less than key
+template <typename K, typename V>
+size_t avl_rank(const AvlTree<K, V>* tree, const K& key) {
+  size_t rank = 0;
+  const AvlNode<K, V>* node = tree->root;
+  while (node) {
+    if (key < node->key) {
+      node = node->left;
+    } else if (node->key < key) {
+      rank += avl_size(node->left) + 1;
+      node = node->right;
+    } else {
+      return rank + avl_size(node->left);
+    }
+  }
+  return rank;
+}
+
+// node holding the idx-th smallest key
+template <typename K, typename V>
+AvlNode<K, V>* avl_select(const AvlTree<K, V>* tree, size_t idx) {
+  if (idx >= avl_size(tree)) {
+    throw std::runtime_error("Index out of bounds");
+  }
+  AvlNode<K, V>* node = tree->root;
+  for (;;) {
+    size_t left = avl_size(node->left);
+    if (idx < left) {
+      node = node->left;
+    } else if (idx > left) {
+      idx -= left + 1;
+      node = node->right;
+    } else {
+      return node;
+    }
+  }
+}
+
+// call f(key, value) on every entry below node with lo <= key < hi, in
+// order, skipping subtrees that lie wholly outside the range
+template <typename K, typename V, typename F>
+void avl_for_range_at(AvlNode<K, V>* node, const K& lo, const K& hi, F& f) {
+  while (node) {
+    if (node->key < lo) {
+      node = node->right;
+    } else if (!(node->key < hi)) {
+      node = node->left;
+    } else {
+      avl_for_range_at(node->left, lo, hi, f);
+      f(node->key, node->value);
+      node = node->right;
+    }
+  }
+}
+
+// call f(key, value) on every entry with lo <= key < hi, in key order
+template <typename K, typename V, typename F>
+void avl_for_range(AvlTree<K, V>* tree, const K& lo, const K& hi, F f) {
+  avl_for_range_at(tree->root, lo, hi, f);
+}
+
+template <typename K, typename V, typename F>
+void avl_for_each_at(AvlNode<K, V>* node, F& f) {
+  while (node) {
+    avl_for_each_at(node->left, f);
+    f(node->key, node->value);
+    node = node->right;
+  }
+}
+
+// call f(key, value) on every entry, in key order
+template <typename K, typename V, typename F>
+void avl_for_each(AvlTree<K, V>* tree, F f) {
+  avl_for_each_at(tree->root, f);
+}
+
+// perfectly balanced subtree of entries [lo, hi); parents are allocated
+// before their children, so a search walks forward through the chunk. If a
+// key or value copy throws, the nodes built so far are destroyed before
+// the exception leaves, since none is reachable from the root yet
+template <typename K, typename V>
+AvlNode<K, V>* avl_build_at(AvlTree<K, V>* tree,
+                            const AvlEntry<K, V>* entries, size_t lo,
+                            size_t hi) {
+  if (lo == hi) {
+    return nullptr;
+  }
+  size_t mid = lo + (hi - lo) / 2;
+  void* mem = node_pool_alloc(&tree->pool);
+  AvlNode<K, V>* node;
+  try {
+    node = new (mem) AvlNode<K, V>{
+        nullptr, nullptr, hi - lo, 1, entries[mid].key, entries[mid].value};
+  } catch (...) {
+    node_pool_free(&tree->pool, mem);
+    throw;
+  }
+  try {
+    node->left = avl_build_at(tree, entries, lo, mid);
+    node->right = avl_build_at(tree, entries, mid + 1, hi);
+  } catch (...) {
+    avl_destroy_nodes(node);
+    throw;
+  }
+  node->height = 1 + std::max(avl_height(node->left), avl_height(node->right));
+  return node;
+}
+
+// build a tree in O(n) from entries sorted by strictly increasing key,
+// with every node in one pool chunk; entries itself is left untouched
+template <typename K, typename V>
+AvlTree<K, V> avl_build(const DArray<AvlEntry<K, V>>* entries) {
+  for (size_t i = 1; i < entries->sz; ++i) {
+    if (!(entries->data[i - 1].key < entries->data[i].key)) {
+      throw std::runtime_error("Keys are not sorted and unique");
+    }
+  }
+  AvlTree<K, V> tree =
+      avl_create<K, V>(std::max(entries->sz, size_t(POOL_CHUNK_NODES)));
+  try {
+    tree.root = avl_build_at(&tree, entries->data, 0, entries->sz);
+  } catch (...) {
+    avl_destroy(&tree);
+    throw;
+  }
+  // later inserts grow the pool in ordinary chunks again
+  tree.pool.chunk_nodes = POOL_CHUNK_NODES;
+  return tree;
+}
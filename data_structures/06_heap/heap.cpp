@@ -0,0 +1,179 @@
+/**
+ * heap.cpp
+ *
+ * D-ary heap tests and benchmarks against std::priority_queue.
+ */
+
+#include "heap.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+// push every value then pop them all; returns the popped sequence
+template <size_t D, typename Less = std::less<int>>
+std::vector<int> heap_drain(const std::vector<int>& values) {
+  auto heap = heap_create<int, D, Less>();
+  for (int v : values) {
+    heap_push(&heap, v);
+  }
+  std::vector<int> out;
+  while (!heap_empty(&heap)) {
+    out.push_back(heap_pop(&heap));
+  }
+  heap_destroy(&heap);
+  return out;
+}
+
+// push every value then pop them all, summing as the benchmarks do
+template <size_t D> long heap_drain_sum(const std::vector<int>& values) {
+  auto heap = heap_create<int, D>();
+  for (int v : values) {
+    heap_push(&heap, v);
+  }
+  long sum = 0;
+  while (!heap_empty(&heap)) {
+    sum += heap_pop(&heap);
+  }
+  heap_destroy(&heap);
+  return sum;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("D-ary Heap Tests");
+
+  suite.add_test("Push, top and pop", []() {
+    auto heap = heap_create<int>();
+    heap_push(&heap, 5);
+    heap_push(&heap, 1);
+    heap_push(&heap, 3);
+    test::assert_equal(size_t(3), heap_size(&heap));
+    test::assert_equal(1, heap_top(&heap));
+    test::assert_equal(1, heap_pop(&heap));
+    test::assert_equal(3, heap_pop(&heap));
+    test::assert_equal(5, heap_pop(&heap));
+    test::assert_true(heap_empty(&heap));
+
+    heap_destroy(&heap);
+  });
+
+  suite.add_test("Pops in sorted order for every arity", []() {
+    test::RandomGenerator gen;
+    auto values = gen.generate_ints(5000, -1000, 1000); // with duplicates
+    auto sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    test::assert_true(heap_drain<2>(values) == sorted, "Binary heap");
+    test::assert_true(heap_drain<3>(values) == sorted, "3-ary heap");
+    test::assert_true(heap_drain<4>(values) == sorted, "4-ary heap");
+    test::assert_true(heap_drain<8>(values) == sorted, "8-ary heap");
+  });
+
+  suite.add_test("Max-heap with std::greater", []() {
+    std::vector<int> values = {4, 8, 1, 9, 2};
+    auto out = heap_drain<4, std::greater<int>>(values);
+    test::assert_true(out == std::vector<int>({9, 8, 4, 2, 1}));
+  });
+
+  suite.add_test("Build from an array", []() {
+    test::RandomGenerator gen;
+    auto values = gen.generate_ints(1000, 0, 100000);
+    auto items = darray_create<int>();
+    darray_append(&items, values.begin(), values.end());
+    auto heap = heap_build(items);
+    heap_push(&heap, -1);
+
+    std::sort(values.begin(), values.end());
+    test::assert_equal(-1, heap_pop(&heap));
+    for (int v : values) {
+      test::assert_equal(v, heap_pop(&heap));
+    }
+
+    heap_destroy(&heap);
+  });
+
+  suite.add_test("String elements", []() {
+    auto heap = heap_create<std::string, 4>();
+    for (const char* s : {"Plato", "Aristotle", "Socrates", "Epicurus"}) {
+      heap_push(&heap, std::string(s) + std::string(24, '.'));
+    }
+    test::assert_equal(std::string("Aristotle") + std::string(24, '.'),
+                       heap_pop(&heap));
+    test::assert_equal(std::string("Epicurus") + std::string(24, '.'),
+                       heap_top(&heap));
+
+    heap_destroy(&heap);
+  });
+
+  // error handling tests
+  suite.add_test("Pop from empty heap", []() {
+    auto heap = heap_create<int>();
+    bool caught_exception = false;
+
+    try {
+      heap_pop(&heap);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    heap_destroy(&heap);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: fill a heap with random keys then drain it, at a size
+  // that fits in L2 and one well beyond the LLC
+  test::Benchmark bench("D-ary Heap Benchmarks");
+  test::RandomGenerator gen;
+
+  for (size_t n : {10000, 4000000}) {
+    auto values = gen.generate_ints(n, 0, 1 << 30);
+    std::string suffix = " (" + std::to_string(n) + " keys)";
+
+    bench.add_test(
+        "std::priority_queue push + pop" + suffix,
+        [values]() {
+          std::priority_queue<int, std::vector<int>, std::greater<int>> pq;
+          for (int v : values) {
+            pq.push(v);
+          }
+          long sum = 0;
+          while (!pq.empty()) {
+            sum += pq.top();
+            pq.pop();
+          }
+          test::do_not_optimize(sum);
+        },
+        2 * n);
+
+    bench.add_test(
+        "Binary heap push + pop" + suffix,
+        [values]() { test::do_not_optimize(heap_drain_sum<2>(values)); },
+        2 * n);
+
+    bench.add_test(
+        "4-ary heap push + pop" + suffix,
+        [values]() { test::do_not_optimize(heap_drain_sum<4>(values)); },
+        2 * n);
+
+    bench.add_test(
+        "8-ary heap push + pop" + suffix,
+        [values]() { test::do_not_optimize(heap_drain_sum<8>(values)); },
+        2 * n);
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "D-ary heap program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * heap.hpp
+ *
+ * A d-ary heap stored in a DArray. Node i has children D * i + 1 through
+ * D * i + D, so a 4-ary heap is half as deep as a binary one and the
+ * children compared at each level sit next to each other in memory. The
+ * top is the element that Less orders first: a min-heap by default, a
+ * max-heap with std::greater.
+ */
+
+#pragma once
+
+#include "../00_dynamic_array/darray.hpp"
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#define HEAP_ARITY 4 // default children per node
+
+template <typename T, size_t D = HEAP_ARITY, typename Less = std::less<T>>
+struct DaryHeap {
+  static_assert(D >= 2, "A heap needs at least two children per node");
+
+  DArray<T> items; // heap order, items.data[0] on top
+  Less less;
+};
+
+// initialize empty heap with room for cap elements
+template <typename T, size_t D = HEAP_ARITY, typename Less = std::less<T>>
+DaryHeap<T, D, Less> heap_create(size_t cap = INIT_CAP, Less less = Less()) {
+  return DaryHeap<T, D, Less>{darray_create<T>(cap), std::move(less)};
+}
+
+// free memory
+template <typename T, size_t D, typename Less>
+void heap_destroy(DaryHeap<T, D, Less>* heap) {
+  darray_destroy(&heap->items);
+}
+
+template <typename T, size_t D, typename Less>
+size_t heap_size(const DaryHeap<T, D, Less>* heap) {
+  return heap->items.sz;
+}
+
+template <typename T, size_t D, typename Less>
+bool heap_empty(const DaryHeap<T, D, Less>* heap) {
+  return heap->items.sz == 0;
+}
+
+// move x up from the hole at i until its parent does not order after it
+template <typename T, size_t D, typename Less>
+void heap_sift_up(DaryHeap<T, D, Less>* heap, size_t i, T x) {
+  T* data = heap->items.data;
+  while (i > 0) {
+    size_t parent = (i - 1) / D;
+    if (!heap->less(x, data[parent])) {
+      break;
+    }
+    data[i] = std::move(data[parent]);
+    i = parent;
+  }
+  data[i] = std::move(x);
+}
+
+// move x down from the hole at i until no child orders before it
+template <typename T, size_t D, typename Less>
+void heap_sift_down(DaryHeap<T, D, Less>* heap, size_t i, T x) {
+  T* data = heap->items.data;
+  size_t n = heap->items.sz;
+  for (;;) {
+    size_t first = D * i + 1;
+    if (first >= n) {
+      break;
+    }
+    size_t last = first + D < n ? first + D : n;
+    size_t best = first;
+    for (size_t c = first + 1; c < last; ++c) {
+      if (heap->less(data[c], data[best])) {
+        best = c;
+      }
+    }
+    if (!heap->less(data[best], x)) {
+      break;
+    }
+    data[i] = std::move(data[best]);
+    i = best;
+  }
+  data[i] = std::move(x);
+}
+
+// take ownership of items and arrange them into a heap in O(n)
+template <typename T, size_t D = HEAP_ARITY, typename Less = std::less<T>>
+DaryHeap<T, D, Less> heap_build(DArray<T> items, Less less = Less()) {
+  DaryHeap<T, D, Less> heap{items, std::move(less)};
+  size_t n = items.sz;
+  if (n > 1) {
+    for (size_t i = (n - 2) / D + 1; i-- > 0;) {
+      heap_sift_down(&heap, i, std::move(heap.items.data[i]));
+    }
+  }
+  return heap;
+}
+
+// add x to the heap
+template <typename T, size_t D, typename Less>
+void heap_push(DaryHeap<T, D, Less>* heap, T x) {
+  darray_push_back(&heap->items, std::move(x));
+  size_t last = heap->items.sz - 1;
+  heap_sift_up(heap, last, std::move(heap->items.data[last]));
+}
+
+// element on top of the heap
+template <typename T, size_t D, typename Less>
+const T& heap_top(const DaryHeap<T, D, Less>* heap) {
+  if (heap->items.sz == 0) {
+    throw std::runtime_error("Heap is empty");
+  }
+  return heap->items.data[0];
+}
+
+// remove and return the element on top of the heap
+template <typename T, size_t D, typename Less>
+T heap_pop(DaryHeap<T, D, Less>* heap) {
+  if (heap->items.sz == 0) {
+    throw std::runtime_error("Heap is empty");
+  }
+  T top = std::move(heap->items.data[0]);
+  T last = darray_pop_back(&heap->items);
+  if (heap->items.sz > 0) {
+    heap_sift_down(heap, 0, std::move(last));
+  }
+  return top;
+}
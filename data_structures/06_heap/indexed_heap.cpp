@@ -0,0 +1,271 @@
+/**
+ * indexed_heap.cpp
+ *
+ * Indexed d-ary heap tests and decrease-key benchmarks against
+ * std::priority_queue with lazy deletion.
+ */
+
+#include "indexed_heap.hpp"
+#include "testing.hpp"
+#include <iostream>
+#include <queue>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// a Dijkstra-style workload: every id starts with a random key; each round
+// pops the top and lowers the keys of a few random ids still waiting
+struct DecreaseWork {
+  std::vector<int> keys;  // starting key of each id
+  std::vector<int> picks; // ids to lower, `per_pop` per round
+  std::vector<int> drops; // how far to lower each pick
+  size_t per_pop;
+};
+
+// run the workload on an indexed heap; returns the sum of popped keys
+template <size_t D> long run_indexed(const DecreaseWork& work) {
+  size_t n = work.keys.size();
+  auto heap = iheap_create<long, D>(n);
+  for (size_t id = 0; id < n; ++id) {
+    iheap_push(&heap, id, long(work.keys[id]));
+  }
+  long sum = 0;
+  for (size_t round = 0; !iheap_empty(&heap); ++round) {
+    sum += iheap_pop(&heap).key;
+    for (size_t j = 0; j < work.per_pop && round < n; ++j) {
+      size_t k = round * work.per_pop + j;
+      size_t id = work.picks[k];
+      if (iheap_contains(&heap, id)) {
+        long key = iheap_key(&heap, id) - work.drops[k];
+        iheap_decrease_key(&heap, id, key);
+      }
+    }
+  }
+  iheap_destroy(&heap);
+  return sum;
+}
+
+// the same workload on std::priority_queue: a decrease pushes a second
+// entry and pops skip entries whose key is out of date
+long run_lazy(const DecreaseWork& work) {
+  size_t n = work.keys.size();
+  std::vector<long> current(work.keys.begin(), work.keys.end());
+  std::vector<bool> done(n, false);
+  using Item = std::pair<long, size_t>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<Item>> pq;
+  for (size_t id = 0; id < n; ++id) {
+    pq.emplace(current[id], id);
+  }
+  long sum = 0;
+  for (size_t round = 0; !pq.empty();) {
+    auto [key, id] = pq.top();
+    pq.pop();
+    if (done[id] || key != current[id]) {
+      continue;
+    }
+    done[id] = true;
+    sum += key;
+    for (size_t j = 0; j < work.per_pop && round < n; ++j) {
+      size_t k = round * work.per_pop + j;
+      size_t other = work.picks[k];
+      if (!done[other]) {
+        current[other] -= work.drops[k];
+        pq.emplace(current[other], other);
+      }
+    }
+    round++;
+  }
+  return sum;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Indexed Heap Tests");
+
+  suite.add_test("Push and pop by id", []() {
+    auto heap = iheap_create<int>();
+    iheap_push(&heap, 7, 30);
+    iheap_push(&heap, 2, 10);
+    iheap_push(&heap, 5, 20);
+    test::assert_equal(size_t(3), iheap_size(&heap));
+    test::assert_true(iheap_contains(&heap, 5));
+    test::assert_false(iheap_contains(&heap, 6));
+    test::assert_equal(20, iheap_key(&heap, 5));
+
+    test::assert_equal(size_t(2), iheap_pop(&heap).id);
+    test::assert_false(iheap_contains(&heap, 2));
+    test::assert_equal(size_t(5), iheap_top(&heap).id);
+
+    iheap_destroy(&heap);
+  });
+
+  suite.add_test("Decrease and increase key", []() {
+    auto heap = iheap_create<int>();
+    for (size_t id = 0; id < 100; ++id) {
+      iheap_push(&heap, id, int(100 + id));
+    }
+    iheap_decrease_key(&heap, 60, 5);
+    test::assert_equal(size_t(60), iheap_top(&heap).id);
+    iheap_increase_key(&heap, 60, 1000);
+    test::assert_equal(size_t(0), iheap_top(&heap).id);
+    iheap_update(&heap, 99, 1);  // decrease
+    iheap_update(&heap, 0, 500); // increase
+    iheap_update(&heap, 200, 2); // push
+
+    test::assert_equal(size_t(99), iheap_pop(&heap).id);
+    test::assert_equal(size_t(200), iheap_pop(&heap).id);
+    test::assert_equal(size_t(1), iheap_pop(&heap).id);
+
+    iheap_destroy(&heap);
+  });
+
+  suite.add_test("Matches reference under random load", []() {
+    auto heap = iheap_create<int, 3>(); // odd arity on purpose
+    std::set<std::pair<int, size_t>> ref;
+    std::vector<int> key_of(500, 0);
+    test::RandomGenerator gen;
+    auto ids = gen.generate_ints(20000, 0, 499);
+    auto keys = gen.generate_ints(20000, -1000, 1000);
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+      size_t id = ids[i];
+      int key = keys[i];
+      bool present = ref.count({key_of[id], id}) == 1;
+      test::assert_equal(present, iheap_contains(&heap, id));
+      if (i % 5 == 4 && !ref.empty()) {
+        auto top = iheap_pop(&heap);
+        test::assert_equal(ref.begin()->first, top.key);
+        ref.erase({top.key, top.id});
+      } else if (present && i % 5 == 3) {
+        test::assert_true(iheap_erase(&heap, id));
+        ref.erase({key_of[id], id});
+      } else {
+        ref.erase({key_of[id], id});
+        iheap_update(&heap, id, key);
+        ref.insert({key, id});
+        key_of[id] = key;
+      }
+    }
+    test::assert_equal(ref.size(), iheap_size(&heap));
+    while (!ref.empty()) {
+      test::assert_equal(ref.begin()->first, iheap_pop(&heap).key);
+      ref.erase(ref.begin());
+    }
+
+    iheap_destroy(&heap);
+  });
+
+  suite.add_test("Erase the last entry and absent ids", []() {
+    auto heap = iheap_create<int>();
+    iheap_push(&heap, 0, 1);
+    iheap_push(&heap, 1, 2);
+    test::assert_true(iheap_erase(&heap, 1));
+    test::assert_false(iheap_erase(&heap, 1));
+    test::assert_false(iheap_erase(&heap, 1000));
+    test::assert_equal(size_t(0), iheap_pop(&heap).id);
+    test::assert_true(iheap_empty(&heap));
+
+    iheap_destroy(&heap);
+  });
+
+  suite.add_test("Agrees with lazy deletion on the benchmark workload", []() {
+    test::RandomGenerator gen;
+    DecreaseWork work;
+    work.keys = gen.generate_ints(2000, 0, 1 << 20);
+    work.picks = gen.generate_ints(2000 * 3, 0, 1999);
+    work.drops = gen.generate_ints(2000 * 3, 0, 1 << 10);
+    work.per_pop = 3;
+    test::assert_equal(run_lazy(work), run_indexed<2>(work));
+    test::assert_equal(run_lazy(work), run_indexed<4>(work));
+  });
+
+  // error handling tests
+  suite.add_test("Decrease key to a larger key", []() {
+    auto heap = iheap_create<int>();
+    iheap_push(&heap, 0, 10);
+    bool caught_exception = false;
+
+    try {
+      iheap_decrease_key(&heap, 0, 11);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+    test::assert_equal(10, iheap_key(&heap, 0));
+
+    iheap_destroy(&heap);
+  });
+
+  suite.add_test("Push an id twice", []() {
+    auto heap = iheap_create<int>();
+    iheap_push(&heap, 3, 10);
+    bool caught_exception = false;
+
+    try {
+      iheap_push(&heap, 3, 5);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    iheap_destroy(&heap);
+  });
+
+  suite.add_test("Pop from empty heap", []() {
+    auto heap = iheap_create<int>();
+    bool caught_exception = false;
+
+    try {
+      iheap_pop(&heap);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    iheap_destroy(&heap);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: the decrease-key workload at two sizes and two mixes;
+  // every run pops all n ids, so ops counts pops plus attempted decreases
+  test::Benchmark bench("Indexed Heap Benchmarks");
+  test::RandomGenerator gen;
+
+  for (size_t n : {10000, 1000000}) {
+    for (size_t per_pop : {1, 4}) {
+      DecreaseWork work;
+      work.keys = gen.generate_ints(n, 0, 1 << 30);
+      work.picks = gen.generate_ints(n * per_pop, 0, int(n) - 1);
+      work.drops = gen.generate_ints(n * per_pop, 0, 1 << 20);
+      work.per_pop = per_pop;
+      std::string suffix = " (" + std::to_string(n) + " ids, " +
+                           std::to_string(per_pop) + " decreases per pop)";
+      size_t ops = n * (1 + per_pop);
+
+      bench.add_test(
+          "std::priority_queue lazy" + suffix,
+          [work]() { test::do_not_optimize(run_lazy(work)); }, ops);
+
+      bench.add_test(
+          "Indexed binary heap" + suffix,
+          [work]() { test::do_not_optimize(run_indexed<2>(work)); }, ops);
+
+      bench.add_test(
+          "Indexed 4-ary heap" + suffix,
+          [work]() { test::do_not_optimize(run_indexed<4>(work)); }, ops);
+    }
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Indexed heap program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
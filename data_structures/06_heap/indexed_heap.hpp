@@ -0,0 +1,220 @@
+/**
+ * indexed_heap.hpp
+ *
+ * A d-ary heap of (key, id) entries that also tracks where each id sits,
+ * so the key of any id can be decreased, increased or removed in
+ * O(log n). Ids are small integers chosen by the caller, such as vertex
+ * numbers or timer slots; the position table grows to the largest id
+ * seen. Entries carry their key, so sifting never leaves the heap array.
+ */
+
+#pragma once
+
+#include "heap.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+#define IHEAP_NONE SIZE_MAX // position of an id that is not in the heap
+
+template <typename K> struct IHeapEntry {
+  K key;
+  size_t id;
+};
+
+template <typename K, size_t D = HEAP_ARITY, typename Less = std::less<K>>
+struct IndexedHeap {
+  static_assert(D >= 2, "A heap needs at least two children per node");
+
+  DArray<IHeapEntry<K>> entries; // heap order, entries.data[0] on top
+  DArray<size_t> pos;            // id -> index in entries, or IHEAP_NONE
+  Less less;
+};
+
+// initialize empty heap expecting ids below ids
+template <typename K, size_t D = HEAP_ARITY, typename Less = std::less<K>>
+IndexedHeap<K, D, Less> iheap_create(size_t ids = INIT_CAP,
+                                     Less less = Less()) {
+  IndexedHeap<K, D, Less> heap{darray_create<IHeapEntry<K>>(ids),
+                               darray_create<size_t>(ids), std::move(less)};
+  return heap;
+}
+
+// free memory
+template <typename K, size_t D, typename Less>
+void iheap_destroy(IndexedHeap<K, D, Less>* heap) {
+  darray_destroy(&heap->entries);
+  darray_destroy(&heap->pos);
+}
+
+template <typename K, size_t D, typename Less>
+size_t iheap_size(const IndexedHeap<K, D, Less>* heap) {
+  return heap->entries.sz;
+}
+
+template <typename K, size_t D, typename Less>
+bool iheap_empty(const IndexedHeap<K, D, Less>* heap) {
+  return heap->entries.sz == 0;
+}
+
+template <typename K, size_t D, typename Less>
+bool iheap_contains(const IndexedHeap<K, D, Less>* heap, size_t id) {
+  return id < heap->pos.sz && heap->pos.data[id] != IHEAP_NONE;
+}
+
+// key of an id in the heap
+template <typename K, size_t D, typename Less>
+const K& iheap_key(const IndexedHeap<K, D, Less>* heap, size_t id) {
+  if (!iheap_contains(heap, id)) {
+    throw std::runtime_error("Id not in heap");
+  }
+  return heap->entries.data[heap->pos.data[id]].key;
+}
+
+// store e at index i and record where its id went
+template <typename K, size_t D, typename Less>
+void iheap_place(IndexedHeap<K, D, Less>* heap, size_t i, IHeapEntry<K>&& e) {
+  heap->pos.data[e.id] = i;
+  heap->entries.data[i] = std::move(e);
+}
+
+// move e up from the hole at i until its parent does not order after it
+template <typename K, size_t D, typename Less>
+void iheap_sift_up(IndexedHeap<K, D, Less>* heap, size_t i, IHeapEntry<K> e) {
+  IHeapEntry<K>* data = heap->entries.data;
+  while (i > 0) {
+    size_t parent = (i - 1) / D;
+    if (!heap->less(e.key, data[parent].key)) {
+      break;
+    }
+    iheap_place(heap, i, std::move(data[parent]));
+    i = parent;
+  }
+  iheap_place(heap, i, std::move(e));
+}
+
+// move e down from the hole at i until no child orders before it
+template <typename K, size_t D, typename Less>
+void iheap_sift_down(IndexedHeap<K, D, Less>* heap, size_t i,
+                     IHeapEntry<K> e) {
+  IHeapEntry<K>* data = heap->entries.data;
+  size_t n = heap->entries.sz;
+  for (;;) {
+    size_t first = D * i + 1;
+    if (first >= n) {
+      break;
+    }
+    size_t last = first + D < n ? first + D : n;
+    size_t best = first;
+    for (size_t c = first + 1; c < last; ++c) {
+      if (heap->less(data[c].key, data[best].key)) {
+        best = c;
+      }
+    }
+    if (!heap->less(data[best].key, e.key)) {
+      break;
+    }
+    iheap_place(heap, i, std::move(data[best]));
+    i = best;
+  }
+  iheap_place(heap, i, std::move(e));
+}
+
+// add id with key; the id must not already be in the heap
+template <typename K, size_t D, typename Less>
+void iheap_push(IndexedHeap<K, D, Less>* heap, size_t id, K key) {
+  if (iheap_contains(heap, id)) {
+    throw std::runtime_error("Id already in heap");
+  }
+  while (heap->pos.sz <= id) {
+    darray_push_back(&heap->pos, size_t(IHEAP_NONE));
+  }
+  darray_push_back(&heap->entries, IHeapEntry<K>{std::move(key), id});
+  size_t last = heap->entries.sz - 1;
+  iheap_sift_up(heap, last, std::move(heap->entries.data[last]));
+}
+
+// entry on top of the heap
+template <typename K, size_t D, typename Less>
+const IHeapEntry<K>& iheap_top(const IndexedHeap<K, D, Less>* heap) {
+  if (heap->entries.sz == 0) {
+    throw std::runtime_error("Heap is empty");
+  }
+  return heap->entries.data[0];
+}
+
+// remove the entry at index i and return it
+template <typename K, size_t D, typename Less>
+IHeapEntry<K> iheap_remove_at(IndexedHeap<K, D, Less>* heap, size_t i) {
+  IHeapEntry<K> removed = std::move(heap->entries.data[i]);
+  heap->pos.data[removed.id] = IHEAP_NONE;
+  IHeapEntry<K> last = darray_pop_back(&heap->entries);
+  if (i < heap->entries.sz) {
+    // the last entry fills the hole and may have to go either way
+    if (i > 0 && heap->less(last.key, heap->entries.data[(i - 1) / D].key)) {
+      iheap_sift_up(heap, i, std::move(last));
+    } else {
+      iheap_sift_down(heap, i, std::move(last));
+    }
+  }
+  return removed;
+}
+
+// remove and return the entry on top of the heap
+template <typename K, size_t D, typename Less>
+IHeapEntry<K> iheap_pop(IndexedHeap<K, D, Less>* heap) {
+  if (heap->entries.sz == 0) {
+    throw std::runtime_error("Heap is empty");
+  }
+  return iheap_remove_at(heap, 0);
+}
+
+// remove id, returning whether it was in the heap
+template <typename K, size_t D, typename Less>
+bool iheap_erase(IndexedHeap<K, D, Less>* heap, size_t id) {
+  if (!iheap_contains(heap, id)) {
+    return false;
+  }
+  iheap_remove_at(heap, heap->pos.data[id]);
+  return true;
+}
+
+// give id a key that orders no later than its current one
+template <typename K, size_t D, typename Less>
+void iheap_decrease_key(IndexedHeap<K, D, Less>* heap, size_t id, K key) {
+  if (!iheap_contains(heap, id)) {
+    throw std::runtime_error("Id not in heap");
+  }
+  size_t i = heap->pos.data[id];
+  if (heap->less(heap->entries.data[i].key, key)) {
+    throw std::runtime_error("New key orders after the current key");
+  }
+  iheap_sift_up(heap, i, IHeapEntry<K>{std::move(key), id});
+}
+
+// give id a key that orders no earlier than its current one
+template <typename K, size_t D, typename Less>
+void iheap_increase_key(IndexedHeap<K, D, Less>* heap, size_t id, K key) {
+  if (!iheap_contains(heap, id)) {
+    throw std::runtime_error("Id not in heap");
+  }
+  size_t i = heap->pos.data[id];
+  if (heap->less(key, heap->entries.data[i].key)) {
+    throw std::runtime_error("New key orders before the current key");
+  }
+  iheap_sift_down(heap, i, IHeapEntry<K>{std::move(key), id});
+}
+
+// push id, or move it to key in whichever direction that is
+template <typename K, size_t D, typename Less>
+void iheap_update(IndexedHeap<K, D, Less>* heap, size_t id, K key) {
+  if (!iheap_contains(heap, id)) {
+    iheap_push(heap, id, std::move(key));
+  } else if (heap->less(key, iheap_key(heap, id))) {
+    iheap_decrease_key(heap, id, std::move(key));
+  } else {
+    iheap_increase_key(heap, id, std::move(key));
+  }
+}
@@ -0,0 +1,312 @@
+/**
+ * csr_graph.cpp
+ *
+ * CSR graph tests, and build and scan benchmarks against an adjacency list
+ * of std::vector.
+ */
+
+#include "csr_graph.hpp"
+#include "graph_gen.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using AdjList = std::vector<std::vector<std::pair<uint32_t, uint32_t>>>;
+
+// (target, weight) lists built one push_back at a time
+AdjList adj_build(size_t n, const DArray<CsrEdge>* edges, bool undirected) {
+  AdjList adj(n);
+  for (size_t i = 0; i < edges->sz; ++i) {
+    const CsrEdge& e = edges->data[i];
+    adj[e.from].emplace_back(e.to, e.weight);
+    if (undirected) {
+      adj[e.to].emplace_back(e.from, e.weight);
+    }
+  }
+  return adj;
+}
+
+// v's (target, weight) pairs in CSR order
+std::vector<std::pair<uint32_t, uint32_t>> csr_edges_of(const CsrGraph* g,
+                                                         uint32_t v) {
+  std::vector<std::pair<uint32_t, uint32_t>> out;
+  for (size_t i = 0; i < csr_degree(g, v); ++i) {
+    uint32_t w = csr_weighted(g) ? csr_weights(g, v)[i] : 0;
+    out.emplace_back(csr_targets(g, v)[i], w);
+  }
+  return out;
+}
+
+// sum of every target, visiting vertices in order
+uint64_t csr_scan(const CsrGraph* g) {
+  uint64_t sum = 0;
+  for (uint32_t v = 0; v < g->n; ++v) {
+    const uint32_t* t = csr_targets(g, v);
+    for (size_t i = 0, d = csr_degree(g, v); i < d; ++i) {
+      sum += t[i];
+    }
+  }
+  return sum;
+}
+
+uint64_t adj_scan(const AdjList& adj) {
+  uint64_t sum = 0;
+  for (const auto& list : adj) {
+    for (const auto& e : list) {
+      sum += e.first;
+    }
+  }
+  return sum;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("CSR Graph Tests");
+
+  suite.add_test("Build a small directed graph", []() {
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{0, 2, 5});
+    darray_push_back(&edges, CsrEdge{3, 1, 7});
+    darray_push_back(&edges, CsrEdge{0, 1, 6});
+    darray_push_back(&edges, CsrEdge{2, 2, 8});
+    auto g = csr_build(4, &edges, true);
+
+    test::assert_equal(size_t(4), csr_num_vertices(&g));
+    test::assert_equal(size_t(4), csr_num_edges(&g));
+    test::assert_true(csr_weighted(&g));
+    test::assert_equal(size_t(2), csr_degree(&g, 0));
+    test::assert_equal(size_t(0), csr_degree(&g, 1));
+    // edges of a vertex keep their edge-list order
+    test::assert_equal(2u, csr_targets(&g, 0)[0]);
+    test::assert_equal(1u, csr_targets(&g, 0)[1]);
+    test::assert_equal(6u, csr_weights(&g, 0)[1]);
+    test::assert_equal(2u, csr_targets(&g, 2)[0]);
+    test::assert_equal(7u, csr_weights(&g, 3)[0]);
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Unweighted build drops weights", []() {
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{0, 1, 5});
+    auto g = csr_build(2, &edges);
+    test::assert_false(csr_weighted(&g));
+    test::assert_equal(size_t(0), g.weights.sz);
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Undirected build stores both directions", []() {
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{0, 1, 1});
+    darray_push_back(&edges, CsrEdge{1, 2, 2});
+    auto g = csr_build_undirected(3, &edges, true);
+
+    test::assert_equal(size_t(4), csr_num_edges(&g));
+    test::assert_equal(size_t(2), csr_degree(&g, 1));
+    test::assert_equal(0u, csr_targets(&g, 1)[0]);
+    test::assert_equal(2u, csr_targets(&g, 1)[1]);
+    test::assert_equal(2u, csr_weights(&g, 2)[0]);
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Matches an adjacency list on random graphs", []() {
+    for (bool undirected : {false, true}) {
+      auto edges = graph_gen_uniform(1000, 20000, 100, 7);
+      auto g = undirected ? csr_build_undirected(1000, &edges, true)
+                          : csr_build(1000, &edges, true);
+      AdjList adj = adj_build(1000, &edges, undirected);
+      for (uint32_t v = 0; v < 1000; ++v) {
+        test::assert_true(adj[v] == csr_edges_of(&g, v), "Edges differ");
+      }
+      csr_destroy(&g);
+      darray_destroy(&edges);
+    }
+  });
+
+  suite.add_test("Transpose reverses every edge", []() {
+    auto edges = graph_gen_rmat(10, 8, 50, 3);
+    auto g = csr_build(1024, &edges, true);
+    auto t = csr_transpose(&g);
+    test::assert_equal(csr_num_edges(&g), csr_num_edges(&t));
+
+    // reverse the edge list by hand; counting sort on a list ordered by
+    // source gives in-edges ordered by source as well
+    AdjList ref(1024);
+    for (uint32_t u = 0; u < 1024; ++u) {
+      for (auto [v, w] : csr_edges_of(&g, u)) {
+        ref[v].emplace_back(u, w);
+      }
+    }
+    for (uint32_t v = 0; v < 1024; ++v) {
+      test::assert_true(ref[v] == csr_edges_of(&t, v), "Edges differ");
+    }
+
+    csr_destroy(&t);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Graphs without edges", []() {
+    auto edges = darray_create<CsrEdge>();
+    auto g = csr_build(5, &edges);
+    test::assert_equal(size_t(0), csr_num_edges(&g));
+    for (uint32_t v = 0; v < 5; ++v) {
+      test::assert_equal(size_t(0), csr_degree(&g, v));
+    }
+    auto empty = csr_build(0, &edges);
+    test::assert_equal(size_t(0), csr_num_vertices(&empty));
+    auto t = csr_transpose(&empty);
+    test::assert_equal(size_t(0), csr_num_edges(&t));
+
+    csr_destroy(&t);
+    csr_destroy(&empty);
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("RMAT degrees are skewed", []() {
+    auto edges = graph_gen_rmat(12, 16, 0, 11);
+    test::assert_equal(size_t(16) << 12, edges.sz);
+    auto g = csr_build_undirected(size_t(1) << 12, &edges);
+    size_t max_degree = 0;
+    for (uint32_t v = 0; v < g.n; ++v) {
+      max_degree = std::max(max_degree, csr_degree(&g, v));
+    }
+    // the average degree is 32
+    test::assert_true(max_degree > 500, "Expected a heavy tail");
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Generators are deterministic per seed", []() {
+    auto a = graph_gen_rmat(8, 4, 10, 42);
+    auto b = graph_gen_rmat(8, 4, 10, 42);
+    bool same = true;
+    for (size_t i = 0; i < a.sz; ++i) {
+      same = same && a.data[i].from == b.data[i].from &&
+             a.data[i].to == b.data[i].to &&
+             a.data[i].weight == b.data[i].weight;
+      test::assert_true(a.data[i].weight >= 1 && a.data[i].weight <= 10);
+    }
+    test::assert_true(same, "Edge lists differ");
+
+    darray_destroy(&b);
+    darray_destroy(&a);
+  });
+
+  suite.add_test("Grid graphs link each cell to its neighbours", []() {
+    auto edges = graph_gen_grid(3, 4, 9, 5);
+    test::assert_equal(size_t(3 * 3 + 2 * 4), edges.sz);
+    auto g = csr_build_undirected(12, &edges, true);
+    test::assert_equal(size_t(2), csr_degree(&g, 0));  // corner
+    test::assert_equal(size_t(3), csr_degree(&g, 1));  // edge
+    test::assert_equal(size_t(4), csr_degree(&g, 5));  // inside
+    test::assert_equal(1u, csr_targets(&g, 0)[0]);
+    test::assert_equal(4u, csr_targets(&g, 0)[1]);
+
+    csr_destroy(&g);
+    darray_destroy(&edges);
+  });
+
+  // error handling tests
+  suite.add_test("Edge endpoint out of range", []() {
+    auto edges = darray_create<CsrEdge>();
+    darray_push_back(&edges, CsrEdge{0, 3, 1});
+    bool caught_exception = false;
+
+    try {
+      csr_build(3, &edges);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    darray_destroy(&edges);
+  });
+
+  suite.add_test("Uniform edges without vertices", []() {
+    auto empty = graph_gen_uniform(0, 0);
+    test::assert_equal(size_t(0), empty.sz);
+    bool caught_exception = false;
+
+    try {
+      graph_gen_uniform(0, 10);
+    } catch (const std::runtime_error& e) {
+      caught_exception = true;
+    }
+    test::assert_true(caught_exception, "Expected exception not thrown");
+
+    darray_destroy(&empty);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: build from an edge list, then read every edge in vertex
+  // order; ops counts input edges
+  test::Benchmark bench("CSR Graph Benchmarks");
+  const unsigned scale = 20;
+  const size_t n = size_t(1) << scale;
+  DArray<CsrEdge> edge_lists[2];
+  CsrGraph graphs[2];
+
+  for (int rmat : {0, 1}) {
+    DArray<CsrEdge>& edges = edge_lists[rmat];
+    edges =
+        rmat ? graph_gen_rmat(scale, 8, 0, 1) : graph_gen_uniform(n, 8 * n);
+    std::string suffix = std::string(rmat ? " (RMAT" : " (uniform") +
+                         ", 2^20 vertices, 2^23 edges, undirected)";
+    size_t m = edges.sz;
+
+    bench.add_test(
+        "Adjacency list build" + suffix,
+        [&edges, n]() {
+          AdjList adj = adj_build(n, &edges, true);
+          test::do_not_optimize(adj.data());
+        },
+        m);
+
+    bench.add_test(
+        "CSR build" + suffix,
+        [&edges, n]() {
+          auto g = csr_build_undirected(n, &edges);
+          test::do_not_optimize(g.targets.data);
+          csr_destroy(&g);
+        },
+        m);
+
+    AdjList adj = adj_build(n, &edges, true);
+    bench.add_test(
+        "Adjacency list scan" + suffix,
+        [adj = std::move(adj)]() { test::do_not_optimize(adj_scan(adj)); }, m);
+
+    graphs[rmat] = csr_build_undirected(n, &edges);
+    const CsrGraph* g = &graphs[rmat];
+    bench.add_test(
+        "CSR scan" + suffix, [g]() { test::do_not_optimize(csr_scan(g)); }, m);
+  }
+
+  // run all benchmarks
+  bench.run();
+
+  for (int rmat : {0, 1}) {
+    csr_destroy(&graphs[rmat]);
+    darray_destroy(&edge_lists[rmat]);
+  }
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "CSR graph program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
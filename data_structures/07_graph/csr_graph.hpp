@@ -0,0 +1,170 @@
+/**
+ * csr_graph.hpp
+ *
+ * A directed graph in compressed sparse row (CSR) form: the edges leaving
+ * vertex v are targets[offsets[v] .. offsets[v + 1]), with an optional
+ * parallel array of weights. Graphs are built from an edge list by a
+ * counting sort on the source vertex, so each vertex's edges stay in the
+ * order they appear in the list. An undirected graph is stored with every
+ * edge in both directions.
+ */
+
+#pragma once
+
+#include "../00_dynamic_array/darray.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+struct CsrEdge {
+  uint32_t from;
+  uint32_t to;
+  uint32_t weight;
+};
+
+struct CsrGraph {
+  DArray<uint64_t> offsets; // n + 1 entries
+  DArray<uint32_t> targets; // one per edge
+  DArray<uint32_t> weights; // parallel to targets, empty when unweighted
+  size_t n;                 // number of vertices
+};
+
+// number of vertices
+inline size_t csr_num_vertices(const CsrGraph* g) { return g->n; }
+
+// number of directed edges
+inline size_t csr_num_edges(const CsrGraph* g) { return g->targets.sz; }
+
+// true if every edge carries a weight
+inline bool csr_weighted(const CsrGraph* g) {
+  return g->weights.sz == g->targets.sz && g->targets.sz > 0;
+}
+
+// number of edges leaving v
+inline size_t csr_degree(const CsrGraph* g, uint32_t v) {
+  return g->offsets.data[v + 1] - g->offsets.data[v];
+}
+
+// first target of v's edges; csr_degree(g, v) of them follow
+inline const uint32_t* csr_targets(const CsrGraph* g, uint32_t v) {
+  return g->targets.data + g->offsets.data[v];
+}
+
+// first weight of v's edges, parallel to csr_targets
+inline const uint32_t* csr_weights(const CsrGraph* g, uint32_t v) {
+  return g->weights.data + g->offsets.data[v];
+}
+
+// release graph memory
+inline void csr_destroy(CsrGraph* g) {
+  darray_destroy(&g->offsets);
+  darray_destroy(&g->targets);
+  darray_destroy(&g->weights);
+  g->n = 0;
+}
+
+// graph with n vertices and room for m edges, offsets zeroed
+inline CsrGraph csr_alloc(size_t n, size_t m, bool weighted) {
+  CsrGraph g;
+  g.n = n;
+  g.offsets = darray_create<uint64_t>(n + 1);
+  g.targets = darray_create<uint32_t>(m ? m : 1);
+  g.weights = darray_create<uint32_t>(weighted && m ? m : 1);
+  g.offsets.sz = n + 1;
+  g.targets.sz = m;
+  g.weights.sz = weighted ? m : 0;
+  for (size_t v = 0; v <= n; ++v) {
+    g.offsets.data[v] = 0;
+  }
+  return g;
+}
+
+// turn per-vertex counts stored at offsets[v + 1] into starting offsets
+inline void csr_prefix_sum(CsrGraph* g) {
+  for (size_t v = 0; v < g->n; ++v) {
+    g->offsets.data[v + 1] += g->offsets.data[v];
+  }
+}
+
+// place an edge at the next free slot of `from`, which offsets[from]
+// tracks while scattering
+inline void csr_place(CsrGraph* g, uint32_t from, uint32_t to,
+                      uint32_t weight) {
+  uint64_t slot = g->offsets.data[from]++;
+  g->targets.data[slot] = to;
+  if (g->weights.sz) {
+    g->weights.data[slot] = weight;
+  }
+}
+
+// scattering advanced every offsets[v] to where v + 1 starts; shift them
+// back by one vertex
+inline void csr_restore_offsets(CsrGraph* g) {
+  for (size_t v = g->n; v > 0; --v) {
+    g->offsets.data[v] = g->offsets.data[v - 1];
+  }
+  g->offsets.data[0] = 0;
+}
+
+// counting sort of edges by source into a new graph: one pass counts
+// degrees, one pass places the edges
+inline CsrGraph csr_build_impl(size_t n, const DArray<CsrEdge>* edges,
+                               bool weighted, bool undirected) {
+  if (n >= UINT32_MAX) {
+    throw std::runtime_error("Too many vertices");
+  }
+  size_t m = edges->sz;
+  for (size_t i = 0; i < m; ++i) {
+    if (edges->data[i].from >= n || edges->data[i].to >= n) {
+      throw std::runtime_error("Edge endpoint out of range");
+    }
+  }
+  CsrGraph g = csr_alloc(n, undirected ? 2 * m : m, weighted);
+  for (size_t i = 0; i < m; ++i) {
+    g.offsets.data[edges->data[i].from + 1]++;
+    if (undirected) {
+      g.offsets.data[edges->data[i].to + 1]++;
+    }
+  }
+  csr_prefix_sum(&g);
+  for (size_t i = 0; i < m; ++i) {
+    const CsrEdge& e = edges->data[i];
+    csr_place(&g, e.from, e.to, e.weight);
+    if (undirected) {
+      csr_place(&g, e.to, e.from, e.weight);
+    }
+  }
+  csr_restore_offsets(&g);
+  return g;
+}
+
+// directed graph over vertices [0, n) from an edge list; weights are kept
+// only when asked for
+inline CsrGraph csr_build(size_t n, const DArray<CsrEdge>* edges,
+                          bool weighted = false) {
+  return csr_build_impl(n, edges, weighted, false);
+}
+
+// undirected graph: every edge is stored once from each endpoint
+inline CsrGraph csr_build_undirected(size_t n, const DArray<CsrEdge>* edges,
+                                     bool weighted = false) {
+  return csr_build_impl(n, edges, weighted, true);
+}
+
+// graph with every edge reversed, its in-edges as out-edges; edges into a
+// vertex come out ordered by source
+inline CsrGraph csr_transpose(const CsrGraph* g) {
+  CsrGraph t = csr_alloc(g->n, g->targets.sz, csr_weighted(g));
+  for (size_t e = 0; e < g->targets.sz; ++e) {
+    t.offsets.data[g->targets.data[e] + 1]++;
+  }
+  csr_prefix_sum(&t);
+  for (size_t u = 0; u < g->n; ++u) {
+    for (uint64_t e = g->offsets.data[u]; e < g->offsets.data[u + 1]; ++e) {
+      csr_place(&t, g->targets.data[e], uint32_t(u),
+                t.weights.sz ? g->weights.data[e] : 0);
+    }
+  }
+  csr_restore_offsets(&t);
+  return t;
+}
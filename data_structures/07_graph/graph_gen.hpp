@@ -0,0 +1,118 @@
+/**
+ * graph_gen.hpp
+ *
+ * Random edge lists for tests and benchmarks. Uniform graphs pick both
+ * endpoints of every edge uniformly; RMAT graphs (Chakrabarti et al.)
+ * place each edge by descending the adjacency matrix one quadrant at a
+ * time with skewed probabilities, which gives the heavy-tailed degrees and
+ * small diameter of social and web graphs. Vertex ids of RMAT graphs are
+ * shuffled so high-degree vertices are not clustered at small ids. Grid
+ * graphs stand in for road networks.
+ */
+
+#pragma once
+
+#include "../00_dynamic_array/darray.hpp"
+#include "csr_graph.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+// Graph500 quadrant probabilities, in 1/65536ths; d gets the rest
+#define RMAT_A 37355 // 0.57
+#define RMAT_B 12452 // 0.19
+#define RMAT_C 12452 // 0.19
+
+// weight in [1, max_weight], or 1 when max_weight is 0
+inline uint32_t graph_gen_weight(std::mt19937_64& rng, uint32_t max_weight) {
+  return max_weight ? uint32_t(rng() % max_weight) + 1 : 1;
+}
+
+// m edges with endpoints uniform over [0, n)
+inline DArray<CsrEdge> graph_gen_uniform(size_t n, size_t m,
+                                         uint32_t max_weight = 0,
+                                         uint64_t seed = 1) {
+  if (n == 0 && m > 0) {
+    throw std::runtime_error("Edges need at least one vertex");
+  }
+  std::mt19937_64 rng(seed);
+  DArray<CsrEdge> edges = darray_create<CsrEdge>(m ? m : 1);
+  for (size_t i = 0; i < m; ++i) {
+    uint32_t from = uint32_t(rng() % n);
+    uint32_t to = uint32_t(rng() % n);
+    darray_push_back(&edges,
+                     CsrEdge{from, to, graph_gen_weight(rng, max_weight)});
+  }
+  return edges;
+}
+
+// edge_factor << scale RMAT edges over 1 << scale vertices; self loops and
+// repeated edges are kept, as in Graph500
+inline DArray<CsrEdge> graph_gen_rmat(unsigned scale, size_t edge_factor,
+                                      uint32_t max_weight = 0,
+                                      uint64_t seed = 1) {
+  std::mt19937_64 rng(seed);
+  size_t n = size_t(1) << scale;
+  size_t m = edge_factor * n;
+
+  // random relabelling of the vertices
+  DArray<uint32_t> perm = darray_create<uint32_t>(n);
+  for (size_t v = 0; v < n; ++v) {
+    darray_push_back(&perm, uint32_t(v));
+  }
+  for (size_t v = n; v > 1; --v) {
+    std::swap(perm.data[v - 1], perm.data[rng() % v]);
+  }
+
+  DArray<CsrEdge> edges = darray_create<CsrEdge>(m ? m : 1);
+  for (size_t i = 0; i < m; ++i) {
+    uint32_t from = 0;
+    uint32_t to = 0;
+    uint64_t bits = 0;
+    for (unsigned level = 0; level < scale; ++level) {
+      // one 64-bit draw covers four levels
+      if (level % 4 == 0) {
+        bits = rng();
+      }
+      uint32_t r = uint32_t(bits & 0xffff);
+      bits >>= 16;
+      uint32_t row = r >= RMAT_A + RMAT_B;
+      uint32_t col = (r >= RMAT_A && r < RMAT_A + RMAT_B) ||
+                     r >= RMAT_A + RMAT_B + RMAT_C;
+      from = (from << 1) | row;
+      to = (to << 1) | col;
+    }
+    darray_push_back(&edges,
+                     CsrEdge{perm.data[from], perm.data[to],
+                             graph_gen_weight(rng, max_weight)});
+  }
+  darray_destroy(&perm);
+  return edges;
+}
+
+// rows x cols grid with an edge from every vertex to its right and lower
+// neighbours, a stand-in for road networks: low degree, no hubs and a
+// diameter of rows + cols. Vertex (r, c) is r * cols + c.
+inline DArray<CsrEdge> graph_gen_grid(size_t rows, size_t cols,
+                                      uint32_t max_weight = 0,
+                                      uint64_t seed = 1) {
+  std::mt19937_64 rng(seed);
+  size_t m = rows * cols * 2;
+  DArray<CsrEdge> edges = darray_create<CsrEdge>(m ? m : 1);
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t c = 0; c < cols; ++c) {
+      uint32_t v = uint32_t(r * cols + c);
+      if (c + 1 < cols) {
+        darray_push_back(&edges,
+                         CsrEdge{v, v + 1, graph_gen_weight(rng, max_weight)});
+      }
+      if (r + 1 < rows) {
+        darray_push_back(&edges, CsrEdge{v, uint32_t(v + cols),
+                                         graph_gen_weight(rng, max_weight)});
+      }
+    }
+  }
+  return edges;
+}
@@ -0,0 +1,536 @@
+/**
+ * art.cpp
+ *
+ * Adaptive radix tree tests, and benchmarks against std::map and
+ * std::unordered_map on string and integer keys, with the memory each key
+ * costs.
+ */
+
+#include "art.hpp"
+#include "testing.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// type of the root node, or -1 for an empty tree or a lone leaf
+template <typename V> int root_type(const ArtTree<V>* tree) {
+  if (!tree->root || art_is_leaf(tree->root)) {
+    return -1;
+  }
+  return tree->root->type;
+}
+
+// every (key, value) of the tree in iteration order
+template <typename V>
+std::vector<std::pair<std::string, V>> art_entries(const ArtTree<V>* tree) {
+  std::vector<std::pair<std::string, V>> out;
+  art_for_each(tree, [&](std::string_view key, const V& value) {
+    out.emplace_back(std::string(key), value);
+  });
+  return out;
+}
+
+// entries of a std::map with lo <= key < hi
+std::vector<std::pair<std::string, int>>
+map_range(const std::map<std::string, int>& map, const std::string& lo,
+          const std::string& hi) {
+  std::vector<std::pair<std::string, int>> out;
+  if (lo < hi) {
+    out.assign(map.lower_bound(lo), map.lower_bound(hi));
+  }
+  return out;
+}
+
+// nodes a trie with 26 child pointers per node needs for keys: one per
+// distinct prefix, counted from the sorted keys' common prefixes
+size_t pointer_trie_nodes(std::vector<std::string> keys) {
+  std::sort(keys.begin(), keys.end());
+  size_t nodes = 1; // the root
+  for (size_t i = 0; i < keys.size(); ++i) {
+    size_t common = 0;
+    if (i > 0) {
+      size_t limit = std::min(keys[i].size(), keys[i - 1].size());
+      while (common < limit && keys[i][common] == keys[i - 1][common]) {
+        common++;
+      }
+    }
+    nodes += keys[i].size() - common;
+  }
+  return nodes;
+}
+
+int main(void) {
+  // test suite
+  test::TestSuite suite("Adaptive Radix Tree Tests");
+
+  suite.add_test("Insert, find and assign", []() {
+    auto tree = art_create<int>();
+    test::assert_true(art_insert(&tree, "banana", 1));
+    test::assert_true(art_insert(&tree, "band", 2));
+    test::assert_true(art_insert(&tree, "apple", 3));
+    test::assert_false(art_insert(&tree, "band", 4));
+
+    test::assert_equal(size_t(3), art_size(&tree));
+    test::assert_equal(1, *art_find(&tree, "banana"));
+    test::assert_equal(4, *art_find(&tree, "band"));
+    test::assert_true(art_find(&tree, "ban") == nullptr);
+    test::assert_true(art_find(&tree, "bandana") == nullptr);
+    test::assert_true(art_find(&tree, "cherry") == nullptr);
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Keys that are prefixes of other keys", []() {
+    auto tree = art_create<int>();
+    std::vector<std::string> keys = {"abc", "", "a", "ab", "abcd",
+                                     std::string("a\0b", 3)};
+    for (size_t i = 0; i < keys.size(); ++i) {
+      art_insert(&tree, keys[i], int(i));
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+      test::assert_equal(int(i), *art_find(&tree, keys[i]));
+    }
+    // in byte order, each key before its extensions
+    std::vector<std::string> order;
+    art_for_each(&tree, [&](std::string_view key, int) {
+      order.emplace_back(key);
+    });
+    std::sort(keys.begin(), keys.end());
+    test::assert_true(order == keys, "Keys out of order");
+
+    test::assert_true(art_erase(&tree, "ab"));
+    test::assert_true(art_find(&tree, "ab") == nullptr);
+    test::assert_equal(0, *art_find(&tree, "abc"));
+    test::assert_true(art_erase(&tree, ""));
+    test::assert_equal(2, *art_find(&tree, "a"));
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Prefixes longer than a node stores", []() {
+    auto tree = art_create<int>();
+    std::string shared(40, 'x');
+    art_insert(&tree, shared + "1", 1);
+    art_insert(&tree, shared + "2", 2);
+    // split the compressed path past the stored bytes, then inside them
+    art_insert(&tree, std::string(30, 'x') + "y", 3);
+    art_insert(&tree, "xxy", 4);
+    test::assert_equal(1, *art_find(&tree, shared + "1"));
+    test::assert_equal(2, *art_find(&tree, shared + "2"));
+    test::assert_equal(3, *art_find(&tree, std::string(30, 'x') + "y"));
+    test::assert_equal(4, *art_find(&tree, "xxy"));
+    // differs only in a byte the node does not store
+    test::assert_true(art_find(&tree, std::string(35, 'x') + "z" +
+                                          std::string(4, 'x') + "1") ==
+                      nullptr);
+
+    // erasing folds nodes back together
+    art_erase(&tree, "xxy");
+    art_erase(&tree, std::string(30, 'x') + "y");
+    test::assert_equal(1, *art_find(&tree, shared + "1"));
+    test::assert_equal(2, *art_find(&tree, shared + "2"));
+    test::assert_equal(int(ART_NODE4), root_type(&tree));
+    test::assert_equal(uint32_t(40), tree.root->prefix_len);
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Nodes grow and shrink with their fan-out", []() {
+    auto tree = art_create<int>();
+    const int expected[] = {ART_NODE4, ART_NODE16, ART_NODE48, ART_NODE256};
+    const int bounds[] = {4, 16, 48, 256};
+    int type = 0;
+    art_insert(&tree, std::string(1, '\0') + "key", 0);
+    test::assert_equal(-1, root_type(&tree)); // a single leaf
+    for (int c = 1; c < 256; ++c) {
+      art_insert(&tree, std::string(1, char(c)) + "key", c);
+      if (c + 1 > bounds[type]) {
+        type++;
+      }
+      test::assert_equal(expected[type], root_type(&tree));
+    }
+    for (int c = 0; c < 256; ++c) {
+      test::assert_equal(c, *art_find(&tree, std::string(1, char(c)) + "key"));
+    }
+    // shrinking waits a little past each bound so that a key added and
+    // removed at the edge does not copy the node every time
+    for (int c = 255; c >= 2; --c) {
+      art_erase(&tree, std::string(1, char(c)) + "key");
+    }
+    test::assert_equal(int(ART_NODE4), root_type(&tree));
+    art_erase(&tree, std::string(1, char(1)) + "key");
+    test::assert_equal(-1, root_type(&tree));
+    test::assert_equal(0, *art_find(&tree, std::string(1, '\0') + "key"));
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Matches reference under random load", []() {
+    test::RandomGenerator gen;
+    auto tree = art_create<int>();
+    std::map<std::string, int> ref;
+    // short keys over a small alphabet overlap a lot
+    auto keys = gen.generate_strings(20000, 0, 6);
+    auto ops = gen.generate_ints(keys.size(), 0, 2);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      const std::string& key = keys[i];
+      if (ops[i] < 2) {
+        test::assert_equal(ref.count(key) == 0,
+                           art_insert(&tree, key, int(i)));
+        ref[key] = int(i);
+      } else {
+        test::assert_equal(ref.erase(key) == 1, art_erase(&tree, key));
+      }
+    }
+    test::assert_equal(ref.size(), art_size(&tree));
+    auto want = std::vector<std::pair<std::string, int>>(ref.begin(),
+                                                         ref.end());
+    test::assert_true(art_entries(&tree) == want, "Entries differ");
+
+    for (const auto& [key, value] : want) {
+      art_erase(&tree, key);
+    }
+    test::assert_equal(size_t(0), art_size(&tree));
+    test::assert_true(tree.root == nullptr);
+    test::assert_equal(size_t(0), tree.leaf_bytes);
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Prefix iteration", []() {
+    auto tree = art_create<int>();
+    std::vector<std::string> words = {"car",  "card",   "care", "cargo",
+                                      "cat",  "dog",    "ca",   "c",
+                                      "cart", "carton", "zebra"};
+    for (size_t i = 0; i < words.size(); ++i) {
+      art_insert(&tree, words[i], int(i));
+    }
+    auto with = [&](std::string_view prefix) {
+      std::vector<std::string> out;
+      art_prefix(&tree, prefix, [&](std::string_view key, int) {
+        out.emplace_back(key);
+      });
+      return out;
+    };
+    test::assert_true(with("car") == std::vector<std::string>{"car", "card",
+                                                              "care", "cargo",
+                                                              "cart",
+                                                              "carton"});
+    test::assert_true(with("cart") ==
+                      std::vector<std::string>{"cart", "carton"});
+    test::assert_true(with("carto") == std::vector<std::string>{"carton"});
+    test::assert_true(with("cartoons").empty());
+    test::assert_true(with("d") == std::vector<std::string>{"dog"});
+    test::assert_true(with("b").empty());
+    test::assert_equal(words.size(), with("").size());
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Range scans match std::map", []() {
+    test::RandomGenerator gen;
+    auto tree = art_create<int>();
+    std::map<std::string, int> ref;
+    auto keys = gen.generate_strings(5000, 1, 12);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      art_insert(&tree, keys[i], int(i));
+      ref[keys[i]] = int(i);
+    }
+    auto bounds = gen.generate_strings(400, 0, 4);
+    for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+      const std::string& lo = bounds[i];
+      const std::string& hi = bounds[i + 1];
+      std::vector<std::pair<std::string, int>> got;
+      art_range(&tree, lo, hi, [&](std::string_view key, int value) {
+        got.emplace_back(std::string(key), value);
+      });
+      test::assert_true(got == map_range(ref, lo, hi), "Range differs");
+    }
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Integer keys sort numerically", []() {
+    auto tree = art_create<uint64_t>();
+    std::mt19937_64 rng(7);
+    std::map<uint64_t, uint64_t> ref;
+    for (size_t i = 0; i < 5000; ++i) {
+      // small, clustered and full-width keys
+      uint64_t key = i % 3 == 0 ? i : i % 3 == 1 ? rng() % 70000 : rng();
+      art_insert(&tree, key, i);
+      ref[key] = i;
+    }
+    art_insert(&tree, UINT64_MAX, uint64_t(1));
+    ref[UINT64_MAX] = 1;
+    test::assert_equal(ref.size(), art_size(&tree));
+
+    std::vector<uint64_t> order;
+    art_for_each(&tree, [&](std::string_view key, uint64_t) {
+      order.push_back(art_decode(key));
+    });
+    test::assert_equal(ref.size(), order.size());
+    test::assert_true(std::is_sorted(order.begin(), order.end()));
+
+    std::vector<uint64_t> got;
+    art_range(&tree, uint64_t(100), uint64_t(60000),
+              [&](std::string_view key, uint64_t value) {
+                test::assert_equal(ref[art_decode(key)], value);
+                got.push_back(art_decode(key));
+              });
+    std::vector<uint64_t> want;
+    for (auto it = ref.lower_bound(100); it != ref.lower_bound(60000); ++it) {
+      want.push_back(it->first);
+    }
+    test::assert_true(got == want, "Range differs");
+
+    test::assert_equal(uint64_t(1), *art_find(&tree, UINT64_MAX));
+    test::assert_true(art_erase(&tree, uint64_t(0)));
+    test::assert_true(art_find(&tree, uint64_t(0)) == nullptr);
+
+    art_destroy(&tree);
+  });
+
+  suite.add_test("Non-trivial values", []() {
+    auto tree = art_create<std::string>();
+    for (int i = 0; i < 1000; ++i) {
+      art_insert(&tree, std::to_string(i), std::string(40, char('a' + i % 26)));
+    }
+    art_insert(&tree, "7", std::string("seven"));
+    test::assert_equal(std::string("seven"), *art_find(&tree, "7"));
+    for (int i = 0; i < 1000; i += 2) {
+      art_erase(&tree, std::to_string(i));
+    }
+    test::assert_equal(size_t(500), art_size(&tree));
+
+    art_destroy(&tree);
+  });
+
+  // run all tests
+  suite.run();
+
+  // benchmarking: a million random lowercase keys of 8 to 16 letters, and
+  // a million random 64-bit integers; lookups hit in shuffled order
+  test::Benchmark bench("Adaptive Radix Tree Benchmarks");
+  const size_t n = 1000000;
+  test::RandomGenerator gen;
+  std::vector<std::string> keys = gen.generate_strings(n, 8, 16);
+  std::vector<std::string> probes = keys;
+  std::shuffle(probes.begin(), probes.end(), std::mt19937(1));
+  std::vector<std::string> prefixes = gen.generate_strings(1000, 3, 3);
+
+  std::mt19937_64 rng(1);
+  std::vector<uint64_t> ints(n);
+  for (uint64_t& key : ints) {
+    key = rng();
+  }
+  std::vector<uint64_t> int_probes = ints;
+  std::shuffle(int_probes.begin(), int_probes.end(), std::mt19937(2));
+
+  bench.add_test(
+      "std::map string inserts",
+      [&]() {
+        std::map<std::string, uint32_t> map;
+        for (size_t i = 0; i < n; ++i) {
+          map.emplace(keys[i], uint32_t(i));
+        }
+        test::do_not_optimize(map.size());
+      },
+      n);
+
+  bench.add_test(
+      "std::unordered_map string inserts",
+      [&]() {
+        std::unordered_map<std::string, uint32_t> map;
+        for (size_t i = 0; i < n; ++i) {
+          map.emplace(keys[i], uint32_t(i));
+        }
+        test::do_not_optimize(map.size());
+      },
+      n);
+
+  bench.add_test(
+      "ART string inserts",
+      [&]() {
+        auto tree = art_create<uint32_t>();
+        for (size_t i = 0; i < n; ++i) {
+          art_insert(&tree, keys[i], uint32_t(i));
+        }
+        test::do_not_optimize(art_size(&tree));
+        art_destroy(&tree);
+      },
+      n);
+
+  std::map<std::string, uint32_t> map;
+  std::unordered_map<std::string, uint32_t> hash;
+  auto strings = art_create<uint32_t>();
+  for (size_t i = 0; i < n; ++i) {
+    map.emplace(keys[i], uint32_t(i));
+    hash.emplace(keys[i], uint32_t(i));
+    art_insert(&strings, keys[i], uint32_t(i));
+  }
+
+  bench.add_test(
+      "std::map string lookup",
+      [&]() {
+        uint64_t sum = 0;
+        for (const std::string& key : probes) {
+          sum += map.find(key)->second;
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  bench.add_test(
+      "std::unordered_map string lookup",
+      [&]() {
+        uint64_t sum = 0;
+        for (const std::string& key : probes) {
+          sum += hash.find(key)->second;
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  bench.add_test(
+      "ART string lookup",
+      [&]() {
+        uint64_t sum = 0;
+        for (const std::string& key : probes) {
+          sum += *art_find(&strings, key);
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  // ops counts keys reported
+  size_t prefix_hits = 0;
+  for (const std::string& prefix : prefixes) {
+    art_prefix(&strings, prefix, [&](std::string_view, uint32_t) {
+      prefix_hits++;
+    });
+  }
+
+  bench.add_test(
+      "std::map prefix scans (1000 3-letter prefixes)",
+      [&]() {
+        uint64_t sum = 0;
+        for (const std::string& prefix : prefixes) {
+          for (auto it = map.lower_bound(prefix);
+               it != map.end() && it->first.compare(0, 3, prefix) == 0; ++it) {
+            sum += it->second;
+          }
+        }
+        test::do_not_optimize(sum);
+      },
+      prefix_hits);
+
+  bench.add_test(
+      "ART prefix scans (1000 3-letter prefixes)",
+      [&]() {
+        uint64_t sum = 0;
+        for (const std::string& prefix : prefixes) {
+          art_prefix(&strings, prefix,
+                     [&](std::string_view, uint32_t value) { sum += value; });
+        }
+        test::do_not_optimize(sum);
+      },
+      prefix_hits);
+
+  bench.add_test(
+      "std::map integer inserts",
+      [&]() {
+        std::map<uint64_t, uint32_t> imap;
+        for (size_t i = 0; i < n; ++i) {
+          imap.emplace(ints[i], uint32_t(i));
+        }
+        test::do_not_optimize(imap.size());
+      },
+      n);
+
+  bench.add_test(
+      "ART integer inserts",
+      [&]() {
+        auto tree = art_create<uint32_t>();
+        for (size_t i = 0; i < n; ++i) {
+          art_insert(&tree, ints[i], uint32_t(i));
+        }
+        test::do_not_optimize(art_size(&tree));
+        art_destroy(&tree);
+      },
+      n);
+
+  std::map<uint64_t, uint32_t> imap;
+  auto integers = art_create<uint32_t>();
+  for (size_t i = 0; i < n; ++i) {
+    imap.emplace(ints[i], uint32_t(i));
+    art_insert(&integers, ints[i], uint32_t(i));
+  }
+
+  bench.add_test(
+      "std::map integer lookup",
+      [&]() {
+        uint64_t sum = 0;
+        for (uint64_t key : int_probes) {
+          sum += imap.find(key)->second;
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  bench.add_test(
+      "ART integer lookup",
+      [&]() {
+        uint64_t sum = 0;
+        for (uint64_t key : int_probes) {
+          sum += *art_find(&integers, key);
+        }
+        test::do_not_optimize(sum);
+      },
+      n);
+
+  // run all benchmarks
+  bench.run();
+
+  // dense ids, the other common integer workload
+  auto dense = art_create<uint32_t>();
+  for (size_t i = 0; i < n; ++i) {
+    art_insert(&dense, uint64_t(i), uint32_t(i));
+  }
+  size_t key_bytes = 0;
+  for (const std::string& key : keys) {
+    key_bytes += key.size();
+  }
+  // 26 children and a value per node
+  size_t trie_bytes = pointer_trie_nodes(keys) * (26 * sizeof(void*) + 8);
+
+  std::cout << "\nBytes per key (1000000 keys, uint32_t values):"
+            << std::fixed << std::setprecision(1) << std::endl;
+  std::cout << "  " << std::setw(7) << double(key_bytes) / n
+            << "  raw string key bytes" << std::endl;
+  std::cout << "  " << std::setw(7) << double(art_memory(&strings)) / n
+            << "  ART, string keys" << std::endl;
+  std::cout << "  " << std::setw(7) << double(trie_bytes) / n
+            << "  26-pointer trie, string keys (node count x node size)"
+            << std::endl;
+  std::cout << "  " << std::setw(7) << double(art_memory(&integers)) / n
+            << "  ART, random 64-bit keys" << std::endl;
+  std::cout << "  " << std::setw(7) << double(art_memory(&dense)) / n
+            << "  ART, dense 64-bit keys 0..n-1" << std::defaultfloat
+            << std::endl;
+
+  art_destroy(&dense);
+  art_destroy(&integers);
+  art_destroy(&strings);
+
+  std::cout << "\n" << std::string(50, '=') << std::endl;
+  std::cout << "Adaptive radix tree program is complete." << std::endl;
+  std::cout << "" << std::string(50, '=') << std::endl;
+  std::cout << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,997 @@
+/**
+ * art.hpp
+ *
+ * An adaptive radix tree (Leis et al.), a trie over the bytes of a key
+ * whose inner nodes come in four sizes and grow or shrink with their
+ * fan-out:
+ *
+ *  - Node4 and Node16 keep sorted key bytes next to their children; a
+ *    Node16 is searched with one SSE2 compare where available
+ *  - Node48 maps each byte to one of 48 child slots through a 256-byte
+ *    index
+ *  - Node256 is a plain array of 256 children
+ *
+ * Chains of single-child nodes are folded into the prefix of the node
+ * below them (path compression). A node stores the first ART_MAX_PREFIX
+ * bytes of its prefix; longer prefixes are skipped on lookup and checked
+ * against the full key kept in every leaf. A key that ends at an inner
+ * node, because it is a prefix of longer keys, hangs off that node's end
+ * slot, so keys are arbitrary byte strings.
+ *
+ * Inner nodes come from one NodePool per node size; leaves hold the key
+ * bytes after the value and are allocated one by one. Unsigned integer
+ * keys are stored big-endian so that byte order is numeric order.
+ */
+
+#pragma once
+
+#include "../01_linked_list/node_pool.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define ART_MAX_PREFIX 8     // prefix bytes stored in an inner node
+#define ART_POOL_BYTES 65536 // rough size of an inner node pool chunk
+#define ART_INT_KEY_LEN 8    // bytes of an encoded integer key
+
+enum ArtType : uint8_t { ART_NODE4, ART_NODE16, ART_NODE48, ART_NODE256 };
+
+// header of every inner node; child pointers with the low bit set are
+// leaves
+struct ArtNode {
+  ArtNode* end;        // leaf of the key ending at this node, or nullptr
+  uint32_t prefix_len; // bytes every key below shares after the parent's
+  uint16_t count;      // children, not counting end
+  ArtType type;
+  uint8_t prefix[ART_MAX_PREFIX]; // the first of those bytes
+};
+
+struct ArtNode4 {
+  ArtNode header;
+  uint8_t keys[4]; // sorted
+  ArtNode* children[4];
+};
+
+struct ArtNode16 {
+  ArtNode header;
+  uint8_t keys[16]; // sorted
+  ArtNode* children[16];
+};
+
+struct ArtNode48 {
+  ArtNode header;
+  uint8_t index[256]; // slot + 1 of each byte's child, 0 if none
+  ArtNode* children[48];
+};
+
+struct ArtNode256 {
+  ArtNode header;
+  ArtNode* children[256];
+};
+
+// the key's len bytes follow the leaf
+template <typename V> struct ArtLeaf {
+  V value;
+  uint32_t len;
+};
+
+template <typename V> struct ArtTree {
+  ArtNode* root;
+  size_t sz;         // keys
+  size_t leaf_bytes; // bytes requested for leaves
+  NodePool<ArtNode4> pool4;
+  NodePool<ArtNode16> pool16;
+  NodePool<ArtNode48> pool48;
+  NodePool<ArtNode256> pool256;
+};
+
+template <typename N> constexpr size_t art_chunk_nodes() {
+  return std::max<size_t>(1, ART_POOL_BYTES / sizeof(N));
+}
+
+// initialize empty tree; no memory is allocated until the first insert
+template <typename V> ArtTree<V> art_create() {
+  return ArtTree<V>{nullptr,
+                    0,
+                    0,
+                    node_pool_create<ArtNode4>(art_chunk_nodes<ArtNode4>()),
+                    node_pool_create<ArtNode16>(art_chunk_nodes<ArtNode16>()),
+                    node_pool_create<ArtNode48>(art_chunk_nodes<ArtNode48>()),
+                    node_pool_create<ArtNode256>(
+                        art_chunk_nodes<ArtNode256>())};
+}
+
+inline bool art_is_leaf(const ArtNode* ref) {
+  return reinterpret_cast<uintptr_t>(ref) & 1;
+}
+
+template <typename V> ArtLeaf<V>* art_leaf(const ArtNode* ref) {
+  return reinterpret_cast<ArtLeaf<V>*>(reinterpret_cast<uintptr_t>(ref) - 1);
+}
+
+template <typename V> ArtNode* art_leaf_ref(ArtLeaf<V>* leaf) {
+  return reinterpret_cast<ArtNode*>(reinterpret_cast<uintptr_t>(leaf) + 1);
+}
+
+template <typename V> const uint8_t* art_leaf_key(const ArtLeaf<V>* leaf) {
+  return reinterpret_cast<const uint8_t*>(leaf + 1);
+}
+
+template <typename V>
+bool art_leaf_matches(const ArtLeaf<V>* leaf, const uint8_t* key,
+                      size_t len) {
+  return leaf->len == len && memcmp(art_leaf_key(leaf), key, len) == 0;
+}
+
+template <typename V>
+std::string_view art_leaf_view(const ArtLeaf<V>* leaf) {
+  return std::string_view(reinterpret_cast<const char*>(art_leaf_key(leaf)),
+                          leaf->len);
+}
+
+// new leaf holding a copy of the key, as a tagged child pointer
+template <typename V>
+ArtNode* art_new_leaf(ArtTree<V>* tree, const uint8_t* key, size_t len,
+                      V value) {
+  if (len > UINT32_MAX) {
+    throw std::runtime_error("Key too long");
+  }
+  size_t bytes = sizeof(ArtLeaf<V>) + len;
+  void* mem = std::malloc(bytes);
+  if (!mem) {
+    throw std::bad_alloc();
+  }
+  ArtLeaf<V>* leaf = new (mem) ArtLeaf<V>{std::move(value), uint32_t(len)};
+  memcpy(const_cast<uint8_t*>(art_leaf_key(leaf)), key, len);
+  tree->leaf_bytes += bytes;
+  return art_leaf_ref(leaf);
+}
+
+template <typename V> void art_free_leaf(ArtTree<V>* tree, ArtNode* ref) {
+  ArtLeaf<V>* leaf = art_leaf<V>(ref);
+  tree->leaf_bytes -= sizeof(ArtLeaf<V>) + leaf->len;
+  std::destroy_at(leaf);
+  std::free(leaf);
+}
+
+// empty inner node of the given type, copying prefix and end from header
+// if given
+template <typename V>
+ArtNode* art_new_node(ArtTree<V>* tree, ArtType type,
+                      const ArtNode* header = nullptr) {
+  void* mem = nullptr;
+  size_t bytes = 0;
+  switch (type) {
+  case ART_NODE4:
+    mem = node_pool_alloc(&tree->pool4);
+    bytes = sizeof(ArtNode4);
+    break;
+  case ART_NODE16:
+    mem = node_pool_alloc(&tree->pool16);
+    bytes = sizeof(ArtNode16);
+    break;
+  case ART_NODE48:
+    mem = node_pool_alloc(&tree->pool48);
+    bytes = sizeof(ArtNode48);
+    break;
+  case ART_NODE256:
+    mem = node_pool_alloc(&tree->pool256);
+    bytes = sizeof(ArtNode256);
+    break;
+  }
+  memset(mem, 0, bytes);
+  ArtNode* node = static_cast<ArtNode*>(mem);
+  if (header) {
+    *node = *header;
+  }
+  node->type = type;
+  node->count = 0;
+  return node;
+}
+
+template <typename V> void art_free_node(ArtTree<V>* tree, ArtNode* node) {
+  switch (node->type) {
+  case ART_NODE4:
+    node_pool_free(&tree->pool4, node);
+    break;
+  case ART_NODE16:
+    node_pool_free(&tree->pool16, node);
+    break;
+  case ART_NODE48:
+    node_pool_free(&tree->pool48, node);
+    break;
+  case ART_NODE256:
+    node_pool_free(&tree->pool256, node);
+    break;
+  }
+}
+
+// destroy every leaf below ref; inner nodes go with their pools
+template <typename V> void art_destroy_leaves(ArtTree<V>* tree, ArtNode* ref) {
+  if (!ref) {
+    return;
+  }
+  if (art_is_leaf(ref)) {
+    art_free_leaf(tree, ref);
+    return;
+  }
+  art_destroy_leaves(tree, ref->end);
+  switch (ref->type) {
+  case ART_NODE4:
+    for (size_t i = 0; i < ref->count; ++i) {
+      art_destroy_leaves(tree, reinterpret_cast<ArtNode4*>(ref)->children[i]);
+    }
+    break;
+  case ART_NODE16:
+    for (size_t i = 0; i < ref->count; ++i) {
+      art_destroy_leaves(tree, reinterpret_cast<ArtNode16*>(ref)->children[i]);
+    }
+    break;
+  case ART_NODE48:
+    for (ArtNode* child : reinterpret_cast<ArtNode48*>(ref)->children) {
+      art_destroy_leaves(tree, child);
+    }
+    break;
+  case ART_NODE256:
+    for (ArtNode* child : reinterpret_cast<ArtNode256*>(ref)->children) {
+      art_destroy_leaves(tree, child);
+    }
+    break;
+  }
+}
+
+// destroy every entry and release the pools
+template <typename V> void art_destroy(ArtTree<V>* tree) {
+  art_destroy_leaves(tree, tree->root);
+  node_pool_destroy(&tree->pool4);
+  node_pool_destroy(&tree->pool16);
+  node_pool_destroy(&tree->pool48);
+  node_pool_destroy(&tree->pool256);
+  tree->root = nullptr;
+  tree->sz = 0;
+}
+
+// number of keys
+template <typename V> size_t art_size(const ArtTree<V>* tree) {
+  return tree->sz;
+}
+
+template <typename N> size_t art_pool_bytes(const NodePool<N>* pool) {
+  size_t chunk_bytes =
+      NodePool<N>::header_size + pool->chunk_nodes * NodePool<N>::slot_size;
+  return pool->num_chunks * chunk_bytes;
+}
+
+// heap bytes held by the tree: every pool chunk, plus the bytes requested
+// for leaves (malloc's own overhead on those is not counted)
+template <typename V> size_t art_memory(const ArtTree<V>* tree) {
+  return art_pool_bytes(&tree->pool4) + art_pool_bytes(&tree->pool16) +
+         art_pool_bytes(&tree->pool48) + art_pool_bytes(&tree->pool256) +
+         tree->leaf_bytes;
+}
+
+// slot of the child under byte b, or nullptr
+inline ArtNode** art_find_child(ArtNode* node, uint8_t b) {
+  switch (node->type) {
+  case ART_NODE4: {
+    ArtNode4* n = reinterpret_cast<ArtNode4*>(node);
+    for (size_t i = 0; i < node->count; ++i) {
+      if (n->keys[i] == b) {
+        return &n->children[i];
+      }
+    }
+    return nullptr;
+  }
+  case ART_NODE16: {
+    ArtNode16* n = reinterpret_cast<ArtNode16*>(node);
+#if defined(__SSE2__)
+    __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i*>(n->keys));
+    unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(keys, _mm_set1_epi8(b)));
+    mask &= (1u << node->count) - 1;
+    return mask ? &n->children[__builtin_ctz(mask)] : nullptr;
+#else
+    for (size_t i = 0; i < node->count; ++i) {
+      if (n->keys[i] == b) {
+        return &n->children[i];
+      }
+    }
+    return nullptr;
+#endif
+  }
+  case ART_NODE48: {
+    ArtNode48* n = reinterpret_cast<ArtNode48*>(node);
+    return n->index[b] ? &n->children[n->index[b] - 1] : nullptr;
+  }
+  case ART_NODE256: {
+    ArtNode256* n = reinterpret_cast<ArtNode256*>(node);
+    return n->children[b] ? &n->children[b] : nullptr;
+  }
+  }
+  return nullptr;
+}
+
+// leaf with the smallest key below ref; a key ending at a node is a prefix
+// of, and so smaller than, every key in its children
+template <typename V> ArtLeaf<V>* art_minimum(const ArtNode* ref) {
+  while (!art_is_leaf(ref)) {
+    if (ref->end) {
+      ref = ref->end;
+      continue;
+    }
+    switch (ref->type) {
+    case ART_NODE4:
+      ref = reinterpret_cast<const ArtNode4*>(ref)->children[0];
+      break;
+    case ART_NODE16:
+      ref = reinterpret_cast<const ArtNode16*>(ref)->children[0];
+      break;
+    case ART_NODE48: {
+      const ArtNode48* n = reinterpret_cast<const ArtNode48*>(ref);
+      size_t b = 0;
+      while (!n->index[b]) {
+        b++;
+      }
+      ref = n->children[n->index[b] - 1];
+      break;
+    }
+    case ART_NODE256: {
+      const ArtNode256* n = reinterpret_cast<const ArtNode256*>(ref);
+      size_t b = 0;
+      while (!n->children[b]) {
+        b++;
+      }
+      ref = n->children[b];
+      break;
+    }
+    }
+  }
+  return art_leaf<V>(ref);
+}
+
+// the whole prefix of node, which starts at key byte depth; past
+// ART_MAX_PREFIX bytes it is read from a leaf below
+template <typename V>
+const uint8_t* art_full_prefix(const ArtNode* node, size_t depth) {
+  if (node->prefix_len <= ART_MAX_PREFIX) {
+    return node->prefix;
+  }
+  return art_leaf_key(art_minimum<V>(node)) + depth;
+}
+
+// pointer to the value of key, or nullptr if absent
+template <typename V>
+V* art_find(const ArtTree<V>* tree, const uint8_t* key, size_t len) {
+  ArtNode* ref = tree->root;
+  size_t depth = 0;
+  while (ref && !art_is_leaf(ref)) {
+    size_t plen = ref->prefix_len;
+    if (plen) {
+      if (depth + plen > len) {
+        return nullptr;
+      }
+      // bytes past the stored ones are checked at the leaf
+      size_t stored = std::min<size_t>(plen, ART_MAX_PREFIX);
+      if (memcmp(ref->prefix, key + depth, stored) != 0) {
+        return nullptr;
+      }
+      depth += plen;
+    }
+    if (depth == len) {
+      ref = ref->end;
+      break;
+    }
+    ArtNode** child = art_find_child(ref, key[depth]);
+    if (!child) {
+      return nullptr;
+    }
+    ref = *child;
+    depth++;
+  }
+  if (ref && art_leaf_matches(art_leaf<V>(ref), key, len)) {
+    return &art_leaf<V>(ref)->value;
+  }
+  return nullptr;
+}
+
+// insert child under byte b of the node at *ref, moving the node to the
+// next size up first if it is full
+template <typename V>
+void art_add_child(ArtTree<V>* tree, ArtNode** ref, uint8_t b,
+                   ArtNode* child) {
+  ArtNode* node = *ref;
+  switch (node->type) {
+  case ART_NODE4: {
+    ArtNode4* n = reinterpret_cast<ArtNode4*>(node);
+    if (node->count < 4) {
+      size_t i = 0;
+      while (i < node->count && n->keys[i] < b) {
+        i++;
+      }
+      memmove(n->keys + i + 1, n->keys + i, node->count - i);
+      memmove(n->children + i + 1, n->children + i,
+              (node->count - i) * sizeof(ArtNode*));
+      n->keys[i] = b;
+      n->children[i] = child;
+      node->count++;
+      return;
+    }
+    ArtNode16* grown =
+        reinterpret_cast<ArtNode16*>(art_new_node(tree, ART_NODE16, node));
+    memcpy(grown->keys, n->keys, 4);
+    memcpy(grown->children, n->children, 4 * sizeof(ArtNode*));
+    grown->header.count = 4;
+    art_free_node(tree, node);
+    *ref = &grown->header;
+    break;
+  }
+  case ART_NODE16: {
+    ArtNode16* n = reinterpret_cast<ArtNode16*>(node);
+    if (node->count < 16) {
+      size_t i = 0;
+      while (i < node->count && n->keys[i] < b) {
+        i++;
+      }
+      memmove(n->keys + i + 1, n->keys + i, node->count - i);
+      memmove(n->children + i + 1, n->children + i,
+              (node->count - i) * sizeof(ArtNode*));
+      n->keys[i] = b;
+      n->children[i] = child;
+      node->count++;
+      return;
+    }
+    ArtNode48* grown =
+        reinterpret_cast<ArtNode48*>(art_new_node(tree, ART_NODE48, node));
+    for (size_t i = 0; i < 16; ++i) {
+      grown->index[n->keys[i]] = uint8_t(i + 1);
+      grown->children[i] = n->children[i];
+    }
+    grown->header.count = 16;
+    art_free_node(tree, node);
+    *ref = &grown->header;
+    break;
+  }
+  case ART_NODE48: {
+    ArtNode48* n = reinterpret_cast<ArtNode48*>(node);
+    if (node->count < 48) {
+      size_t slot = 0;
+      while (n->children[slot]) {
+        slot++;
+      }
+      n->index[b] = uint8_t(slot + 1);
+      n->children[slot] = child;
+      node->count++;
+      return;
+    }
+    ArtNode256* grown =
+        reinterpret_cast<ArtNode256*>(art_new_node(tree, ART_NODE256, node));
+    for (size_t c = 0; c < 256; ++c) {
+      if (n->index[c]) {
+        grown->children[c] = n->children[n->index[c] - 1];
+      }
+    }
+    grown->header.count = 48;
+    art_free_node(tree, node);
+    *ref = &grown->header;
+    break;
+  }
+  case ART_NODE256: {
+    ArtNode256* n = reinterpret_cast<ArtNode256*>(node);
+    n->children[b] = child;
+    node->count++;
+    return;
+  }
+  }
+  // the node grew and has room now
+  art_add_child(tree, ref, b, child);
+}
+
+// place ref below node at key byte depth: under that byte, or in the end
+// slot if the key stops there
+template <typename V>
+void art_attach(ArtTree<V>* tree, ArtNode** node, ArtNode* ref,
+                const uint8_t* key, size_t len, size_t depth) {
+  if (depth == len) {
+    (*node)->end = ref;
+  } else {
+    art_add_child(tree, node, key[depth], ref);
+  }
+}
+
+// set the prefix of node to len bytes, storing the first ART_MAX_PREFIX
+inline void art_set_prefix(ArtNode* node, const uint8_t* bytes, size_t len) {
+  if (len > UINT32_MAX) {
+    throw std::runtime_error("Key too long");
+  }
+  node->prefix_len = uint32_t(len);
+  memmove(node->prefix, bytes, std::min<size_t>(len, ART_MAX_PREFIX));
+}
+
+// insert below *ref, whose keys all share the first depth bytes of key;
+// true if the key is new
+template <typename V>
+bool art_insert_at(ArtTree<V>* tree, ArtNode** ref, const uint8_t* key,
+                   size_t len, size_t depth, V& value) {
+  ArtNode* node = *ref;
+  if (!node) {
+    *ref = art_new_leaf(tree, key, len, std::move(value));
+    return true;
+  }
+
+  if (art_is_leaf(node)) {
+    ArtLeaf<V>* leaf = art_leaf<V>(node);
+    if (art_leaf_matches(leaf, key, len)) {
+      leaf->value = std::move(value);
+      return false;
+    }
+    // split the leaf: a Node4 over the bytes both keys still share
+    const uint8_t* other = art_leaf_key(leaf);
+    size_t limit = std::min<size_t>(len, leaf->len);
+    size_t common = depth;
+    while (common < limit && key[common] == other[common]) {
+      common++;
+    }
+    ArtNode* split = art_new_node(tree, ART_NODE4);
+    art_set_prefix(split, key + depth, common - depth);
+    art_attach(tree, &split, node, other, leaf->len, common);
+    art_attach(tree, &split, art_new_leaf(tree, key, len, std::move(value)),
+               key, len, common);
+    *ref = split;
+    return true;
+  }
+
+  if (node->prefix_len) {
+    const uint8_t* prefix = art_full_prefix<V>(node, depth);
+    size_t limit = std::min<size_t>(node->prefix_len, len - depth);
+    size_t same = 0;
+    while (same < limit && prefix[same] == key[depth + same]) {
+      same++;
+    }
+    if (same < node->prefix_len) {
+      // the key leaves the prefix early: a Node4 takes the shared part,
+      // and the old node keeps what follows its own branching byte
+      ArtNode* split = art_new_node(tree, ART_NODE4);
+      art_set_prefix(split, key + depth, same);
+      uint8_t branch = prefix[same];
+      size_t rest = node->prefix_len - same - 1;
+      // prefix may point into a leaf, which stays put
+      art_set_prefix(node, prefix + same + 1, rest);
+      art_add_child(tree, &split, branch, node);
+      art_attach(tree, &split, art_new_leaf(tree, key, len, std::move(value)),
+                 key, len, depth + same);
+      *ref = split;
+      return true;
+    }
+    depth += node->prefix_len;
+  }
+
+  if (depth == len) {
+    if (node->end) {
+      art_leaf<V>(node->end)->value = std::move(value);
+      return false;
+    }
+    node->end = art_new_leaf(tree, key, len, std::move(value));
+    return true;
+  }
+  ArtNode** child = art_find_child(node, key[depth]);
+  if (child) {
+    return art_insert_at(tree, child, key, len, depth + 1, value);
+  }
+  art_add_child(tree, ref, key[depth],
+                art_new_leaf(tree, key, len, std::move(value)));
+  return true;
+}
+
+// insert key, or assign value if already present; true if newly inserted
+template <typename V>
+bool art_insert(ArtTree<V>* tree, const uint8_t* key, size_t len, V value) {
+  bool inserted = art_insert_at(tree, &tree->root, key, len, 0, value);
+  tree->sz += inserted;
+  return inserted;
+}
+
+// take byte b's child out of node
+inline void art_remove_child(ArtNode* node, uint8_t b) {
+  switch (node->type) {
+  case ART_NODE4:
+  case ART_NODE16: {
+    // Node4 and Node16 share their layout up to the key array's length
+    uint8_t* keys = node->type == ART_NODE4
+                        ? reinterpret_cast<ArtNode4*>(node)->keys
+                        : reinterpret_cast<ArtNode16*>(node)->keys;
+    ArtNode** children = node->type == ART_NODE4
+                             ? reinterpret_cast<ArtNode4*>(node)->children
+                             : reinterpret_cast<ArtNode16*>(node)->children;
+    size_t i = 0;
+    while (keys[i] != b) {
+      i++;
+    }
+    memmove(keys + i, keys + i + 1, node->count - i - 1);
+    memmove(children + i, children + i + 1,
+            (node->count - i - 1) * sizeof(ArtNode*));
+    break;
+  }
+  case ART_NODE48: {
+    ArtNode48* n = reinterpret_cast<ArtNode48*>(node);
+    n->children[n->index[b] - 1] = nullptr;
+    n->index[b] = 0;
+    break;
+  }
+  case ART_NODE256:
+    reinterpret_cast<ArtNode256*>(node)->children[b] = nullptr;
+    break;
+  }
+  node->count--;
+}
+
+// after an erase below the node at *ref: move it to the next size down
+// once it is sparse enough, and fold away a Node4 left with one entry
+template <typename V> void art_shrink(ArtTree<V>* tree, ArtNode** ref) {
+  ArtNode* node = *ref;
+  switch (node->type) {
+  case ART_NODE4: {
+    ArtNode4* n = reinterpret_cast<ArtNode4*>(node);
+    if (node->count + (node->end != nullptr) > 1) {
+      return;
+    }
+    if (node->count == 0) {
+      *ref = node->end; // a lone leaf, or nothing
+    } else if (node->end == nullptr) {
+      ArtNode* child = n->children[0];
+      if (!art_is_leaf(child)) {
+        // this prefix, the branching byte, then the child's prefix
+        uint8_t joined[ART_MAX_PREFIX];
+        size_t len = std::min<size_t>(node->prefix_len, ART_MAX_PREFIX);
+        memcpy(joined, node->prefix, len);
+        if (len < ART_MAX_PREFIX) {
+          joined[len++] = n->keys[0];
+        }
+        size_t take = std::min<size_t>(child->prefix_len, ART_MAX_PREFIX - len);
+        memcpy(joined + len, child->prefix, take);
+        art_set_prefix(child, joined,
+                          size_t(node->prefix_len) + 1 + child->prefix_len);
+      }
+      *ref = child;
+    } else {
+      return;
+    }
+    art_free_node(tree, node);
+    return;
+  }
+  case ART_NODE16: {
+    if (node->count > 3) {
+      return;
+    }
+    ArtNode16* n = reinterpret_cast<ArtNode16*>(node);
+    ArtNode4* shrunk =
+        reinterpret_cast<ArtNode4*>(art_new_node(tree, ART_NODE4, node));
+    memcpy(shrunk->keys, n->keys, node->count);
+    memcpy(shrunk->children, n->children, node->count * sizeof(ArtNode*));
+    shrunk->header.count = node->count;
+    *ref = &shrunk->header;
+    break;
+  }
+  case ART_NODE48: {
+    if (node->count > 12) {
+      return;
+    }
+    ArtNode48* n = reinterpret_cast<ArtNode48*>(node);
+    ArtNode16* shrunk =
+        reinterpret_cast<ArtNode16*>(art_new_node(tree, ART_NODE16, node));
+    size_t i = 0;
+    for (size_t c = 0; c < 256; ++c) {
+      if (n->index[c]) {
+        shrunk->keys[i] = uint8_t(c);
+        shrunk->children[i++] = n->children[n->index[c] - 1];
+      }
+    }
+    shrunk->header.count = uint16_t(i);
+    *ref = &shrunk->header;
+    break;
+  }
+  case ART_NODE256: {
+    if (node->count > 36) {
+      return;
+    }
+    ArtNode256* n = reinterpret_cast<ArtNode256*>(node);
+    ArtNode48* shrunk =
+        reinterpret_cast<ArtNode48*>(art_new_node(tree, ART_NODE48, node));
+    size_t i = 0;
+    for (size_t c = 0; c < 256; ++c) {
+      if (n->children[c]) {
+        shrunk->index[c] = uint8_t(i + 1);
+        shrunk->children[i++] = n->children[c];
+      }
+    }
+    shrunk->header.count = uint16_t(i);
+    *ref = &shrunk->header;
+    break;
+  }
+  }
+  art_free_node(tree, node);
+}
+
+// erase key below *ref; true if it was there
+template <typename V>
+bool art_erase_at(ArtTree<V>* tree, ArtNode** ref, const uint8_t* key,
+                  size_t len, size_t depth) {
+  ArtNode* node = *ref;
+  if (!node) {
+    return false;
+  }
+  if (art_is_leaf(node)) {
+    if (!art_leaf_matches(art_leaf<V>(node), key, len)) {
+      return false;
+    }
+    art_free_leaf(tree, node);
+    *ref = nullptr;
+    return true;
+  }
+
+  size_t plen = node->prefix_len;
+  size_t stored = std::min<size_t>(plen, ART_MAX_PREFIX);
+  if (depth + plen > len || memcmp(node->prefix, key + depth, stored) != 0) {
+    return false;
+  }
+  depth += plen;
+
+  if (depth == len) {
+    if (!node->end || !art_leaf_matches(art_leaf<V>(node->end), key, len)) {
+      return false;
+    }
+    art_free_leaf(tree, node->end);
+    node->end = nullptr;
+  } else {
+    ArtNode** child = art_find_child(node, key[depth]);
+    if (!child || !art_erase_at(tree, child, key, len, depth + 1)) {
+      return false;
+    }
+    if (*child) {
+      return true; // the child is still there, perhaps smaller
+    }
+    art_remove_child(node, key[depth]);
+  }
+  art_shrink(tree, ref);
+  return true;
+}
+
+// remove key, returning whether it was present
+template <typename V>
+bool art_erase(ArtTree<V>* tree, const uint8_t* key, size_t len) {
+  bool erased = art_erase_at(tree, &tree->root, key, len, 0);
+  tree->sz -= erased;
+  return erased;
+}
+
+// call f(child) on each child of node in byte order, stopping early if f
+// returns false; returns false if it stopped
+template <typename F> bool art_each_child(const ArtNode* node, F& f) {
+  switch (node->type) {
+  case ART_NODE4: {
+    const ArtNode4* n = reinterpret_cast<const ArtNode4*>(node);
+    for (size_t i = 0; i < node->count; ++i) {
+      if (!f(n->keys[i], n->children[i])) {
+        return false;
+      }
+    }
+    break;
+  }
+  case ART_NODE16: {
+    const ArtNode16* n = reinterpret_cast<const ArtNode16*>(node);
+    for (size_t i = 0; i < node->count; ++i) {
+      if (!f(n->keys[i], n->children[i])) {
+        return false;
+      }
+    }
+    break;
+  }
+  case ART_NODE48: {
+    const ArtNode48* n = reinterpret_cast<const ArtNode48*>(node);
+    for (size_t c = 0; c < 256; ++c) {
+      if (n->index[c] && !f(uint8_t(c), n->children[n->index[c] - 1])) {
+        return false;
+      }
+    }
+    break;
+  }
+  case ART_NODE256: {
+    const ArtNode256* n = reinterpret_cast<const ArtNode256*>(node);
+    for (size_t c = 0; c < 256; ++c) {
+      if (n->children[c] && !f(uint8_t(c), n->children[c])) {
+        return false;
+      }
+    }
+    break;
+  }
+  }
+  return true;
+}
+
+// call f(key, value) on every entry below ref with lo <= key < hi, in key
+// order. lo_open and hi_open say the path to ref already lies strictly
+// above lo or below hi, so that bound no longer needs checking; subtrees
+// whose path falls outside the range are skipped.
+template <typename V, typename F>
+void art_range_at(const ArtNode* ref, size_t depth, std::string_view lo,
+                  bool lo_open, std::string_view hi, bool hi_open, F& f) {
+  if (!ref) {
+    return;
+  }
+  if (art_is_leaf(ref)) {
+    ArtLeaf<V>* leaf = art_leaf<V>(ref);
+    std::string_view key = art_leaf_view(leaf);
+    if ((lo_open || key >= lo) && (hi_open || key < hi)) {
+      f(key, leaf->value);
+    }
+    return;
+  }
+
+  const uint8_t* prefix =
+      lo_open && hi_open ? nullptr : art_full_prefix<V>(ref, depth);
+  for (size_t i = 0; i < ref->prefix_len && !(lo_open && hi_open); ++i) {
+    size_t d = depth + i;
+    if (!lo_open) {
+      // a path that runs past lo with lo as its prefix is above it
+      if (d >= lo.size() || prefix[i] > uint8_t(lo[d])) {
+        lo_open = true;
+      } else if (prefix[i] < uint8_t(lo[d])) {
+        return;
+      }
+    }
+    if (!hi_open) {
+      if (d >= hi.size() || prefix[i] > uint8_t(hi[d])) {
+        return;
+      }
+      if (prefix[i] < uint8_t(hi[d])) {
+        hi_open = true;
+      }
+    }
+  }
+  depth += ref->prefix_len;
+
+  art_range_at<V>(ref->end, depth, lo, lo_open, hi, hi_open, f);
+  auto visit = [&](uint8_t b, const ArtNode* child) {
+    bool child_lo_open =
+        lo_open || depth >= lo.size() || b > uint8_t(lo[depth]);
+    bool child_hi_open = hi_open;
+    if (!child_lo_open && b < uint8_t(lo[depth])) {
+      return true;
+    }
+    if (!hi_open) {
+      if (depth >= hi.size() || b > uint8_t(hi[depth])) {
+        return false;
+      }
+      child_hi_open = b < uint8_t(hi[depth]);
+    }
+    art_range_at<V>(child, depth + 1, lo, child_lo_open, hi, child_hi_open,
+                    f);
+    return true;
+  };
+  art_each_child(ref, visit);
+}
+
+// call f(key, value) on every entry with lo <= key < hi, in key order;
+// key is a std::string_view of the stored bytes
+template <typename V, typename F>
+void art_range(const ArtTree<V>* tree, std::string_view lo,
+               std::string_view hi, F f) {
+  if (lo < hi) {
+    art_range_at<V>(tree->root, 0, lo, false, hi, false, f);
+  }
+}
+
+// call f(key, value) on every entry, in key order
+template <typename V, typename F>
+void art_for_each(const ArtTree<V>* tree, F f) {
+  art_range_at<V>(tree->root, 0, {}, true, {}, true, f);
+}
+
+// call f(key, value) on every entry whose key starts with prefix, in key
+// order
+template <typename V, typename F>
+void art_prefix(const ArtTree<V>* tree, std::string_view prefix, F f) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(prefix.data());
+  size_t len = prefix.size();
+  const ArtNode* ref = tree->root;
+  size_t depth = 0;
+  // walk down to the first node whose keys all carry the prefix
+  while (ref && !art_is_leaf(ref) && depth < len) {
+    size_t plen = ref->prefix_len;
+    size_t check = std::min(plen, len - depth);
+    if (memcmp(art_full_prefix<V>(ref, depth), p + depth, check) != 0) {
+      return;
+    }
+    depth += plen;
+    if (depth >= len) {
+      break;
+    }
+    ArtNode** child = art_find_child(const_cast<ArtNode*>(ref), p[depth]);
+    ref = child ? *child : nullptr;
+    depth++;
+  }
+  if (ref && art_is_leaf(ref)) {
+    std::string_view key = art_leaf_view(art_leaf<V>(ref));
+    if (key.substr(0, len) != prefix) {
+      return;
+    }
+  }
+  art_range_at<V>(ref, depth, {}, true, {}, true, f);
+}
+
+// std::string keys
+template <typename V>
+V* art_find(const ArtTree<V>* tree, std::string_view key) {
+  return art_find(tree, reinterpret_cast<const uint8_t*>(key.data()),
+                  key.size());
+}
+
+template <typename V>
+bool art_insert(ArtTree<V>* tree, std::string_view key, V value) {
+  return art_insert(tree, reinterpret_cast<const uint8_t*>(key.data()),
+                    key.size(), std::move(value));
+}
+
+template <typename V> bool art_erase(ArtTree<V>* tree, std::string_view key) {
+  return art_erase(tree, reinterpret_cast<const uint8_t*>(key.data()),
+                   key.size());
+}
+
+// unsigned integer keys, stored big-endian so that they sort numerically
+inline void art_encode(uint64_t key, uint8_t out[ART_INT_KEY_LEN]) {
+  for (int i = ART_INT_KEY_LEN - 1; i >= 0; --i) {
+    out[i] = uint8_t(key);
+    key >>= 8;
+  }
+}
+
+// integer key of the bytes handed to a range or prefix callback
+inline uint64_t art_decode(std::string_view key) {
+  uint64_t out = 0;
+  for (char c : key) {
+    out = out << 8 | uint8_t(c);
+  }
+  return out;
+}
+
+template <typename V> V* art_find(const ArtTree<V>* tree, uint64_t key) {
+  uint8_t bytes[ART_INT_KEY_LEN];
+  art_encode(key, bytes);
+  return art_find(tree, bytes, ART_INT_KEY_LEN);
+}
+
+template <typename V> bool art_insert(ArtTree<V>* tree, uint64_t key, V value) {
+  uint8_t bytes[ART_INT_KEY_LEN];
+  art_encode(key, bytes);
+  return art_insert(tree, bytes, ART_INT_KEY_LEN, std::move(value));
+}
+
+template <typename V> bool art_erase(ArtTree<V>* tree, uint64_t key) {
+  uint8_t bytes[ART_INT_KEY_LEN];
+  art_encode(key, bytes);
+  return art_erase(tree, bytes, ART_INT_KEY_LEN);
+}
+
+// call f(key, value) on every integer key with lo <= key < hi
+template <typename V, typename F>
+void art_range(const ArtTree<V>* tree, uint64_t lo, uint64_t hi, F f) {
+  uint8_t lo_bytes[ART_INT_KEY_LEN];
+  uint8_t hi_bytes[ART_INT_KEY_LEN];
+  art_encode(lo, lo_bytes);
+  art_encode(hi, hi_bytes);
+  art_range(tree,
+            std::string_view(reinterpret_cast<char*>(lo_bytes),
+                             ART_INT_KEY_LEN),
+            std::string_view(reinterpret_cast<char*>(hi_bytes),
+                             ART_INT_KEY_LEN),
+            f);
+}
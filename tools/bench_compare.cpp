@@ -0,0 +1,224 @@
+/**
+ * bench_compare.cpp
+ *
+ * Compare benchmark results (csv written by test::Benchmark) against a
+ * stored baseline and flag statistically significant regressions.
+ *
+ * Usage: bench_compare <baseline.csv> <current.csv> [threshold] [alpha]
+ *
+ * A case regresses when its median time per call grew by more than
+ * `threshold` (default 0.05) and a one-sided Mann-Whitney U test over the
+ * raw samples rejects "not slower" at significance `alpha` (default 0.01).
+ * Exits with 1 if any case regressed, 2 on usage or input errors.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct Row {
+  double median_ns;
+  std::vector<double> samples;
+};
+
+// split one csv line into fields, honoring double-quoted fields
+std::vector<std::string> csv_split(std::string line) {
+  if (!line.empty() && line.back() == '\r') {
+    line.pop_back();
+  }
+  std::vector<std::string> fields(1);
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    char c = line[i];
+    if (quoted) {
+      if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') {
+        fields.back() += '"';
+        ++i;
+      } else if (c == '"') {
+        quoted = false;
+      } else {
+        fields.back() += c;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.emplace_back();
+    } else {
+      fields.back() += c;
+    }
+  }
+  return fields;
+}
+
+// parse ';'-separated sample list
+std::vector<double> parse_samples(const std::string& field) {
+  std::vector<double> samples;
+  std::stringstream ss(field);
+  std::string item;
+  while (std::getline(ss, item, ';')) {
+    if (!item.empty()) {
+      samples.push_back(std::stod(item));
+    }
+  }
+  return samples;
+}
+
+// load results keyed by "suite/name"
+std::map<std::string, Row> load_results(const std::string& path) {
+  std::ifstream in(path);
+  if (!in) {
+    throw std::runtime_error("Cannot open " + path);
+  }
+
+  std::string line;
+  if (!std::getline(in, line)) {
+    throw std::runtime_error("Empty results file " + path);
+  }
+  std::vector<std::string> header = csv_split(line);
+  auto column = [&](const std::string& name) {
+    auto it = std::find(header.begin(), header.end(), name);
+    if (it == header.end()) {
+      throw std::runtime_error("Missing column '" + name + "' in " + path);
+    }
+    return static_cast<size_t>(it - header.begin());
+  };
+  size_t suite_col = column("suite");
+  size_t name_col = column("name");
+  size_t median_col = column("median_ns");
+  size_t samples_col = column("samples_ns");
+
+  std::map<std::string, Row> rows;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields = csv_split(line);
+    if (fields.size() != header.size()) {
+      throw std::runtime_error("Malformed row in " + path + ": " + line);
+    }
+    Row row;
+    row.median_ns = std::stod(fields[median_col]);
+    row.samples = parse_samples(fields[samples_col]);
+    rows[fields[suite_col] + "/" + fields[name_col]] = std::move(row);
+  }
+  return rows;
+}
+
+// one-sided Mann-Whitney U test: p-value for "current is slower than
+// baseline", using the normal approximation with tie correction
+double mann_whitney_p(const std::vector<double>& baseline,
+                      const std::vector<double>& current) {
+  size_t n1 = baseline.size();
+  size_t n2 = current.size();
+  if (n1 == 0 || n2 == 0) {
+    return 1.0;
+  }
+
+  // rank the pooled samples, averaging ranks over ties
+  std::vector<std::pair<double, int>> pooled;
+  for (double v : baseline) {
+    pooled.emplace_back(v, 0);
+  }
+  for (double v : current) {
+    pooled.emplace_back(v, 1);
+  }
+  std::sort(pooled.begin(), pooled.end());
+
+  double rank_sum_current = 0;
+  double tie_term = 0;
+  for (size_t i = 0; i < pooled.size();) {
+    size_t j = i;
+    while (j < pooled.size() && pooled[j].first == pooled[i].first) {
+      ++j;
+    }
+    double avg_rank = (i + 1 + j) / 2.0;
+    for (size_t k = i; k < j; ++k) {
+      if (pooled[k].second == 1) {
+        rank_sum_current += avg_rank;
+      }
+    }
+    double t = static_cast<double>(j - i);
+    tie_term += t * t * t - t;
+    i = j;
+  }
+
+  double n = static_cast<double>(n1 + n2);
+  double u = rank_sum_current - n2 * (n2 + 1) / 2.0;
+  double mean = n1 * n2 / 2.0;
+  double var = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1)));
+  if (var <= 0) {
+    return 1.0;
+  }
+  double z = (u - mean - 0.5) / std::sqrt(var); // continuity correction
+  return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+int main(int argc, char** argv) {
+  if (argc < 3 || argc > 5) {
+    std::cerr << "Usage: " << argv[0]
+              << " <baseline.csv> <current.csv> [threshold] [alpha]"
+              << std::endl;
+    return 2;
+  }
+  double threshold = argc > 3 ? std::atof(argv[3]) : 0.05;
+  double alpha = argc > 4 ? std::atof(argv[4]) : 0.01;
+
+  std::map<std::string, Row> baseline;
+  std::map<std::string, Row> current;
+  try {
+    baseline = load_results(argv[1]);
+    current = load_results(argv[2]);
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 2;
+  }
+
+  size_t regressions = 0;
+  std::cout << std::left << std::setw(60) << "case" << std::right
+            << std::setw(10) << "change" << std::setw(10) << "p" << "  status"
+            << std::endl;
+  for (const auto& [key, cur] : current) {
+    auto it = baseline.find(key);
+    if (it == baseline.end()) {
+      std::cout << std::left << std::setw(60) << key << std::right
+                << std::setw(22) << "" << "  new" << std::endl;
+      continue;
+    }
+    const Row& base = it->second;
+    double change = base.median_ns > 0 ? cur.median_ns / base.median_ns - 1 : 0;
+    double p_slower = mann_whitney_p(base.samples, cur.samples);
+    double p_faster = mann_whitney_p(cur.samples, base.samples);
+
+    std::string status = "ok";
+    if (change > threshold && p_slower < alpha) {
+      status = "REGRESSION";
+      ++regressions;
+    } else if (change < -threshold && p_faster < alpha) {
+      status = "improved";
+    }
+    double p = change > 0 ? p_slower : p_faster;
+
+    std::cout << std::left << std::setw(60) << key << std::right << std::fixed
+              << std::setprecision(1) << std::setw(9) << change * 100 << "%"
+              << std::setprecision(4) << std::setw(10) << p << "  " << status
+              << std::defaultfloat << std::endl;
+  }
+  for (const auto& entry : baseline) {
+    const std::string& key = entry.first;
+    if (!current.count(key)) {
+      std::cout << std::left << std::setw(60) << key << std::right
+                << std::setw(22) << "" << "  missing" << std::endl;
+    }
+  }
+
+  std::cout << "\n" << regressions << " regression(s)" << std::endl;
+  return regressions ? 1 : 0;
+}